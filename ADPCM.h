@@ -0,0 +1,53 @@
+#ifndef ADPCM_H
+#define ADPCM_H
+
+#include <cstdint>
+
+/*
+ * Tables and helpers shared by the IMA ADPCM family (Apple IMA4 and
+ * WAV-style IMA ADPCM) and MS ADPCM decoders.
+ */
+namespace ADPCM {
+    const int8_t ima_index_table[16] = {
+        -1, -1, -1, -1, 2, 4, 6, 8,
+        -1, -1, -1, -1, 2, 4, 6, 8,
+    };
+    const int16_t ima_step_table[89] = {
+            7,     8,     9,    10,    11,    12,    13,    14,    16,    17,
+           19,    21,    23,    25,    28,    31,    34,    37,    41,    45,
+           50,    55,    60,    66,    73,    80,    88,    97,   107,   118,
+          130,   143,   157,   173,   190,   209,   230,   253,   279,   307,
+          337,   371,   408,   449,   494,   544,   598,   658,   724,   796,
+          876,   963,  1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,
+         2272,  2499,  2749,  3024,  3327,  3660,  4026,  4428,  4871,  5358,
+         5894,  6484,  7132,  7845,  8630,  9493, 10442, 11487, 12635, 13899,
+        15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+    };
+    const int16_t ms_adaptation_table[16] = {
+        230, 230, 230, 230, 307, 409, 512, 614,
+        768, 614, 512, 409, 307, 230, 230, 230
+    };
+    /* standard coefficient set, CAF has no room to carry custom ones */
+    const int16_t ms_coef1[7] = { 256, 512, 0, 192, 240, 460, 392 };
+    const int16_t ms_coef2[7] = { 0, -256, 0, 64, 0, -208, -232 };
+
+    inline int32_t clamp(int32_t x, int32_t low, int32_t high)
+    {
+        return x < low ? low : x > high ? high : x;
+    }
+    inline int32_t ima_expand_nibble(int32_t *predictor, int32_t *step_index,
+                                     unsigned nibble)
+    {
+        int step = ima_step_table[*step_index];
+        int diff = step >> 3;
+        if (nibble & 1) diff += step >> 2;
+        if (nibble & 2) diff += step >> 1;
+        if (nibble & 4) diff += step;
+        if (nibble & 8) diff = -diff;
+        *predictor  = clamp(*predictor + diff, -32768, 32767);
+        *step_index = clamp(*step_index + ima_index_table[nibble], 0, 88);
+        return *predictor;
+    }
+}
+
+#endif
@@ -0,0 +1,542 @@
+#include <algorithm>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#include "ALACDecoder.h"
+
+/*
+ * Apple Lossless decoder.
+ * Bitstream layout and adaptive Golomb / predictor semantics follow
+ * Apple's reference implementation (ALACDecoder.cpp, ag_dec.c, dp_dec.c)
+ * so that the output is bit exact.
+ */
+namespace {
+    enum {
+        ID_SCE = 0, ID_CPE = 1, ID_CCE = 2, ID_LFE = 3,
+        ID_DSE = 4, ID_PCE = 5, ID_FIL = 6, ID_END = 7
+    };
+    enum {
+        QBSHIFT           = 9,
+        QB                = 1 << QBSHIFT,
+        MMULSHIFT         = 2,
+        MDENSHIFT         = QBSHIFT - MMULSHIFT - 1,
+        MOFF              = 1 << (MDENSHIFT - 2),
+        BITOFF            = 24,
+        MAX_PREFIX_16     = 9,
+        MAX_PREFIX_32     = 9,
+        MAX_DATATYPE_BITS_16 = 16,
+        N_MAX_MEAN_CLAMP  = 0xffff,
+        N_MEAN_CLAMP_VAL  = 0xffff
+    };
+
+    inline unsigned lead(uint32_t x)
+    {
+        if (!x) return 32;
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanReverse(&index, x);
+        return 31 - index;
+#else
+        return __builtin_clz(x);
+#endif
+    }
+    inline int32_t sign_of(int32_t i)
+    {
+        return (i > 0) - (i < 0);
+    }
+    inline uint32_t read32be(const uint8_t *p)
+    {
+        return (p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+    }
+
+    /*
+     * BitReader reads are only safe up to the padding past the end, so
+     * fields are checked against what is left before they are read
+     */
+    void require_bits(const BitReader &bits, uint64_t nbits)
+    {
+        if (bits.remaining() < nbits)
+            throw std::runtime_error("ALAC: truncated frame");
+    }
+
+    /* numbits: 1 to 32 */
+    uint32_t get_stream_bits(const uint8_t *in, uint32_t bitpos,
+                             unsigned numbits)
+    {
+        const uint8_t *p = in + (bitpos >> 3);
+        uint64_t v = static_cast<uint64_t>(read32be(p)) << 8 | p[4];
+        return static_cast<uint32_t>((v << (bitpos & 7) << 24) >> 32
+                                     >> (32 - numbits));
+    }
+    uint32_t dyn_get(const uint8_t *in, uint32_t *bitpos, uint32_t m,
+                     uint32_t k)
+    {
+        uint32_t tempbits = *bitpos;
+        uint32_t result;
+        uint32_t streamlong = read32be(in + (tempbits >> 3));
+        streamlong <<= tempbits & 7;
+
+        uint32_t pre = lead(~streamlong);
+        if (pre >= MAX_PREFIX_16) {
+            pre = MAX_PREFIX_16;
+            tempbits += pre;
+            streamlong <<= pre;
+            result = streamlong >> (32 - MAX_DATATYPE_BITS_16);
+            tempbits += MAX_DATATYPE_BITS_16;
+        } else {
+            tempbits += pre + 1;
+            streamlong <<= pre + 1;
+            uint32_t v = k ? streamlong >> (32 - k) : 0;
+            tempbits += k;
+            result = pre * m + v - 1;
+            if (v < 2) {
+                result -= v - 1;
+                tempbits -= 1;
+            }
+        }
+        *bitpos = tempbits;
+        return result;
+    }
+    uint32_t dyn_get_32bit(const uint8_t *in, uint32_t *bitpos, uint32_t m,
+                           uint32_t k, unsigned maxbits)
+    {
+        uint32_t tempbits = *bitpos;
+        uint32_t streamlong = read32be(in + (tempbits >> 3));
+        streamlong <<= tempbits & 7;
+
+        uint32_t result = lead(~streamlong);
+        if (result >= MAX_PREFIX_32) {
+            result = get_stream_bits(in, tempbits + MAX_PREFIX_32, maxbits);
+            tempbits += MAX_PREFIX_32 + maxbits;
+        } else {
+            tempbits += result + 1;
+            if (k != 1) {
+                streamlong <<= result + 1;
+                uint32_t v = streamlong >> (32 - k);
+                tempbits += k - 1;
+                result = result * m;
+                if (v >= 2) {
+                    result += v - 1;
+                    tempbits += 1;
+                }
+            }
+        }
+        *bitpos = tempbits;
+        return result;
+    }
+
+    /*
+     * Adaptive predictor restore.
+     * Coefficients are kept in reverse order (rc[m] == coefs[n-1-m]) so
+     * that the dot product walks the history window forward and can be
+     * vectorized by the compiler.
+     */
+    void unpc_block(const int32_t *pc1, int32_t *out, uint32_t num,
+                    int16_t *rc, unsigned numactive, unsigned chanbits,
+                    unsigned denshift)
+    {
+        unsigned chanshift = 32 - chanbits;
+        int32_t  denhalf   = denshift ? 1 << (denshift - 1) : 0;
+        auto wrap = [chanshift](int32_t v) -> int32_t {
+            return static_cast<int32_t>(static_cast<uint32_t>(v) << chanshift)
+                    >> chanshift;
+        };
+        out[0] = pc1[0];
+        if (numactive == 0) {
+            if (num > 1 && pc1 != out)
+                std::memcpy(&out[1], &pc1[1], (num - 1) * sizeof(int32_t));
+            return;
+        }
+        if (numactive == 31) {
+            int32_t prev = out[0];
+            for (uint32_t j = 1; j < num; ++j)
+                out[j] = prev = wrap(pc1[j] + prev);
+            return;
+        }
+        uint32_t lim = std::min(numactive + 1, num);
+        for (uint32_t j = 1; j < lim; ++j)
+            out[j] = wrap(pc1[j] + out[j - 1]);
+
+        int n = numactive;
+        for (uint32_t j = numactive + 1; j < num; ++j) {
+            const int32_t *w = out + j - n;
+            int32_t top = w[-1];
+            int32_t sum = 0;
+            for (int m = 0; m < n; ++m)
+                sum += rc[m] * (w[m] - top);
+
+            int32_t del  = pc1[j];
+            int32_t del0 = del;
+            int32_t sg   = sign_of(del);
+            del += top + ((sum + denhalf) >> denshift);
+            out[j] = wrap(del);
+
+            if (sg > 0) {
+                for (int m = 0; m < n; ++m) {
+                    int32_t dd  = top - w[m];
+                    int32_t sgn = sign_of(dd);
+                    rc[m] -= sgn;
+                    del0  -= (m + 1) * ((sgn * dd) >> denshift);
+                    if (del0 <= 0)
+                        break;
+                }
+            } else if (sg < 0) {
+                for (int m = 0; m < n; ++m) {
+                    int32_t dd  = top - w[m];
+                    int32_t sgn = sign_of(dd);
+                    rc[m] += sgn;
+                    del0  -= (m + 1) * ((-sgn * dd) >> denshift);
+                    if (del0 >= 0)
+                        break;
+                }
+            }
+        }
+    }
+
+    /* channel labels of ALAC's default layouts, see CAFFile.cpp */
+    const char *default_layout(unsigned nchannels)
+    {
+        const char *tab[] = {
+            0, 0, 0,
+            "\x03\x01\x02",
+            "\x03\x01\x02\x09",
+            "\x03\x01\x02\x0A\x0B",
+            "\x03\x01\x02\x0A\x0B\x04",
+            "\x03\x01\x02\x0A\x0B\x09\x04",
+            "\x03\x07\x08\x01\x02\x0A\x0B\x04",
+        };
+        return nchannels < 9 ? tab[nchannels] : 0;
+    }
+}
+
+ALACDecoder::ALACDecoder(const CAFFile::Format &format,
+                         const std::vector<uint8_t> &cookie)
+    : m_format(format)
+{
+    /* cookie is ALACSpecificConfig prefixed by 4 bytes of version/flags */
+    if (cookie.size() < 28)
+        throw std::runtime_error("invalid ALAC magic cookie");
+    const uint8_t *p = cookie.data() + 4;
+    m_config.frame_length = read32be(p);
+    m_config.bit_depth    = p[5];
+    m_config.pb           = p[6];
+    m_config.mb           = p[7];
+    m_config.kb           = p[8];
+    m_config.num_channels = p[9];
+    m_config.max_run      = (p[10] << 8) | p[11];
+    m_config.sample_rate  = read32be(p + 20);
+
+    switch (m_config.bit_depth) {
+    case 16: case 20: case 24: case 32: break;
+    default: throw std::runtime_error("unsupported ALAC bit depth");
+    }
+    if (!m_config.frame_length || m_config.frame_length > 1 << 20
+     || m_config.num_channels != format.asbd.mChannelsPerFrame)
+        throw std::runtime_error("invalid ALAC magic cookie");
+
+    unsigned nchannels = m_config.num_channels;
+    const char *layout = default_layout(nchannels);
+    if (!format.channel_mask && layout) {
+        std::vector<unsigned> order(nchannels);
+        m_channel_mask = 0;
+        m_channel_pos.resize(nchannels);
+        for (unsigned i = 0; i < nchannels; ++i) {
+            m_channel_mask |= 1 << (layout[i] - 1);
+            order[i] = i;
+        }
+        std::sort(order.begin(), order.end(),
+                  [layout](unsigned a, unsigned b) -> bool {
+                      return layout[a] < layout[b];
+                  });
+        for (unsigned i = 0; i < nchannels; ++i)
+            m_channel_pos[order[i]] = i;
+    } else {
+        m_channel_mask = channel_config(format);
+        m_channel_pos  = channel_positions(format);
+    }
+    m_predictor.resize(m_config.frame_length);
+    m_mix_u.resize(m_config.frame_length);
+    m_mix_v.resize(m_config.frame_length);
+    m_shift_buffer.resize(m_config.frame_length * 2);
+}
+
+void ALACDecoder::get_info(file_info &info)
+{
+    info.info_set("codec",    "ALAC");
+    info.info_set("encoding", "lossless");
+    info.info_set_int("samplerate",    m_format.asbd.mSampleRate);
+    info.info_set_int("bitspersample", m_config.bit_depth);
+    uint32_t channel_mask = m_format.channel_mask;
+    std::string channels;
+    if (channel_mask) {
+        channels = Helpers::describe_channels(channel_mask);
+        info.info_set("channels", channels.c_str());
+    } else {
+        info.info_set_int("channels", m_format.asbd.mChannelsPerFrame);
+    }
+}
+
+void ALACDecoder::decode(const void *buffer, t_size bytes, audio_chunk &chunk,
+                         abort_callback &abort)
+{
+    unsigned nchannels = m_config.num_channels;
+
+    /* copy to get the padding BitReader wants */
+    reserve(bytes);
+    std::memcpy(m_packet.data(), buffer, bytes);
+    std::memset(m_packet.data() + bytes, 0, BitReader::PADDING);
+    BitReader bits(m_packet.data(), bytes);
+
+    chunk.set_data_size(m_config.frame_length * nchannels);
+    uint32_t nframes = decode_frame(bits, chunk.get_data());
+    chunk.set_srate(m_format.asbd.mSampleRate);
+    chunk.set_channels(nchannels, m_channel_mask);
+    chunk.set_sample_count(nframes);
+}
+
+uint32_t ALACDecoder::decode_frame(BitReader &bits, audio_sample *dp)
+{
+    unsigned nchannels = m_config.num_channels;
+    uint32_t nsamples  = m_config.frame_length;
+    unsigned channel   = 0;
+
+    while (channel < nchannels) {
+        if (bits.remaining() < 3)
+            throw std::runtime_error("ALAC: truncated frame");
+        unsigned tag = bits.read(3);
+        switch (tag) {
+        case ID_SCE:
+        case ID_LFE:
+        case ID_CPE:
+            {
+                unsigned nchan = tag == ID_CPE ? 2 : 1;
+                if (channel + nchan > nchannels)
+                    throw std::runtime_error("ALAC: too many channels");
+                require_bits(bits, 4 + 12 + 4);
+                bits.skip(4); /* element instance tag */
+                if (bits.read(12))
+                    throw std::runtime_error("ALAC: invalid element header");
+                unsigned header        = bits.read(4);
+                bool     partial_frame = header >> 3;
+                unsigned bytes_shifted = (header >> 1) & 3;
+                bool     escape        = header & 1;
+                if (bytes_shifted == 3)
+                    throw std::runtime_error("ALAC: invalid shift");
+                if (partial_frame) {
+                    require_bits(bits, 32);
+                    nsamples = bits.read(32);
+                    if (nsamples > m_config.frame_length)
+                        throw std::runtime_error("ALAC: invalid frame size");
+                }
+                int mix_bits = 0, mix_res = 0;
+                if (!escape) {
+                    unsigned chan_bits = m_config.bit_depth
+                                       - bytes_shifted * 8 + nchan - 1;
+                    if (chan_bits > 32)
+                        throw std::runtime_error("ALAC: invalid bit depth");
+                    Element elt[2];
+                    require_bits(bits, 8 + 8);
+                    mix_bits = bits.read(8);
+                    mix_res  = static_cast<int8_t>(bits.read(8));
+                    for (unsigned i = 0; i < nchan; ++i)
+                        read_element_header(bits, &elt[i]);
+                    BitReader shift_bits = bits;
+                    bits.skip(bytes_shifted * 8 * nchan * nsamples);
+                    decompress(bits, elt[0], nsamples, chan_bits,
+                               m_mix_u.data());
+                    if (nchan == 2)
+                        decompress(bits, elt[1], nsamples, chan_bits,
+                                   m_mix_v.data());
+                    if (bytes_shifted) {
+                        unsigned shift = bytes_shifted * 8;
+                        uint16_t *sp = m_shift_buffer.data();
+                        for (uint32_t i = 0; i < nsamples * nchan; ++i)
+                            sp[i] = shift_bits.read(shift);
+                    }
+                } else {
+                    unsigned chan_bits = m_config.bit_depth;
+                    require_bits(bits, static_cast<uint64_t>(nsamples)
+                                       * nchan * chan_bits);
+                    for (uint32_t i = 0; i < nsamples; ++i) {
+                        m_mix_u[i] = bits.read_signed(chan_bits);
+                        if (nchan == 2)
+                            m_mix_v[i] = bits.read_signed(chan_bits);
+                    }
+                    bytes_shifted = 0;
+                }
+                if (bits.overrun())
+                    throw std::runtime_error("ALAC: truncated frame");
+                if (nchan == 1)
+                    write_mono(m_mix_u.data(), nsamples, bytes_shifted,
+                               channel, dp);
+                else
+                    write_stereo(m_mix_u.data(), m_mix_v.data(), nsamples,
+                                 mix_bits, mix_res, bytes_shifted,
+                                 channel, dp);
+                channel += nchan;
+                break;
+            }
+        case ID_DSE:
+            {
+                bits.skip(4); /* element instance tag */
+                bool align = bits.read(1);
+                unsigned count = bits.read(8);
+                if (count == 255)
+                    count += bits.read(8);
+                if (align)
+                    bits.byte_align();
+                bits.skip(count * 8);
+                break;
+            }
+        case ID_FIL:
+            {
+                unsigned count = bits.read(4);
+                if (count == 15)
+                    count += bits.read(8) - 1;
+                bits.skip(count * 8);
+                break;
+            }
+        case ID_END:
+            if (channel < nchannels)
+                throw std::runtime_error("ALAC: missing channels");
+            break;
+        default:
+            throw std::runtime_error("ALAC: unsupported element");
+        }
+        if (bits.overrun())
+            throw std::runtime_error("ALAC: truncated frame");
+    }
+    return nsamples;
+}
+
+void ALACDecoder::read_element_header(BitReader &bits, Element *elt)
+{
+    require_bits(bits, 8 + 8);
+    unsigned header = bits.read(8);
+    elt->mode       = header >> 4;
+    elt->den_shift  = header & 0xf;
+    header          = bits.read(8);
+    elt->pb_factor  = header >> 5;
+    elt->num_coefs  = header & 0x1f;
+    require_bits(bits, elt->num_coefs * 16);
+    /* stored reversed, see unpc_block() */
+    for (unsigned i = 0; i < elt->num_coefs; ++i)
+        elt->coefs[elt->num_coefs - 1 - i] = bits.read(16);
+}
+
+void ALACDecoder::decompress(BitReader &bits, const Element &elt,
+                             uint32_t nsamples, unsigned chan_bits,
+                             int32_t *out)
+{
+    const uint8_t *in  = bits.data();
+    uint32_t bitpos    = bits.position();
+    uint32_t maxpos    = bits.size();
+    uint32_t pb        = m_config.pb * elt.pb_factor / 4;
+    uint32_t kb        = m_config.kb;
+    uint32_t wb        = (1u << kb) - 1;
+    uint32_t mb        = m_config.mb;
+    uint32_t zmode     = 0;
+    int32_t *pc        = m_predictor.data();
+
+    for (uint32_t c = 0; c < nsamples; ) {
+        if (bitpos >= maxpos)
+            throw std::runtime_error("ALAC: truncated frame");
+        uint32_t m = mb >> QBSHIFT;
+        uint32_t k = std::min(31 - lead(m + 3), kb);
+        m = (1u << k) - 1;
+
+        uint32_t n = dyn_get_32bit(in, &bitpos, m, k, chan_bits);
+        /*
+         * a code may run up to 41 bits into the padding; the next one
+         * must not start there, or it would read beyond it
+         */
+        if (bitpos > maxpos)
+            throw std::runtime_error("ALAC: truncated frame");
+        /* least significant bit is the sign */
+        uint32_t ndecode = n + zmode;
+        int32_t  multiplier = -static_cast<int32_t>(ndecode & 1) | 1;
+        pc[c++] = ((ndecode + 1) >> 1) * multiplier;
+
+        mb = pb * (n + zmode) + mb - ((pb * mb) >> QBSHIFT);
+        if (n > N_MAX_MEAN_CLAMP)
+            mb = N_MEAN_CLAMP_VAL;
+        zmode = 0;
+
+        if ((mb << MMULSHIFT) < QB && c < nsamples) {
+            zmode = 1;
+            k = lead(mb) - BITOFF + ((mb + MOFF) >> MDENSHIFT);
+            uint32_t mz = ((1u << k) - 1) & wb;
+            n = dyn_get(in, &bitpos, mz, k);
+            if (bitpos > maxpos)
+                throw std::runtime_error("ALAC: truncated frame");
+            if (c + n > nsamples)
+                throw std::runtime_error("ALAC: invalid run length");
+            std::fill(pc + c, pc + c + n, 0);
+            c += n;
+            if (n >= 65535)
+                zmode = 0;
+            mb = 0;
+        }
+    }
+    bits.set_position(bitpos);
+
+    int16_t coefs[32];
+    std::copy(elt.coefs, elt.coefs + elt.num_coefs, coefs);
+    if (elt.mode != 0)
+        unpc_block(pc, pc, nsamples, 0, 31, chan_bits, 0);
+    unpc_block(pc, out, nsamples, coefs, elt.num_coefs, chan_bits,
+               elt.den_shift);
+}
+
+void ALACDecoder::write_mono(const int32_t *mix, uint32_t nsamples,
+                             unsigned bytes_shifted, unsigned channel,
+                             audio_sample *dp)
+{
+    const audio_sample scale = 1.0 / (1u << (m_config.bit_depth - 1));
+    unsigned nchannels = m_config.num_channels;
+    unsigned shift     = bytes_shifted * 8;
+    const uint16_t *sp = m_shift_buffer.data();
+
+    dp += m_channel_pos[channel];
+    if (shift) {
+        for (uint32_t i = 0; i < nsamples; ++i) {
+            int32_t v = static_cast<uint32_t>(mix[i]) << shift | sp[i];
+            dp[i * nchannels] = v * scale;
+        }
+    } else {
+        for (uint32_t i = 0; i < nsamples; ++i)
+            dp[i * nchannels] = mix[i] * scale;
+    }
+}
+
+void ALACDecoder::write_stereo(int32_t *mix_u, int32_t *mix_v,
+                               uint32_t nsamples, int mix_bits, int mix_res,
+                               unsigned bytes_shifted, unsigned channel,
+                               audio_sample *dp)
+{
+    const audio_sample scale = 1.0 / (1u << (m_config.bit_depth - 1));
+    unsigned nchannels = m_config.num_channels;
+    unsigned shift     = bytes_shifted * 8;
+    const uint16_t *sp = m_shift_buffer.data();
+
+    /* mid/side to left/right, in place so that the loop vectorizes */
+    if (mix_res) {
+        for (uint32_t i = 0; i < nsamples; ++i) {
+            int32_t l = mix_u[i] + mix_v[i] - ((mix_res * mix_v[i]) >> mix_bits);
+            mix_v[i] = l - mix_v[i];
+            mix_u[i] = l;
+        }
+    }
+    if (shift) {
+        for (uint32_t i = 0; i < nsamples; ++i) {
+            mix_u[i] = static_cast<uint32_t>(mix_u[i]) << shift | sp[i * 2];
+            mix_v[i] = static_cast<uint32_t>(mix_v[i]) << shift | sp[i * 2 + 1];
+        }
+    }
+    audio_sample *lp = dp + m_channel_pos[channel];
+    audio_sample *rp = dp + m_channel_pos[channel + 1];
+    for (uint32_t i = 0; i < nsamples; ++i) {
+        lp[i * nchannels] = mix_u[i] * scale;
+        rp[i * nchannels] = mix_v[i] * scale;
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef ALACDECODER_H
+#define ALACDECODER_H
+
+#include "Decoder.h"
+#include "BitReader.h"
+
+class ALACDecoder: public DecoderBase {
+    struct Config {
+        uint32_t frame_length;
+        uint8_t  bit_depth;
+        uint8_t  pb, mb, kb;
+        uint8_t  num_channels;
+        uint16_t max_run;
+        uint32_t sample_rate;
+    };
+    struct Element {
+        unsigned mode;
+        unsigned den_shift;
+        unsigned pb_factor;
+        unsigned num_coefs;
+        int16_t  coefs[32];
+    };
+    CAFFile::Format       m_format;
+    Config                m_config;
+    uint32_t              m_channel_mask;
+    std::vector<unsigned> m_channel_pos;
+    std::vector<uint8_t>  m_packet;
+    std::vector<int32_t>  m_predictor;
+    std::vector<int32_t>  m_mix_u;
+    std::vector<int32_t>  m_mix_v;
+    std::vector<uint16_t> m_shift_buffer;
+public:
+    ALACDecoder(const CAFFile::Format &format,
+                const std::vector<uint8_t> &cookie);
+    void get_info(file_info &info);
+    void decode(const void *buffer, t_size bytes, audio_chunk &chunk,
+                abort_callback &abort);
+    void reserve(size_t bytes)
+    {
+        if (m_packet.size() < bytes + BitReader::PADDING)
+            m_packet.resize(bytes + BitReader::PADDING);
+    }
+private:
+    uint32_t decode_frame(BitReader &bits, audio_sample *dp);
+    void read_element_header(BitReader &bits, Element *elt);
+    void decompress(BitReader &bits, const Element &elt, uint32_t nsamples,
+                    unsigned chan_bits, int32_t *out);
+    void write_mono(const int32_t *mix, uint32_t nsamples,
+                    unsigned bytes_shifted, unsigned channel,
+                    audio_sample *dp);
+    void write_stereo(int32_t *mix_u, int32_t *mix_v, uint32_t nsamples,
+                      int mix_bits, int mix_res, unsigned bytes_shifted,
+                      unsigned channel, audio_sample *dp);
+};
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef BITREADER_H
+#define BITREADER_H
+
+#include <cstdint>
+#include <cstddef>
+
+/*
+ * MSB-first bit reader.
+ * The underlying buffer must be followed by at least 8 bytes of readable
+ * padding, so that peeks never need a bounds check.
+ */
+class BitReader {
+    const uint8_t *m_data;
+    size_t         m_size; /* in bits */
+    size_t         m_pos;  /* in bits */
+public:
+    enum { PADDING = 8 };
+
+    BitReader(const uint8_t *data, size_t bytes)
+        : m_data(data), m_size(bytes * 8), m_pos(0)
+    {}
+    const uint8_t *data() const { return m_data; }
+    size_t position() const { return m_pos; }
+    size_t size() const { return m_size; }
+    bool overrun() const { return m_pos > m_size; }
+    size_t remaining() const { return m_pos < m_size ? m_size - m_pos : 0; }
+
+    void set_position(size_t pos) { m_pos = pos; }
+    void skip(size_t nbits) { m_pos += nbits; }
+    void byte_align() { m_pos = (m_pos + 7) & ~static_cast<size_t>(7); }
+
+    /* next 32 bits, left aligned */
+    uint32_t peek32() const
+    {
+        const uint8_t *p = m_data + (m_pos >> 3);
+        uint64_t v = static_cast<uint64_t>(p[0]) << 56
+                   | static_cast<uint64_t>(p[1]) << 48
+                   | static_cast<uint64_t>(p[2]) << 40
+                   | static_cast<uint64_t>(p[3]) << 32
+                   | static_cast<uint64_t>(p[4]) << 24;
+        return static_cast<uint32_t>((v << (m_pos & 7)) >> 32);
+    }
+    /* nbits: 0 to 32 */
+    uint32_t read(unsigned nbits)
+    {
+        if (!nbits)
+            return 0;
+        uint32_t v = peek32() >> (32 - nbits);
+        m_pos += nbits;
+        return v;
+    }
+    int32_t read_signed(unsigned nbits)
+    {
+        if (!nbits)
+            return 0;
+        int32_t v = static_cast<int32_t>(peek32()) >> (32 - nbits);
+        m_pos += nbits;
+        return v;
+    }
+};
+
+#endif
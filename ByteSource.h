@@ -0,0 +1,337 @@
+#ifndef BYTESOURCE_H
+#define BYTESOURCE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "Portable.h"
+#ifdef CAF_PORTABLE
+#include <unistd.h>
+#endif
+
+/*
+ * Random access byte stream the demuxer reads from (and writes tags to).
+ */
+class IByteSource {
+public:
+    virtual ~IByteSource() {}
+    /* may return less than requested only at the end of the stream */
+    virtual t_size read_some(void *buffer, t_size bytes,
+                             abort_callback &abort) = 0;
+    virtual void write(const void *buffer, t_size bytes,
+                       abort_callback &abort) = 0;
+    virtual void seek(t_filesize position, abort_callback &abort) = 0;
+    virtual t_filesize get_position(abort_callback &abort) = 0;
+    virtual t_filesize get_size(abort_callback &abort) = 0;
+    /*
+     * copies bytes from the current position of src to the current
+     * position of this, advancing both
+     */
+    virtual void copy_from(IByteSource &src, t_filesize bytes,
+                           abort_callback &abort)
+    {
+        std::vector<uint8_t> buffer(std::min<t_filesize>(bytes, 1 << 20));
+        while (bytes > 0) {
+            t_size n = std::min<t_filesize>(bytes, buffer.size());
+            src.read(buffer.data(), n, abort);
+            write(buffer.data(), n, abort);
+            bytes -= n;
+        }
+    }
+
+    /*
+     * pushes written data down to the storage, where that can be done;
+     * a no-op otherwise
+     */
+    virtual void sync() {}
+
+    void read(void *buffer, t_size bytes, abort_callback &abort)
+    {
+        if (read_some(buffer, bytes, abort) != bytes)
+            throw std::runtime_error("unexpected end of file");
+    }
+    void skip(t_filesize bytes, abort_callback &abort)
+    {
+        seek(get_position(abort) + bytes, abort);
+    }
+    template <typename T>
+    void read_bendian_t(T &value, abort_callback &abort)
+    {
+        uint8_t b[sizeof(T)];
+        read(b, sizeof b, abort);
+        uint64_t n = 0;
+        for (size_t i = 0; i < sizeof b; ++i)
+            n = n << 8 | b[i];
+        from_uint(n, &value);
+    }
+    template <typename T>
+    void write_bendian_t(T value, abort_callback &abort)
+    {
+        uint8_t b[sizeof(T)];
+        uint64_t n = to_uint(value);
+        for (size_t i = sizeof b; i > 0; --i, n >>= 8)
+            b[i - 1] = n & 0xff;
+        write(b, sizeof b, abort);
+    }
+private:
+    template <typename T> static void from_uint(uint64_t n, T *value)
+    {
+        switch (sizeof(T)) {
+        case 1: { uint8_t  v = n; std::memcpy(value, &v, 1); break; }
+        case 2: { uint16_t v = n; std::memcpy(value, &v, 2); break; }
+        case 4: { uint32_t v = n; std::memcpy(value, &v, 4); break; }
+        case 8: { uint64_t v = n; std::memcpy(value, &v, 8); break; }
+        }
+    }
+    template <typename T> static uint64_t to_uint(T value)
+    {
+        switch (sizeof(T)) {
+        case 1: { uint8_t  v; std::memcpy(&v, &value, 1); return v; }
+        case 2: { uint16_t v; std::memcpy(&v, &value, 2); return v; }
+        case 4: { uint32_t v; std::memcpy(&v, &value, 4); return v; }
+        case 8: { uint64_t v; std::memcpy(&v, &value, 8); return v; }
+        }
+        return 0;
+    }
+};
+
+/*
+ * Whole file in memory; writes past the end grow it.
+ */
+class MemoryByteSource: public IByteSource {
+    std::vector<uint8_t> m_data;
+    t_filesize           m_position;
+public:
+    MemoryByteSource(): m_position(0) {}
+    explicit MemoryByteSource(const std::vector<uint8_t> &data)
+        : m_data(data), m_position(0)
+    {}
+    const std::vector<uint8_t> &data() const { return m_data; }
+
+    t_size read_some(void *buffer, t_size bytes, abort_callback &abort)
+    {
+        abort.check();
+        if (m_position >= m_data.size())
+            return 0;
+        t_size n = std::min<t_filesize>(bytes, m_data.size() - m_position);
+        std::memcpy(buffer, m_data.data() + m_position, n);
+        m_position += n;
+        return n;
+    }
+    void write(const void *buffer, t_size bytes, abort_callback &abort)
+    {
+        abort.check();
+        if (m_position + bytes > m_data.size())
+            m_data.resize(m_position + bytes);
+        std::memcpy(m_data.data() + m_position, buffer, bytes);
+        m_position += bytes;
+    }
+    void seek(t_filesize position, abort_callback &abort)
+    {
+        m_position = position;
+    }
+    t_filesize get_position(abort_callback &abort) { return m_position; }
+    t_filesize get_size(abort_callback &abort) { return m_data.size(); }
+};
+
+/*
+ * Read-through window over another source: a read outside of the window
+ * refills it with one read of window size at that position, so that
+ * headers and other small fields are served from memory. Reads as large
+ * as the window bypass it. Size and position are tracked here, and
+ * the underlying source is only seeked before refills and writes.
+ */
+class BufferedByteSource: public IByteSource {
+    std::shared_ptr<IByteSource> m_source;
+    std::vector<uint8_t>         m_window;
+    t_filesize                   m_window_offset;
+    size_t                       m_window_size;
+    t_filesize                   m_position;
+    t_filesize                   m_size;
+public:
+    BufferedByteSource(const std::shared_ptr<IByteSource> &source,
+                       size_t window_size, abort_callback &abort)
+        : m_source(source), m_window_offset(0),
+          m_window_size(std::max<size_t>(window_size, 4096))
+    {
+        m_position = m_source->get_position(abort);
+        m_size     = m_source->get_size(abort);
+    }
+    /* hands over what is currently buffered */
+    void take_window(std::vector<uint8_t> *window, t_filesize *offset)
+    {
+        window->swap(m_window);
+        *offset = m_window_offset;
+        m_window.clear();
+    }
+
+    t_size read_some(void *buffer, t_size bytes, abort_callback &abort)
+    {
+        uint8_t *bp = static_cast<uint8_t *>(buffer);
+        t_size done = 0;
+        while (done < bytes && m_position < m_size) {
+            if (m_position >= m_window_offset &&
+                m_position < m_window_offset + m_window.size())
+            {
+                size_t off = m_position - m_window_offset;
+                t_size n = std::min<t_size>(bytes - done,
+                                            m_window.size() - off);
+                std::memcpy(bp + done, m_window.data() + off, n);
+                done += n;
+                m_position += n;
+                continue;
+            }
+            m_source->seek(m_position, abort);
+            if (bytes - done >= m_window_size) {
+                t_size n = m_source->read_some(bp + done, bytes - done,
+                                               abort);
+                done += n;
+                m_position += n;
+                break;
+            }
+            m_window.resize(std::min<t_filesize>(m_window_size,
+                                                 m_size - m_position));
+            m_window.resize(m_source->read_some(m_window.data(),
+                                                m_window.size(), abort));
+            m_window_offset = m_position;
+            if (m_window.empty())
+                break;
+        }
+        return done;
+    }
+    void write(const void *buffer, t_size bytes, abort_callback &abort)
+    {
+        m_window.clear();
+        m_source->seek(m_position, abort);
+        m_source->write(buffer, bytes, abort);
+        m_position += bytes;
+        m_size = std::max(m_size, m_position);
+    }
+    void seek(t_filesize position, abort_callback &abort)
+    {
+        m_position = position;
+    }
+    t_filesize get_position(abort_callback &abort) { return m_position; }
+    t_filesize get_size(abort_callback &abort) { return m_size; }
+};
+
+#ifndef CAF_PORTABLE
+
+class FileByteSource: public IByteSource {
+    service_ptr_t<file> m_file;
+public:
+    explicit FileByteSource(const service_ptr_t<file> &file): m_file(file) {}
+
+    t_size read_some(void *buffer, t_size bytes, abort_callback &abort)
+    {
+        return m_file->read(buffer, bytes, abort);
+    }
+    void write(const void *buffer, t_size bytes, abort_callback &abort)
+    {
+        m_file->write(buffer, bytes, abort);
+    }
+    void seek(t_filesize position, abort_callback &abort)
+    {
+        m_file->seek(position, abort);
+    }
+    t_filesize get_position(abort_callback &abort)
+    {
+        return m_file->get_position(abort);
+    }
+    t_filesize get_size(abort_callback &abort)
+    {
+        return m_file->get_size(abort);
+    }
+};
+
+#else
+
+class FileByteSource: public IByteSource {
+    FILE       *m_fp;
+    t_filesize  m_size;
+public:
+    /* mode as in fopen() */
+    FileByteSource(const char *path, const char *mode="rb")
+        : m_fp(std::fopen(path, mode))
+    {
+        if (!m_fp)
+            throw std::runtime_error(std::string("cannot open ") + path);
+        fseeko(m_fp, 0, SEEK_END);
+        m_size = ftello(m_fp);
+        fseeko(m_fp, 0, SEEK_SET);
+    }
+    ~FileByteSource() { std::fclose(m_fp); }
+
+    t_size read_some(void *buffer, t_size bytes, abort_callback &abort)
+    {
+        abort.check();
+        return std::fread(buffer, 1, bytes, m_fp);
+    }
+    void write(const void *buffer, t_size bytes, abort_callback &abort)
+    {
+        abort.check();
+        if (std::fwrite(buffer, 1, bytes, m_fp) != bytes)
+            throw std::runtime_error("write failed");
+        m_size = std::max<t_filesize>(m_size, ftello(m_fp));
+    }
+    void seek(t_filesize position, abort_callback &abort)
+    {
+        if (fseeko(m_fp, position, SEEK_SET))
+            throw std::runtime_error("seek failed");
+    }
+    t_filesize get_position(abort_callback &abort)
+    {
+        return ftello(m_fp);
+    }
+    t_filesize get_size(abort_callback &abort) { return m_size; }
+#ifdef __linux__
+    /*
+     * Between two files, let the kernel copy (or share extents on
+     * filesystems that support reflinks).
+     */
+    void copy_from(IByteSource &src, t_filesize bytes, abort_callback &abort)
+    {
+        FileByteSource *fsrc = dynamic_cast<FileByteSource *>(&src);
+        if (!fsrc) {
+            IByteSource::copy_from(src, bytes, abort);
+            return;
+        }
+        std::fflush(m_fp);
+        loff_t in  = ftello(fsrc->m_fp);
+        loff_t out = ftello(m_fp);
+        while (bytes > 0) {
+            abort.check();
+            ssize_t n = ::copy_file_range(fileno(fsrc->m_fp), &in,
+                                          fileno(m_fp), &out,
+                                          std::min<t_filesize>(bytes, 1 << 30),
+                                          0);
+            if (n <= 0)
+                break;
+            bytes -= n;
+        }
+        fseeko(fsrc->m_fp, in, SEEK_SET);
+        fseeko(m_fp, out, SEEK_SET);
+        m_size = std::max<t_filesize>(m_size, out);
+        /* not supported here (or cross-device on older kernels) */
+        if (bytes > 0)
+            IByteSource::copy_from(src, bytes, abort);
+    }
+#endif
+    /* flushes buffered writes down to the disk */
+    void sync()
+    {
+        if (std::fflush(m_fp) || fsync(fileno(m_fp)))
+            throw std::runtime_error("write failed");
+    }
+private:
+    FileByteSource(const FileByteSource &);
+    FileByteSource& operator=(const FileByteSource &);
+};
+
+#endif
+
+#endif
@@ -1,10 +1,16 @@
 #include <algorithm>
+#include <cmath>
+#include <cstdio>
 #include <numeric>
 #include <iterator>
 #define NOMINMAX
 #include "CAFFile.h"
+#include "Trace.h"
 
 namespace {
+    /* minimum slack left after info when it has to be moved */
+    const int64_t INFO_PADDING = 4096;
+
     void translate_channel_labels(char *channels)
     {
         unsigned i;
@@ -27,12 +33,12 @@ namespace {
         }
     }
 
-    unsigned read_ber_integer(stream_reader *reader, abort_callback &abort)
+    unsigned read_ber_integer(IByteSource *reader, abort_callback &abort)
     {
         unsigned n = 0;
         uint8_t  b = 0;
         do {
-            reader->read_object_t(b, abort);
+            reader->read(&b, 1, abort);
             n <<= 7;
             n |=  b & 0x7f;
         } while (b & 0x80);
@@ -168,70 +174,329 @@ uint32_t CAFFile::read_packets(int64_t offset, uint32_t count,
                 size_total += m_packet_table[offset + i].mDataByteSize;
         }
         data->resize(size_total);
-        m_pfile->seek(m_data_offset + bytes_offset, abort);
-        m_pfile->read(data->data(), data->size(), abort);
+        t_filesize pos = m_data_offset + bytes_offset;
+        if (m_head.size() && pos >= m_head_offset &&
+            pos + size_total <= m_head_offset + m_head.size())
+        {
+            std::memcpy(data->data(), m_head.data() + (pos - m_head_offset),
+                        size_total);
+        } else {
+            m_pfile->seek(pos, abort);
+            m_pfile->read(data->data(), data->size(), abort);
+            m_counters.add(PerfCounters::SEEKS, 1);
+        }
+        /* the window is only for the first read, used or not */
+        drop_head_window();
+        m_counters.add(PerfCounters::BYTES_READ, size_total);
+        m_counters.peak(PerfCounters::PEAK_PACKET_BUFFER, size_total);
     }
+    m_counters.add(PerfCounters::READ_CALLS, 1);
     return count;
 }
 
-void CAFFile::set_metadata(const file_info &info, abort_callback &abort)
+void CAFFile::check_structure(std::vector<std::string> *problems) const
 {
-    Metadata::put_entries(&m_tags, info);
-    auto lambda = [](unsigned n, const Metadata::string_pair &e) -> unsigned {
-        return n + e.first.size() + e.second.size() + 2;
-    };
-    int len = std::accumulate(m_tags.begin(), m_tags.end(), 0u, lambda) + 4;
+    char msg[160];
+    uint32_t bpp = format().asbd.mBytesPerPacket;
+    if (m_packet_table.empty()) {
+        if (bpp && m_data_size % bpp) {
+            std::snprintf(msg, sizeof msg,
+                          "data chunk ends %u bytes into packet %lld",
+                          static_cast<unsigned>(m_data_size % bpp),
+                          static_cast<long long>(m_data_size / bpp));
+            problems->push_back(msg);
+        }
+        return;
+    }
+    /* packets are laid out back to back from the start of the data */
+    uint64_t end = 0, frames = 0;
+    int64_t first_outside = -1;
+    for (size_t i = 0; i < m_packet_table.size(); ++i) {
+        const AudioStreamPacketDescription &aspd = m_packet_table[i];
+        end = aspd.mStartOffset + aspd.mDataByteSize;
+        frames += aspd.mVariableFramesInPacket;
+        if (end > m_data_size && first_outside < 0)
+            first_outside = i;
+    }
+    if (first_outside >= 0) {
+        std::snprintf(msg, sizeof msg,
+                      "packets %lld to %lld of %lld end past the data chunk "
+                      "(%llu of %llu bytes present)",
+                      static_cast<long long>(first_outside),
+                      static_cast<long long>(m_packet_table.size() - 1),
+                      static_cast<long long>(m_packet_table.size()),
+                      static_cast<unsigned long long>(m_data_size),
+                      static_cast<unsigned long long>(end));
+        problems->push_back(msg);
+    } else if (end < m_data_size) {
+        std::snprintf(msg, sizeof msg,
+                      "%llu bytes of data follow the last packet",
+                      static_cast<unsigned long long>(m_data_size - end));
+        problems->push_back(msg);
+    }
+    const AudioFilePacketTableInfo &info = m_packet_info;
+    if (info.mPrimingFrames < 0 || info.mRemainderFrames < 0) {
+        std::snprintf(msg, sizeof msg,
+                      "negative priming (%d) or remainder (%d) frames",
+                      info.mPrimingFrames, info.mRemainderFrames);
+        problems->push_back(msg);
+    } else if (info.mNumberValidFrames) {
+        int64_t total = info.mNumberValidFrames + info.mPrimingFrames
+                      + info.mRemainderFrames;
+        if (total != static_cast<int64_t>(frames)) {
+            std::snprintf(msg, sizeof msg,
+                          "pakt accounts for %lld frames (valid %lld, "
+                          "priming %d, remainder %d) but its packets "
+                          "hold %llu",
+                          static_cast<long long>(total),
+                          static_cast<long long>(info.mNumberValidFrames),
+                          info.mPrimingFrames, info.mRemainderFrames,
+                          static_cast<unsigned long long>(frames));
+            problems->push_back(msg);
+        }
+    }
+}
+
+namespace {
+    void put_bendian(uint64_t v, unsigned n, std::vector<uint8_t> *buf)
+    {
+        for (unsigned i = n; i-- > 0; )
+            buf->push_back(static_cast<uint8_t>(v >> (8 * i)));
+    }
+}
+
+void CAFFile::serialize_info(const tags_t &tags, std::vector<uint8_t> *buf)
+{
+    int64_t len = tags.info_size();
+    buf->reserve(buf->size() + 12 + len);
+    put_bendian(FOURCC('i','n','f','o'), 4, buf);
+    put_bendian(len, 8, buf);
+    put_bendian(tags.size(), 4, buf);
+    tags.serialize(buf);
+}
+
+void CAFFile::serialize_free(int64_t room, int64_t len, int64_t pad,
+                             std::vector<uint8_t> *buf)
+{
+    if (len < room) {
+        put_bendian(FOURCC('f','r','e','e'), 4, buf);
+        put_bendian(room - len - 12, 8, buf);
+        buf->resize(buf->size() + pad);
+    }
+}
+
+bool CAFFile::tags_fit_before_data(const tags_t &tags, abort_callback &abort)
+{
+    int64_t len = tags.info_size();
+    t_filesize room_pos = 0, info_pos = 0;
+    int64_t room = find_room(FOURCC('i','n','f','o'), &room_pos, &info_pos,
+                             abort);
+    return room_pos < m_data_offset && (len == room || len <= room - 12);
+}
+
+void CAFFile::set_tags(const tags_t &tags, abort_callback &abort)
+{
+    m_tags = tags;
+    m_write_buffer.clear();
+    serialize_info(m_tags, &m_write_buffer);
+    /*
+     * Leave some slack after the new info if it has to be moved, so that
+     * following edits can be done in place.
+     */
+    store_chunk(FOURCC('i','n','f','o'),
+                std::max(INFO_PADDING, m_tags.info_size() / 10), abort);
+}
 
-    t_filesize room_pos, info_pos;
-    int64_t room = find_room_for_info(&room_pos, &info_pos, abort);
+void CAFFile::store_chunk(uint32_t fcc, int64_t pad, abort_callback &abort)
+{
+    int64_t len = m_write_buffer.size() - 12;
+
+    t_filesize room_pos = 0, old_pos = 0;
+    int64_t room = find_room(fcc, &room_pos, &old_pos, abort);
     bool not_enough = (len != room && len > room - 12);
     if (not_enough) {
-        room     = len;
+        room     = pad ? len + 12 + pad : len;
         room_pos = m_pfile->get_size(abort);
+    } else {
+        pad = 0;
     }
+    /*
+     * The chunk and the trailing free header go out in one write.
+     * When appending, payload of the free box is written out too (as zeros)
+     * to extend the file; otherwise old contents are left as they are.
+     */
+    serialize_free(room, len, pad, &m_write_buffer);
     /*
      * DESTRUCTIVE change!
-     * Order is important to minimize the possibility of completely
-     * destroying the box structure and making the file unreadable.
+     * When appending, the new chunk is complete before the old one is
+     * given up, so the file stays readable if we fail in between.
      */
     abort_callback_dummy noabort;
-    /* when room was not enough, create room at the end */
-    if (not_enough) {
-        m_pfile->seek(room_pos, abort);
-        m_pfile->write_bendian_t(FOURCC('f','r','e','e'), noabort);
-        m_pfile->write_bendian_t(static_cast<int64_t>(len), noabort);
-    }
-    /* write out the tags */
-    m_pfile->seek(room_pos + 12, noabort);
-    m_pfile->write_bendian_t(static_cast<uint32_t>(m_tags.size()), noabort);
-    for (size_t i = 0; i < m_tags.size(); ++i) {
-        auto key = m_tags[i].first;
-        auto val = m_tags[i].second;
-        m_pfile->write(key.c_str(), key.size() + 1, noabort);
-        m_pfile->write(val.c_str(), val.size() + 1, noabort);
-    }
-    /* when room was enough, cut off the remainder by free box */
-    if (len < room) {
-        int64_t free_size = room - len - 12;
-        m_pfile->write_bendian_t(FOURCC('f','r','e','e'), noabort);
-        m_pfile->write_bendian_t(free_size, noabort);
-    }
-    /* now we mark new info box */
-    m_pfile->seek(room_pos, noabort);
-    m_pfile->write_bendian_t(FOURCC('i','n','f','o'), noabort);
-    m_pfile->write_bendian_t(static_cast<int64_t>(len), noabort);
-    /* turn old info into free box if it was not available */
-    if (info_pos > 0 && (info_pos != room_pos || not_enough)) {
-        m_pfile->seek(info_pos, noabort);
+    if (not_enough && m_data_unsized) {
+        /* data extends up to EOF; give it the size before appending */
+        m_pfile->seek(m_data_offset - 12, abort);
+        m_pfile->write_bendian_t(m_data_size + 4, noabort);
+        m_data_unsized = false;
+    }
+    m_pfile->seek(room_pos, abort);
+    m_pfile->write(m_write_buffer.data(), m_write_buffer.size(), noabort);
+    /*
+     * turn the old chunk into free box, unless it was inside the room we
+     * have just overwritten
+     */
+    if (old_pos > 0 &&
+        (old_pos < room_pos || old_pos >= room_pos + room + 12)) {
+        m_pfile->seek(old_pos, noabort);
         m_pfile->write_bendian_t(FOURCC('f','r','e','e'), noabort);
     }
 }
 
-void CAFFile::parse(abort_callback &abort)
+bool CAFFile::overview_range(unsigned channel, int64_t first, int64_t count,
+                             int16_t *min_value, int16_t *max_value) const
 {
+    unsigned nchannels = m_primary_format.asbd.mChannelsPerFrame;
+    if (!has_overview() || channel >= nchannels || count <= 0)
+        return false;
+    /* the overview covers every decoded frame, priming included */
+    first += start_offset();
+    uint32_t fpp    = m_overview.frames_per_point;
+    int64_t  npoints = m_overview.data.size() / (2 * nchannels);
+    int64_t  begin   = std::max<int64_t>(first / fpp, 0);
+    int64_t  end     = std::min((first + count + fpp - 1) / fpp, npoints);
+    if (begin >= end)
+        return false;
+    unsigned coded = m_primary_format.channel_map.size() == nchannels
+                   ? m_primary_format.channel_map[channel] : channel;
+    const int16_t *p = m_overview.data.data()
+                     + 2 * (begin * nchannels + coded);
+    int16_t lo = p[0], hi = p[1];
+    for (int64_t i = begin; i < end; ++i, p += 2 * nchannels) {
+        lo = std::min(lo, p[0]);
+        hi = std::max(hi, p[1]);
+    }
+    *min_value = lo;
+    *max_value = hi;
+    return true;
+}
+
+void CAFFile::set_overview(const Overview &overview, abort_callback &abort)
+{
+    m_overview = overview;
+    m_overview.edit_count = m_data_edit_count;
+    m_write_buffer.clear();
+    m_write_buffer.reserve(12 + 8 + 2 * m_overview.data.size() + 12);
+    put_bendian(FOURCC('o','v','v','w'), 4, &m_write_buffer);
+    put_bendian(8 + 2 * m_overview.data.size(), 8, &m_write_buffer);
+    put_bendian(m_overview.edit_count, 4, &m_write_buffer);
+    put_bendian(m_overview.frames_per_point, 4, &m_write_buffer);
+    for (size_t i = 0; i < m_overview.data.size(); ++i)
+        put_bendian(static_cast<uint16_t>(m_overview.data[i]), 2,
+                    &m_write_buffer);
+    /* overviews are rewritten whole with the same size; no slack needed */
+    store_chunk(FOURCC('o','v','v','w'), 0, abort);
+}
+
+void CAFFile::set_peaks(const std::vector<Peak> &peaks,
+                        abort_callback &abort)
+{
+    m_peaks = peaks;
+    m_peak_edit_count = m_data_edit_count;
+    m_write_buffer.clear();
+    put_bendian(FOURCC('p','e','a','k'), 4, &m_write_buffer);
+    put_bendian(4 + 12 * m_peaks.size(), 8, &m_write_buffer);
+    put_bendian(m_peak_edit_count, 4, &m_write_buffer);
+    for (size_t i = 0; i < m_peaks.size(); ++i) {
+        uint32_t v;
+        std::memcpy(&v, &m_peaks[i].value, 4);
+        put_bendian(v, 4, &m_write_buffer);
+        put_bendian(m_peaks[i].frame, 8, &m_write_buffer);
+    }
+    store_chunk(FOURCC('p','e','a','k'), 0, abort);
+}
+
+void CAFFile::rewrite(IByteSource *dst, const tags_t &tags,
+                      abort_callback &abort)
+{
+    TraceSpan span("CAFFile::rewrite");
+    struct Chunk {
+        uint32_t   fcc;
+        t_filesize pos;
+        int64_t    size;
+    };
+    std::vector<Chunk> chunks;
+    uint8_t header[8];
+
+    m_pfile->seek(0, abort);
+    m_pfile->read(header, 8, abort);
+    for (;;) {
+        Chunk c;
+        c.pos = m_pfile->get_position(abort);
+        if (c.pos + 12 > m_pfile->get_size(abort))
+            break;
+        m_pfile->read_bendian_t(c.fcc,  abort);
+        m_pfile->read_bendian_t(c.size, abort);
+        if (c.fcc == FOURCC('d','a','t','a')) {
+            c.size = m_data_size + 4;
+            chunks.push_back(c);
+            if (m_data_unsized)
+                break;
+        } else if (c.fcc != FOURCC('f','r','e','e')
+                && c.fcc != FOURCC('i','n','f','o')) {
+            chunks.push_back(c);
+        }
+        m_pfile->seek(c.pos + 12 + c.size, abort);
+    }
+    /*
+     * desc, chan, kuki and everything else first (in their original
+     * order), then info with some padding, pakt and finally data.
+     */
+    dst->write(header, 8, abort);
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        if (chunks[i].fcc == FOURCC('p','a','k','t')
+         || chunks[i].fcc == FOURCC('d','a','t','a'))
+            continue;
+        m_pfile->seek(chunks[i].pos, abort);
+        dst->copy_from(*m_pfile, 12 + chunks[i].size, abort);
+    }
+    int64_t len = tags.info_size();
+    int64_t pad = std::max(INFO_PADDING, len / 10);
+    m_write_buffer.clear();
+    serialize_info(tags, &m_write_buffer);
+    serialize_free(len + 12 + pad, len, pad, &m_write_buffer);
+    dst->write(m_write_buffer.data(), m_write_buffer.size(), abort);
+
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        if (chunks[i].fcc != FOURCC('p','a','k','t'))
+            continue;
+        m_pfile->seek(chunks[i].pos, abort);
+        dst->copy_from(*m_pfile, 12 + chunks[i].size, abort);
+    }
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        if (chunks[i].fcc != FOURCC('d','a','t','a'))
+            continue;
+        dst->write_bendian_t(chunks[i].fcc,  abort);
+        dst->write_bendian_t(chunks[i].size, abort);
+        m_pfile->seek(chunks[i].pos + 12, abort);
+        dst->copy_from(*m_pfile, chunks[i].size, abort);
+    }
+}
+
+void CAFFile::parse(size_t probe_size, abort_callback &abort)
+{
+    TraceSpan span("CAFFile::parse");
     uint32_t fcc;
     int64_t  size;
 
+    /* parse_*() read through m_pfile; point it to the window meanwhile */
+    struct Restore {
+        std::shared_ptr<IByteSource> &ref;
+        std::shared_ptr<IByteSource>  saved;
+        ~Restore() { ref = saved; }
+    } restore = { m_pfile, m_pfile };
+    auto probe = std::make_shared<BufferedByteSource>(m_pfile, probe_size,
+                                                      abort);
+    m_pfile = probe;
+
     m_pfile->read_bendian_t(fcc, abort);
     if (fcc != FOURCC('c','a','f','f'))
         throw std::runtime_error("not a caf file");
@@ -262,12 +527,18 @@ void CAFFile::parse(abort_callback &abort)
             parse_info(size, abort); break;
         case FOURCC('p','a','k','t'):
             parse_pakt(size, abort); break;
+        case FOURCC('o','v','v','w'):
+            parse_ovvw(size, abort); break;
+        case FOURCC('p','e','a','k'):
+            parse_peak(size, abort); break;
         }
         if (fcc == FOURCC('d','a','t','a')) {
+            m_pfile->read_bendian_t(m_data_edit_count, abort);
             m_data_offset = pos + 16;
             m_data_size   = size - 4;
             if (size == -1) {
                 m_data_size = m_pfile->get_size(abort) - pos - 16;
+                m_data_unsized = true;
                 break;
             }
         }
@@ -277,7 +548,15 @@ void CAFFile::parse(abort_callback &abort)
         throw std::runtime_error("desc chunk not found");
     if (m_data_offset == 0)
         throw std::runtime_error("data chunk not found");
+    if (!m_primary_format.asbd.mBytesPerPacket && m_packet_table.empty())
+        throw std::runtime_error("packet table not found");
     calc_duration();
+
+    /* the first packets are likely to be read next; keep them at hand */
+    probe->take_window(&m_head, &m_head_offset);
+    if (m_data_offset < m_head_offset ||
+        m_data_offset >= m_head_offset + m_head.size())
+        drop_head_window();
 }
 
 void CAFFile::parse_desc(Format *d, abort_callback &abort)
@@ -351,6 +630,41 @@ void CAFFile::parse_ldsc(int64_t size, abort_callback &abort)
     }
 }
 
+void CAFFile::parse_ovvw(int64_t size, abort_callback &abort)
+{
+    unsigned nchannels = m_primary_format.asbd.mChannelsPerFrame;
+    if (size < 8 || !nchannels
+     || size > m_pfile->get_size(abort) - m_pfile->get_position(abort))
+        return;
+    m_pfile->read_bendian_t(m_overview.edit_count,       abort);
+    m_pfile->read_bendian_t(m_overview.frames_per_point, abort);
+    /* whole points only */
+    size_t count = (size - 8) / (4 * nchannels) * 2 * nchannels;
+    m_overview.data.resize(count);
+    m_pfile->read(m_overview.data.data(), count * 2, abort);
+    for (size_t i = 0; i < count; ++i) {
+        auto p = reinterpret_cast<uint8_t *>(&m_overview.data[i]);
+        m_overview.data[i] = static_cast<int16_t>(p[0] << 8 | p[1]);
+    }
+}
+
+void CAFFile::parse_peak(int64_t size, abort_callback &abort)
+{
+    unsigned nchannels = m_primary_format.asbd.mChannelsPerFrame;
+    if (size != 4 + 12 * int64_t(nchannels))
+        return;
+    m_pfile->read_bendian_t(m_peak_edit_count, abort);
+    m_peaks.resize(nchannels);
+    for (unsigned i = 0; i < nchannels; ++i) {
+        uint32_t v;
+        m_pfile->read_bendian_t(v, abort);
+        m_pfile->read_bendian_t(m_peaks[i].frame, abort);
+        std::memcpy(&m_peaks[i].value, &v, 4);
+        /* some writers keep the sign of the peak sample */
+        m_peaks[i].value = std::fabs(m_peaks[i].value);
+    }
+}
+
 void CAFFile::parse_kuki(int64_t size, abort_callback &abort)
 {
     m_magic_cookie.resize(size);
@@ -365,20 +679,19 @@ void CAFFile::parse_info(int64_t size, abort_callback &abort)
     }
     uint32_t num_info;
     std::vector<char> buf(size - 4);
-    char *key, *val, *end;
 
     m_pfile->read_bendian_t(num_info, abort);
     m_pfile->read(buf.data(), size - 4, abort);
-
-    key = buf.data();
-    end = buf.data() + buf.size();
-    do {
-        if ((val = key + strlen(key) + 1) < end) {
-            m_tags.push_back(std::make_pair(std::string(key),
-                                                std::string(val)));
-            key = val + strlen(val) + 1;
-        }
-    } while (key < end && val < end);
+    if (m_tags.empty()) {
+        m_tags.assign(buf, num_info);
+        return;
+    }
+    /* more than one info chunk */
+    TagList more;
+    more.assign(buf, num_info);
+    for (size_t i = 0; i < more.size(); ++i)
+        m_tags.add(more.key(i), more.key_size(i),
+                   more.value(i), more.value_size(i));
 }
 
 void CAFFile::parse_pakt(int64_t size, abort_callback &abort)
@@ -394,12 +707,16 @@ void CAFFile::parse_pakt(int64_t size, abort_callback &abort)
 
     uint32_t low = ~0, high = 0;
 
+    /* mNumberPackets is not trusted for more than the chunk can hold */
+    if (!asbd.mBytesPerPacket)
+        m_packet_table.reserve(std::max<int64_t>(std::min(mNumberPackets,
+                                                          size - 24), 0));
     for (i = 0; i < mNumberPackets; ++i) {
         AudioStreamPacketDescription aspd = { 0 };
         aspd.mStartOffset  = pos;
         if (!asbd.mBytesPerPacket)
             aspd.mDataByteSize =
-                read_ber_integer(m_pfile.get_ptr(), abort);
+                read_ber_integer(m_pfile.get(), abort);
         else
             aspd.mDataByteSize = asbd.mBytesPerPacket;
         pos += aspd.mDataByteSize;
@@ -408,13 +725,14 @@ void CAFFile::parse_pakt(int64_t size, abort_callback &abort)
 
         if (!asbd.mFramesPerPacket)
             aspd.mVariableFramesInPacket =
-                read_ber_integer(m_pfile.get_ptr(), abort);
+                read_ber_integer(m_pfile.get(), abort);
         else
             aspd.mVariableFramesInPacket = asbd.mFramesPerPacket;
         m_packet_table.push_back(aspd);
     }
     if (high > low + 1)
         m_nearly_cbr = false;
+    m_max_packet_size = high;
 }
 
 void CAFFile::calc_duration()
@@ -635,29 +953,29 @@ void CAFFile::parse_channels(Format *d, const std::vector<char> &channels)
         d->channel_map[i] = v[i] - &channels[0];
 }
 
-int64_t CAFFile::find_room_for_info(t_filesize *room_pos, t_filesize *info_pos,
-                                    abort_callback &abort)
+int64_t CAFFile::find_room(uint32_t fcc_to_replace, t_filesize *room_pos,
+                           t_filesize *old_pos, abort_callback &abort)
 {
     uint32_t fcc, pre_fcc = 0;
     int64_t  size, size_acc = 0, max_size_acc = 0;
     t_filesize candidate_pos = 0, max_candidate_pos = 0;
 
-    m_pfile->seek(8, abort);
+    BufferedByteSource src(m_pfile, DEFAULT_PROBE_SIZE, abort);
+    src.seek(8, abort);
     for (;;) {
-        t_filesize pos = m_pfile->get_position(abort);
-        if (pos >= m_pfile->get_size(abort))
+        t_filesize pos = src.get_position(abort);
+        if (pos + 12 > src.get_size(abort)) /* EOF or trailing junk */
             break;
-        m_pfile->read_bendian_t(fcc,  abort);
-        m_pfile->read_bendian_t(size, abort);
-        switch (fcc) {
-        case FOURCC('i','n','f','o'):
-            *info_pos = pos;
-            /* FALLTHROUGH */
-        case FOURCC('f','r','e','e'):
+        src.read_bendian_t(fcc,  abort);
+        src.read_bendian_t(size, abort);
+        if (size == -1) /* data up to EOF */
+            break;
+        if (fcc == fcc_to_replace)
+            *old_pos = pos;
+        if (fcc == fcc_to_replace || fcc == FOURCC('f','r','e','e')) {
             size_acc += size + 12;
             if (!candidate_pos) candidate_pos = pos;
-            break;
-        default:
+        } else {
             if (size_acc > max_size_acc) {
                 max_size_acc      = size_acc;
                 max_candidate_pos = candidate_pos;
@@ -665,7 +983,7 @@ int64_t CAFFile::find_room_for_info(t_filesize *room_pos, t_filesize *info_pos,
             size_acc      = 0;
             candidate_pos = 0;
         }
-        m_pfile->skip(size, abort);
+        src.skip(size, abort);
     }
     if (size_acc > max_size_acc) {
         max_size_acc      = size_acc;
@@ -2,14 +2,19 @@
 #define CAFFILE_H
 
 #include <cstdint>
+#include <cstring>
+#include <memory>
 #include <vector>
 #include <string>
 #include <utility>
-#include "../SDK/foobar2000-winver.h"
-#include "../SDK/foobar2000.h"
+#include "ByteSource.h"
 #include "CoreAudio/CoreAudioTypes.h"
 #include "Helpers.h"
+#include "PerfCounters.h"
+#include "TagList.h"
+#ifndef CAF_PORTABLE
 #include "Metadata.h"
+#endif
 
 class CAFFile {
 public:
@@ -20,9 +25,24 @@ public:
 
         Format(): channel_mask(0) { std::memset(&asbd, 0, sizeof asbd); }
     };
+    typedef TagList tags_t;
+    /* contents of an ovvw chunk */
+    struct Overview {
+        uint32_t             edit_count;
+        uint32_t             frames_per_point;
+        /* (min, max) pairs, interleaved by channel as in the file */
+        std::vector<int16_t> data;
+
+        Overview(): edit_count(0), frames_per_point(0) {}
+    };
+    /* peak chunk entry, one per channel */
+    struct Peak {
+        float    value;     /* absolute, 1.0 is full scale */
+        uint64_t frame;     /* in decoded frames, priming included */
+    };
 private:
-    service_ptr_t<file>                               m_pfile;
-    std::vector<std::pair<std::string, std::string> > m_tags;
+    std::shared_ptr<IByteSource>                      m_pfile;
+    tags_t                                            m_tags;
     Format                                            m_primary_format;
     std::vector<Format>                               m_layered_formats;
     std::vector<uint8_t>                              m_magic_cookie;
@@ -30,15 +50,42 @@ private:
     std::vector<AudioStreamPacketDescription>         m_packet_table;
     t_filesize                                        m_data_offset;
     t_filesize                                        m_data_size;
+    bool                                              m_data_unsized;
+    uint32_t                                          m_data_edit_count;
     bool                                              m_nearly_cbr;
+    uint32_t                                          m_max_packet_size;
     int64_t                                           m_duration;
+    Overview                                          m_overview;
+    std::vector<Peak>                                 m_peaks;
+    uint32_t                                          m_peak_edit_count;
+    PerfCounters                                      m_counters;
+    std::vector<uint8_t>                              m_write_buffer;
+    /*
+     * read-ahead window left from parsing, while it covers the data and
+     * until the first read_packets()
+     */
+    std::vector<uint8_t>                              m_head;
+    t_filesize                                        m_head_offset;
 public:
-    CAFFile(const service_ptr_t<file> &file, abort_callback &abort)
+    enum { DEFAULT_PROBE_SIZE = 65536 };
+    /*
+     * Headers are parsed out of windows of probe_size bytes, each fetched
+     * with one read; usually the first one has all of them.
+     */
+    CAFFile(const std::shared_ptr<IByteSource> &file, abort_callback &abort,
+            size_t probe_size=DEFAULT_PROBE_SIZE)
         : m_pfile(file), m_data_offset(0), m_data_size(0),
-          m_nearly_cbr(true), m_duration(0)
+          m_data_unsized(false), m_data_edit_count(0), m_nearly_cbr(true),
+          m_max_packet_size(0), m_duration(0), m_peak_edit_count(0),
+          m_head_offset(0)
     {
         memset(&m_packet_info, 0, sizeof m_packet_info);
-        parse(abort);
+        parse(probe_size, abort);
+    }
+    /* for instances that will not read packets (e.g. info only) */
+    void drop_head_window()
+    {
+        std::vector<uint8_t>().swap(m_head);
     }
     const Format &format() const
     {
@@ -60,6 +107,14 @@ public:
         else
             return m_data_size / format().asbd.mBytesPerPacket;
     }
+    /* in bytes, for sizing packet buffers up front */
+    uint32_t max_packet_size() const
+    {
+        if (m_packet_table.size())
+            return m_max_packet_size;
+        else
+            return format().asbd.mBytesPerPacket;
+    }
     int32_t start_offset() const
     {
         return m_packet_info.mPrimingFrames * tscale() + .5;
@@ -78,18 +133,98 @@ public:
         return static_cast<uint32_t>(bps / 1000 + 0.5);
     }
     void get_magic_cookie(std::vector<uint8_t> *data) const;
+    /* kuki chunk as stored in the file */
+    const std::vector<uint8_t> &magic_cookie() const
+    {
+        return m_magic_cookie;
+    }
+    /* pakt header as stored in the file (zero when there is none) */
+    const AudioFilePacketTableInfo &packet_table_info() const
+    {
+        return m_packet_info;
+    }
+    /* shared by everything decoding from this file */
+    PerfCounters &counters()
+    {
+        return m_counters;
+    }
     
     /* returns position in bytes, optionally fills packet size */
     int64_t packet_info(int64_t index, uint32_t *size=0) const;
 
     uint32_t read_packets(int64_t offset, uint32_t count,
                           std::vector<uint8_t> *data, abort_callback &abort);
+    /*
+     * Checks every packet table entry against the data chunk, and the
+     * packet table totals against the pakt header; describes each problem
+     * found in problems.
+     */
+    void check_structure(std::vector<std::string> *problems) const;
 
+    /* info chunk entries as stored in the file */
+    const tags_t &tags() const
+    {
+        return m_tags;
+    }
+    void set_tags(const tags_t &tags, abort_callback &abort);
+    /* whether set_tags() can keep info ahead of the audio data */
+    bool tags_fit_before_data(const tags_t &tags, abort_callback &abort);
+    /*
+     * writes a copy of the file to dst with the given tags, laid out so
+     * that all metadata precedes the audio data
+     */
+    void rewrite(IByteSource *dst, const tags_t &tags,
+                 abort_callback &abort);
+
+    /* whether the file has an overview that is up to date with the data */
+    bool has_overview() const
+    {
+        return m_overview.frames_per_point
+            && m_overview.edit_count == m_data_edit_count;
+    }
+    const Overview &overview() const
+    {
+        return m_overview;
+    }
+    /*
+     * Lowest and highest value of the channel (in decoder output order)
+     * over count frames from first, on the same timeline as duration();
+     * the range is widened to whole overview points. Returns false when
+     * there is no usable overview.
+     */
+    bool overview_range(unsigned channel, int64_t first, int64_t count,
+                        int16_t *min_value, int16_t *max_value) const;
+    /*
+     * Stores an overview (edit_count is filled in) in free space ahead
+     * of the audio data when there is enough, or at the end otherwise.
+     */
+    void set_overview(const Overview &overview, abort_callback &abort);
+
+    /* whether the file has per-channel peaks up to date with the data */
+    bool has_peaks() const
+    {
+        return m_peaks.size() == m_primary_format.asbd.mChannelsPerFrame
+            && m_peak_edit_count == m_data_edit_count;
+    }
+    /* in file (coded) channel order */
+    const std::vector<Peak> &peaks() const
+    {
+        return m_peaks;
+    }
+    /* stored like set_overview() */
+    void set_peaks(const std::vector<Peak> &peaks, abort_callback &abort);
+#ifndef CAF_PORTABLE
     void get_metadata(file_info &info)
     {
         Metadata::get_entries(&info, m_tags);
     }
-    void set_metadata(const file_info &info, abort_callback &abort);
+    void set_metadata(const file_info &info, abort_callback &abort)
+    {
+        tags_t tags;
+        Metadata::put_entries(&tags, info);
+        set_tags(tags, abort);
+    }
+#endif
     /*
      * update format with analyzed information from the decoder.
      */
@@ -112,18 +247,34 @@ private:
             return format().asbd.mSampleRate
                     / m_primary_format.asbd.mSampleRate;
     }
-    void parse(abort_callback &abort);
+    void parse(size_t probe_size, abort_callback &abort);
     void parse_desc(Format *d,    abort_callback &abort);
     void parse_chan(Format *d,    abort_callback &abort);
     void parse_ldsc(int64_t size, abort_callback &abort);
     void parse_kuki(int64_t size, abort_callback &abort);
     void parse_info(int64_t size, abort_callback &abort);
     void parse_pakt(int64_t size, abort_callback &abort);
+    void parse_ovvw(int64_t size, abort_callback &abort);
+    void parse_peak(int64_t size, abort_callback &abort);
     void calc_duration();
     void parse_channel_layout_tag(Format *d, uint32_t tag);
     void parse_channels(Format *d, const std::vector<char> &channels);
-    int64_t find_room_for_info(t_filesize *room_pos, t_filesize *info_pos,
-                               abort_callback &abort);
+    static void serialize_info(const tags_t &tags,
+                               std::vector<uint8_t> *buf);
+    /* free chunk filling up room bytes after a chunk of len bytes */
+    static void serialize_free(int64_t room, int64_t len, int64_t pad,
+                               std::vector<uint8_t> *buf);
+    /*
+     * largest run of free and fcc chunks, payload size (as if it were a
+     * single chunk) is returned
+     */
+    int64_t find_room(uint32_t fcc, t_filesize *room_pos,
+                      t_filesize *old_pos, abort_callback &abort);
+    /*
+     * writes the fcc chunk serialized in m_write_buffer into room, or
+     * appends it with pad bytes of slack, and frees the old one
+     */
+    void store_chunk(uint32_t fcc, int64_t pad, abort_callback &abort);
 };
 
 #endif
@@ -0,0 +1,283 @@
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include "CAFWriter.h"
+
+namespace {
+    const uint32_t ALIGNMENT = 4096;
+
+    void put_bendian(uint64_t v, unsigned n, std::vector<uint8_t> *buf)
+    {
+        for (unsigned i = n; i-- > 0; )
+            buf->push_back(static_cast<uint8_t>(v >> (8 * i)));
+    }
+
+    void put_ber_integer(uint32_t v, std::vector<uint8_t> *buf)
+    {
+        unsigned n = 1;
+        while (n < 5 && v >> (7 * n))
+            ++n;
+        while (n-- > 0)
+            buf->push_back(static_cast<uint8_t>((v >> (7 * n) & 0x7f)
+                                                | (n ? 0x80 : 0)));
+    }
+
+    void put_chunk_header(uint32_t fcc, int64_t size,
+                          std::vector<uint8_t> *buf)
+    {
+        put_bendian(fcc, 4, buf);
+        put_bendian(size, 8, buf);
+    }
+
+    void serialize_chan(const CAFFile::Format &format,
+                        std::vector<uint8_t> *buf)
+    {
+        uint32_t mask     = format.channel_mask;
+        unsigned channels = format.asbd.mChannelsPerFrame;
+        if (!mask || Helpers::bitcount(mask) != channels)
+            return;
+        const std::vector<char> &map = format.channel_map;
+        bool in_order = true;
+        for (size_t i = 0; i < map.size(); ++i)
+            if (map[i] != static_cast<char>(i))
+                in_order = false;
+        if (in_order) {
+            put_chunk_header(FOURCC('c','h','a','n'), 12, buf);
+            put_bendian(kAudioChannelLayoutTag_UseChannelBitmap, 4, buf);
+            put_bendian(mask, 4, buf);
+            put_bendian(0, 4, buf);
+            return;
+        }
+        /* output i (i-th bit of mask) comes from coded channel map[i] */
+        std::vector<uint32_t> labels(channels);
+        for (unsigned i = 0, bit = 0; i < channels; ++i, ++bit) {
+            while (!(mask >> bit & 1))
+                ++bit;
+            labels[static_cast<uint8_t>(map[i])] = bit + 1;
+        }
+        /*
+         * LS/RS are read as side channels unless there are side channels,
+         * so back channels alone have to be labelled as rear surround.
+         */
+        bool has_side = mask & (3 << 9);
+        for (unsigned c = 0; c < channels; ++c) {
+            if (!has_side && labels[c] == kAudioChannelLabel_LeftSurround)
+                labels[c] = kAudioChannelLabel_RearSurroundLeft;
+            if (!has_side && labels[c] == kAudioChannelLabel_RightSurround)
+                labels[c] = kAudioChannelLabel_RearSurroundRight;
+        }
+        put_chunk_header(FOURCC('c','h','a','n'), 12 + 20 * channels, buf);
+        put_bendian(kAudioChannelLayoutTag_UseChannelDescriptions, 4, buf);
+        put_bendian(0, 4, buf);
+        put_bendian(channels, 4, buf);
+        for (unsigned c = 0; c < channels; ++c) {
+            put_bendian(labels[c], 4, buf);
+            buf->resize(buf->size() + 16); /* flags, coordinates */
+        }
+    }
+}
+
+CAFWriter::CAFWriter(const std::shared_ptr<IByteSource> &dst,
+                     const CAFFile::Format &format,
+                     const std::vector<uint8_t> &cookie,
+                     const CAFFile::tags_t &tags, abort_callback &abort,
+                     const Options &options)
+    : m_dst(dst), m_asbd(format.asbd), m_options(options), m_room_pos(0),
+      m_data_pos(0), m_data_size(0), m_synced_size(0), m_packets(0),
+      m_frames(0), m_finalized(false)
+{
+    if (!m_asbd.mChannelsPerFrame || !m_asbd.mSampleRate)
+        throw std::runtime_error("invalid format");
+
+    std::vector<uint8_t> buf;
+    put_bendian(FOURCC('c','a','f','f'), 4, &buf);
+    put_bendian(1, 2, &buf);
+    put_bendian(0, 2, &buf);
+
+    uint64_t rate;
+    std::memcpy(&rate, &m_asbd.mSampleRate, 8);
+    put_chunk_header(FOURCC('d','e','s','c'), 32, &buf);
+    put_bendian(rate,                     8, &buf);
+    put_bendian(m_asbd.mFormatID,         4, &buf);
+    put_bendian(m_asbd.mFormatFlags,      4, &buf);
+    put_bendian(m_asbd.mBytesPerPacket,   4, &buf);
+    put_bendian(m_asbd.mFramesPerPacket,  4, &buf);
+    put_bendian(m_asbd.mChannelsPerFrame, 4, &buf);
+    put_bendian(m_asbd.mBitsPerChannel,   4, &buf);
+
+    serialize_chan(format, &buf);
+    if (cookie.size()) {
+        put_chunk_header(FOURCC('k','u','k','i'), cookie.size(), &buf);
+        buf.insert(buf.end(), cookie.begin(), cookie.end());
+    }
+    if (tags.size()) {
+        put_chunk_header(FOURCC('i','n','f','o'), tags.info_size(), &buf);
+        put_bendian(tags.size(), 4, &buf);
+        tags.serialize(&buf);
+    }
+    /* rounded up for the audio data to start at a block boundary */
+    m_room_pos = buf.size();
+    m_options.reserve += (ALIGNMENT - (m_room_pos + 12 + m_options.reserve
+                                       + 16) % ALIGNMENT) % ALIGNMENT;
+    put_chunk_header(FOURCC('f','r','e','e'), m_options.reserve, &buf);
+    buf.resize(buf.size() + m_options.reserve);
+
+    m_data_pos = buf.size();
+    put_chunk_header(FOURCC('d','a','t','a'),
+                     m_options.crash_safe ? -1 : 4, &buf);
+    put_bendian(0, 4, &buf); /* edit count */
+
+    m_dst->seek(0, abort);
+    m_dst->write(buf.data(), buf.size(), abort);
+    m_buffer.reserve(m_options.buffer_size);
+    if (m_options.crash_safe)
+        m_dst->sync();
+}
+
+void CAFWriter::write(const void *data, size_t bytes, abort_callback &abort)
+{
+    if (is_vbr())
+        throw std::logic_error("CAFWriter: packet sizes are needed");
+    if (bytes % m_asbd.mBytesPerPacket)
+        throw std::runtime_error("CAFWriter: partial packet");
+    int64_t n = bytes / m_asbd.mBytesPerPacket;
+    m_packets += n;
+    m_frames  += n * m_asbd.mFramesPerPacket;
+    append(data, bytes, abort);
+}
+
+void CAFWriter::write_packets(const void *data, const uint32_t *sizes,
+                              size_t count, abort_callback &abort,
+                              const uint32_t *frames)
+{
+    if (!m_asbd.mFramesPerPacket && !frames)
+        throw std::logic_error("CAFWriter: packet frames are needed");
+    size_t bytes = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (m_asbd.mBytesPerPacket && sizes[i] != m_asbd.mBytesPerPacket)
+            throw std::runtime_error("CAFWriter: invalid packet size");
+        if (!m_asbd.mBytesPerPacket)
+            put_ber_integer(sizes[i], &m_table);
+        if (!m_asbd.mFramesPerPacket)
+            put_ber_integer(frames[i], &m_table);
+        m_frames += m_asbd.mFramesPerPacket ? m_asbd.mFramesPerPacket
+                                            : frames[i];
+        bytes += sizes[i];
+    }
+    m_packets += count;
+    append(data, bytes, abort);
+}
+
+void CAFWriter::append(const void *data, size_t bytes, abort_callback &abort)
+{
+    if (m_finalized)
+        throw std::logic_error("CAFWriter: already finalized");
+    if (m_buffer.size() + bytes > m_options.buffer_size)
+        flush_buffer(abort);
+    /* large blocks skip the copy */
+    if (bytes >= m_options.buffer_size) {
+        m_dst->write(data, bytes, abort);
+    } else {
+        const uint8_t *p = static_cast<const uint8_t *>(data);
+        m_buffer.insert(m_buffer.end(), p, p + bytes);
+    }
+    m_data_size += bytes;
+    if (m_options.crash_safe
+     && m_data_size - m_synced_size >= m_options.flush_interval)
+        checkpoint(abort);
+}
+
+void CAFWriter::flush_buffer(abort_callback &abort)
+{
+    if (m_buffer.size())
+        m_dst->write(m_buffer.data(), m_buffer.size(), abort);
+    m_buffer.clear();
+}
+
+void CAFWriter::checkpoint(abort_callback &abort)
+{
+    flush_buffer(abort);
+    /*
+     * A table too large for the room leaves the previous one there, which
+     * still describes a prefix of the data.
+     */
+    if (is_vbr()) {
+        AudioFilePacketTableInfo info = { m_frames, 0, 0 };
+        std::vector<uint8_t> buf;
+        serialize_pakt(info, &buf);
+        t_filesize end = m_dst->get_position(abort);
+        store_in_room(buf, abort);
+        m_dst->seek(end, abort);
+    }
+    m_dst->sync();
+    m_synced_size = m_data_size;
+}
+
+void CAFWriter::serialize_pakt(const AudioFilePacketTableInfo &info,
+                               std::vector<uint8_t> *buf) const
+{
+    buf->reserve(buf->size() + 36 + m_table.size());
+    put_chunk_header(FOURCC('p','a','k','t'), 24 + m_table.size(), buf);
+    put_bendian(m_packets,                 8, buf);
+    put_bendian(info.mNumberValidFrames,   8, buf);
+    put_bendian(info.mPrimingFrames,       4, buf);
+    put_bendian(info.mRemainderFrames,     4, buf);
+    buf->insert(buf->end(), m_table.begin(), m_table.end());
+}
+
+bool CAFWriter::store_in_room(const std::vector<uint8_t> &buf,
+                              abort_callback &abort)
+{
+    int64_t room = 12 + m_options.reserve;
+    int64_t len  = buf.size();
+    if (len != room && len > room - 12)
+        return false;
+    std::vector<uint8_t> chunk(buf);
+    if (len < room)
+        put_chunk_header(FOURCC('f','r','e','e'), room - len - 12, &chunk);
+    m_dst->seek(m_room_pos, abort);
+    m_dst->write(chunk.data(), chunk.size(), abort);
+    return true;
+}
+
+void CAFWriter::finalize(const AudioFilePacketTableInfo &info,
+                         abort_callback &abort)
+{
+    if (m_finalized)
+        return;
+    flush_buffer(abort);
+    t_filesize end = m_data_pos + 16 + m_data_size;
+
+    AudioFilePacketTableInfo pinfo = info;
+    if (!pinfo.mNumberValidFrames)
+        pinfo.mNumberValidFrames = m_frames - pinfo.mPrimingFrames
+                                 - pinfo.mRemainderFrames;
+    if (pinfo.mNumberValidFrames < 0)
+        throw std::runtime_error("CAFWriter: invalid packet table info");
+
+    /* sized first, so that a table appended later is not taken as data */
+    std::vector<uint8_t> buf;
+    put_bendian(m_data_size + 4, 8, &buf);
+    m_dst->seek(m_data_pos + 4, abort);
+    m_dst->write(buf.data(), buf.size(), abort);
+
+    buf.clear();
+    if (is_vbr() || pinfo.mPrimingFrames || pinfo.mRemainderFrames)
+        serialize_pakt(pinfo, &buf);
+    if (buf.size() && !store_in_room(buf, abort)) {
+        m_dst->seek(end, abort);
+        m_dst->write(buf.data(), buf.size(), abort);
+        /* drop a table a checkpoint may have left in the room */
+        if (m_options.crash_safe) {
+            buf.clear();
+            put_chunk_header(FOURCC('f','r','e','e'), m_options.reserve,
+                             &buf);
+            m_dst->seek(m_room_pos, abort);
+            m_dst->write(buf.data(), buf.size(), abort);
+        }
+    }
+    m_dst->seek(end, abort);
+    if (m_options.crash_safe)
+        m_dst->sync();
+    m_finalized = true;
+}
@@ -0,0 +1,94 @@
+#ifndef CAFWRITER_H
+#define CAFWRITER_H
+
+#include "CAFFile.h"
+
+/*
+ * Writes a CAF file front to back, without seeking around in the audio
+ * data: desc, chan, kuki and info are written up front, followed by a
+ * free chunk of reserved room and the data chunk, which is then streamed
+ * through a write buffer. The packet table is kept in memory BER encoded
+ * (a few bytes per packet) and written by finalize(), into the reserved
+ * room when it fits and after the data otherwise.
+ *
+ * In crash-safe mode the data chunk is sized -1 (up to the end of the
+ * file) until finalize(), and every flush_interval bytes of data the
+ * buffer and the packet table so far are written out and synced, so that
+ * an interrupted file plays up to the last flush. With variable packet
+ * sizes, that takes a reserve large enough for the packet table.
+ */
+class CAFWriter {
+public:
+    struct Options {
+        uint32_t reserve;          /* minimum room ahead of the data */
+        uint32_t buffer_size;
+        bool     crash_safe;
+        uint64_t flush_interval;   /* bytes of data, crash-safe mode */
+
+        Options(): reserve(65536), buffer_size(1 << 20), crash_safe(false),
+                   flush_interval(16 << 20) {}
+    };
+private:
+    std::shared_ptr<IByteSource> m_dst;
+    AudioStreamBasicDescription  m_asbd;
+    Options                      m_options;
+    t_filesize                   m_room_pos;
+    t_filesize                   m_data_pos;     /* data chunk header */
+    uint64_t                     m_data_size;
+    uint64_t                     m_synced_size;
+    int64_t                      m_packets;
+    int64_t                      m_frames;
+    std::vector<uint8_t>         m_table;        /* pakt entries */
+    std::vector<uint8_t>         m_buffer;
+    bool                         m_finalized;
+public:
+    /*
+     * format.channel_map, when not in order, is written out as channel
+     * descriptions; cookie is stored as is.
+     */
+    CAFWriter(const std::shared_ptr<IByteSource> &dst,
+              const CAFFile::Format &format,
+              const std::vector<uint8_t> &cookie,
+              const CAFFile::tags_t &tags, abort_callback &abort,
+              const Options &options=Options());
+
+    /* whole packets of a format with constant bytes per packet */
+    void write(const void *data, size_t bytes, abort_callback &abort);
+    /*
+     * count packets of sizes[i] bytes, back to back in data; frames[] is
+     * needed when the format has variable frames per packet
+     */
+    void write_packets(const void *data, const uint32_t *sizes,
+                       size_t count, abort_callback &abort,
+                       const uint32_t *frames=0);
+    /*
+     * Completes the file. mNumberValidFrames is derived from the packets
+     * written when zero; a pakt chunk is written when the format has
+     * variable packets or info has priming or remainder frames.
+     */
+    void finalize(const AudioFilePacketTableInfo &info,
+                  abort_callback &abort);
+
+    int64_t num_packets() const { return m_packets; }
+    int64_t num_frames() const { return m_frames; }
+    uint64_t data_size() const { return m_data_size; }
+private:
+    CAFWriter(const CAFWriter &);
+    CAFWriter& operator=(const CAFWriter &);
+
+    bool is_vbr() const
+    {
+        return !m_asbd.mBytesPerPacket || !m_asbd.mFramesPerPacket;
+    }
+    void append(const void *data, size_t bytes, abort_callback &abort);
+    void flush_buffer(abort_callback &abort);
+    /* crash-safe mode: writes out everything so far and syncs */
+    void checkpoint(abort_callback &abort);
+    void serialize_pakt(const AudioFilePacketTableInfo &info,
+                        std::vector<uint8_t> *buf) const;
+    /* writes buf (a chunk) into the reserved room, if it fits */
+    bool store_in_room(const std::vector<uint8_t> &buf,
+                       abort_callback &abort);
+};
+
+#endif
@@ -0,0 +1,119 @@
+#include "../SDK/foobar2000-winver.h"
+#include "../SDK/foobar2000.h"
+#include "Config.h"
+
+namespace {
+    // {CFFFD3ED-56BA-4D32-BDCE-CA59524723FD}
+    const GUID guid_branch = { 0xcfffd3ed, 0x56ba, 0x4d32,{ 0xbd, 0xce, 0xca, 0x59, 0x52, 0x47, 0x23, 0xfd } };
+    // {85A2486A-A4A4-427F-9C8C-68B81BC28CA3}
+    const GUID guid_decode_ahead = { 0x85a2486a, 0xa4a4, 0x427f,{ 0x9c, 0x8c, 0x68, 0xb8, 0x1b, 0xc2, 0x8c, 0xa3 } };
+    // {18644C83-37C6-4284-A302-AA6260C7AA86}
+    const GUID guid_decode_ahead_depth = { 0x18644c83, 0x37c6, 0x4284,{ 0xa3, 0x2, 0xaa, 0x62, 0x60, 0xc7, 0xaa, 0x86 } };
+    // {9A95D862-828C-45CB-99EB-12C02D6E0D14}
+    const GUID guid_perf_report = { 0x9a95d862, 0x828c, 0x45cb,{ 0x99, 0xeb, 0x12, 0xc0, 0x2d, 0x6e, 0xd, 0x14 } };
+    // {6CD4AE2C-36E7-44E6-9816-7E8DA6EE5882}
+    const GUID guid_trace_file = { 0x6cd4ae2c, 0x36e7, 0x44e6,{ 0x98, 0x16, 0x7e, 0x8d, 0xa6, 0xee, 0x58, 0x82 } };
+    // {2EB26A19-CC0B-490F-AE0B-64F49EC7E9DD}
+    const GUID guid_relocate_tags = { 0x2eb26a19, 0xcc0b, 0x490f,{ 0xae, 0xb, 0x64, 0xf4, 0x9e, 0xc7, 0xe9, 0xdd } };
+    // {CD4AB642-715D-4F0E-A090-87195FD04FEE}
+    const GUID guid_probe_size = { 0xcd4ab642, 0x715d, 0x4f0e,{ 0xa0, 0x90, 0x87, 0x19, 0x5f, 0xd0, 0x4f, 0xee } };
+    // {9D9F8058-6BE5-40AC-815E-31A6AD3958A8}
+    const GUID guid_stereo_downmix = { 0x9d9f8058, 0x6be5, 0x40ac,{ 0x81, 0x5e, 0x31, 0xa6, 0xad, 0x39, 0x58, 0xa8 } };
+    // {280B65F8-6DCF-4F1D-96BC-BFEF8E67C984}
+    const GUID guid_extract_channels = { 0x280b65f8, 0x6dcf, 0x4f1d,{ 0x96, 0xbc, 0xbf, 0xef, 0x8e, 0x67, 0xc9, 0x84 } };
+    // {B9FACA12-1574-451E-8C96-ADB7EB50D84D}
+    const GUID guid_store_peaks = { 0xb9faca12, 0x1574, 0x451e,{ 0x8c, 0x96, 0xad, 0xb7, 0xeb, 0x50, 0xd8, 0x4d } };
+    // {16D04FBA-215E-466D-BD37-183277BF1202}
+    const GUID guid_store_pcm_hash = { 0x16d04fba, 0x215e, 0x466d,{ 0xbd, 0x37, 0x18, 0x32, 0x77, 0xbf, 0x12, 0x2 } };
+    // {7401F0E3-B180-4C31-AC43-D7DC7E558756}
+    const GUID guid_aac_core_only = { 0x7401f0e3, 0xb180, 0x4c31,{ 0xac, 0x43, 0xd7, 0xdc, 0x7e, 0x55, 0x87, 0x56 } };
+
+    advconfig_branch_factory g_branch("CAF Decoder", guid_branch,
+                                      advconfig_branch::guid_branch_decoding,
+                                      0);
+    advconfig_checkbox_factory g_decode_ahead(
+        "Decode ahead on a background thread during playback",
+        guid_decode_ahead, guid_branch, 0, false);
+    advconfig_integer_factory g_decode_ahead_depth(
+        "Decode ahead depth (chunks)",
+        guid_decode_ahead_depth, guid_branch, 1, 8, 2, 256);
+    advconfig_checkbox_factory g_perf_report(
+        "Log performance counters to the console on close (debug)",
+        guid_perf_report, guid_branch, 2, false);
+    advconfig_string_factory g_trace_file(
+        "Write Chrome trace events to this file (debug, empty = off)",
+        guid_trace_file, guid_branch, 3, "");
+    advconfig_checkbox_factory g_relocate_tags(
+        "Rewrite the file to keep tags ahead of the audio data when they "
+        "don't fit",
+        guid_relocate_tags, guid_branch, 4, false);
+    advconfig_integer_factory g_probe_size(
+        "Header read size (KB)",
+        guid_probe_size, guid_branch, 5, 64, 4, 4096);
+    advconfig_checkbox_factory g_stereo_downmix(
+        "Downmix multichannel PCM to stereo",
+        guid_stereo_downmix, guid_branch, 6, false);
+    advconfig_string_factory g_extract_channels(
+        "Extract only these PCM channels (e.g. 1-4,7 or FL,FR; empty = all)",
+        guid_extract_channels, guid_branch, 7, "");
+    advconfig_checkbox_factory g_store_peaks(
+        "Store channel peaks (peak chunk) when writing tags",
+        guid_store_peaks, guid_branch, 8, false);
+    advconfig_checkbox_factory g_store_pcm_hash(
+        "Store a hash of the decoded audio when writing tags",
+        guid_store_pcm_hash, guid_branch, 9, false);
+    advconfig_checkbox_factory g_aac_core_only(
+        "Play HE-AAC as its AAC-LC core only (less CPU, half sample rate)",
+        guid_aac_core_only, guid_branch, 10, false);
+}
+
+namespace Config {
+    bool decode_ahead()
+    {
+        return g_decode_ahead.get();
+    }
+    unsigned decode_ahead_depth()
+    {
+        return static_cast<unsigned>(g_decode_ahead_depth.get());
+    }
+    bool perf_report()
+    {
+        return g_perf_report.get();
+    }
+    std::string trace_file()
+    {
+        pfc::string8 path;
+        g_trace_file.get(path);
+        return path.get_ptr();
+    }
+    bool relocate_tags()
+    {
+        return g_relocate_tags.get();
+    }
+    size_t probe_size()
+    {
+        return static_cast<size_t>(g_probe_size.get()) * 1024;
+    }
+    bool stereo_downmix()
+    {
+        return g_stereo_downmix.get();
+    }
+    std::string extract_channels()
+    {
+        pfc::string8 spec;
+        g_extract_channels.get(spec);
+        return spec.get_ptr();
+    }
+    bool store_peaks()
+    {
+        return g_store_peaks.get();
+    }
+    bool store_pcm_hash()
+    {
+        return g_store_pcm_hash.get();
+    }
+    bool aac_core_only()
+    {
+        return g_aac_core_only.get();
+    }
+}
@@ -0,0 +1,31 @@
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#include <cstddef>
+#include <string>
+
+/*
+ * Settings exposed under Preferences > Advanced > Decoding > CAF Decoder.
+ */
+namespace Config {
+    bool     decode_ahead();
+    unsigned decode_ahead_depth();
+    bool     perf_report();
+    /* Chrome trace output, empty when tracing is off */
+    std::string trace_file();
+    /* rewrite the whole file rather than append tags after the data */
+    bool        relocate_tags();
+    /* bytes fetched at once when parsing headers */
+    size_t      probe_size();
+    bool        stereo_downmix();
+    /* channel selection for IDecoder::Options, empty for all */
+    std::string extract_channels();
+    /* scan and store a peak chunk on retag when there is no valid one */
+    bool        store_peaks();
+    /* hash the decoded audio into a tag on retag when there is none */
+    bool        store_pcm_hash();
+    /* HE-AAC playback: decode the AAC-LC core only, at its sample rate */
+    bool        aac_core_only();
+}
+
+#endif
@@ -1,18 +1,20 @@
 #ifndef __MACTYPES__
 #define __MACTYPES__
 
+#include <stdint.h>
+
 typedef unsigned char      UInt8;
 typedef signed char        SInt8;
 typedef unsigned short     UInt16;
 typedef signed short       SInt16;
-typedef unsigned long      UInt32;
-typedef signed long        SInt32;
+typedef uint32_t           UInt32;
+typedef int32_t            SInt32;
 typedef signed long long   SInt64;
 typedef unsigned long long UInt64;
 typedef float              Float32;
 typedef double             Float64;
 
-typedef unsigned long      FourCharCode;
+typedef UInt32             FourCharCode;
 typedef SInt32             OSStatus;
 typedef FourCharCode       OSType;
 typedef unsigned char      Boolean;
@@ -0,0 +1,91 @@
+#include <chrono>
+#include "DecodeAhead.h"
+
+namespace {
+    /* spin briefly, then sleep; both sides of the ring wait this way */
+    void backoff(unsigned *spins)
+    {
+        if (++*spins < 64)
+            std::this_thread::yield();
+        else
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+void DecodeAhead::start()
+{
+    stop();
+    m_finished = false;
+    m_thread = std::thread(&DecodeAhead::run, this);
+}
+
+void DecodeAhead::stop()
+{
+    if (m_thread.joinable()) {
+        m_abort.abort();
+        m_thread.join();
+        m_abort.reset();
+    }
+    m_ring.clear();
+}
+
+bool DecodeAhead::pop(audio_chunk &chunk, int64_t *pre_packet,
+                      int64_t *cur_packet, abort_callback &abort)
+{
+    if (m_finished)
+        return false;
+    Slot *slot;
+    unsigned spins = 0;
+    while (!(slot = m_ring.read_slot())) {
+        abort.check();
+        backoff(&spins);
+    }
+    if (slot->error) {
+        std::exception_ptr error = slot->error;
+        slot->error = std::exception_ptr();
+        m_ring.release();
+        m_finished = true;
+        std::rethrow_exception(error);
+    }
+    bool more = slot->more;
+    if (more) {
+        const audio_chunk &src = slot->chunk;
+        chunk.set_data(src.get_data(), src.get_sample_count(),
+                       src.get_channels(), src.get_srate(),
+                       src.get_channel_config());
+        *pre_packet = slot->pre_packet;
+        *cur_packet = slot->cur_packet;
+    } else {
+        m_finished = true;
+    }
+    m_ring.release();
+    return more;
+}
+
+void DecodeAhead::run()
+{
+    for (;;) {
+        Slot *slot;
+        unsigned spins = 0;
+        while (!(slot = m_ring.write_slot())) {
+            if (m_abort.is_aborting())
+                return;
+            backoff(&spins);
+        }
+        /* a slot dropped by stop() may still hold an error */
+        slot->error = std::exception_ptr();
+        try {
+            slot->more = m_producer(slot, m_abort);
+        } catch (exception_aborted &) {
+            return;
+        } catch (...) {
+            if (m_abort.is_aborting())
+                return;
+            slot->more  = false;
+            slot->error = std::current_exception();
+        }
+        m_ring.publish();
+        if (!slot->more)
+            return;
+    }
+}
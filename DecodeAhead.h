@@ -0,0 +1,50 @@
+#ifndef DECODEAHEAD_H
+#define DECODEAHEAD_H
+
+#include <exception>
+#include <functional>
+#include <thread>
+#include "Portable.h"
+#include "SPSCRing.h"
+
+/*
+ * Runs a decode loop on a worker thread, a fixed number of chunks ahead
+ * of the consumer.
+ */
+class DecodeAhead {
+public:
+    struct Slot {
+        audio_chunk_impl   chunk;
+        int64_t            pre_packet;
+        int64_t            cur_packet;
+        bool               more;
+        std::exception_ptr error;
+        Slot(): pre_packet(0), cur_packet(0), more(false) {}
+    };
+    /* fills the slot; returns false at end of stream */
+    typedef std::function<bool(Slot *, abort_callback &)> producer_t;
+private:
+    producer_t          m_producer;
+    SPSCRing<Slot>      m_ring;
+    std::thread         m_thread;
+    abort_callback_impl m_abort;
+    bool                m_finished;
+public:
+    DecodeAhead(const producer_t &producer, unsigned depth)
+        : m_producer(producer), m_ring(depth), m_finished(false)
+    {}
+    ~DecodeAhead() { stop(); }
+    void start();
+    /* aborts the worker and drops whatever it has decoded */
+    void stop();
+    /* returns false at end of stream */
+    bool pop(audio_chunk &chunk, int64_t *pre_packet, int64_t *cur_packet,
+             abort_callback &abort);
+private:
+    DecodeAhead(const DecodeAhead &);
+    DecodeAhead& operator=(const DecodeAhead &);
+
+    void run();
+};
+
+#endif
@@ -1,14 +1,111 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
 #include <iterator>
+#ifndef CAF_PORTABLE
 #include <winsock2.h>
 #define NOMINMAX
 #include <windows.h>
 #include <mmreg.h>
+#endif
 #include "Decoder.h"
 #include "LPCMDecoder.h"
+#include "SampleStore.h"
 #include "IMA4Decoder.h"
+#include "MSADPCMDecoder.h"
+#include "IMAADPCMDecoder.h"
+#include "ALACDecoder.h"
+#include "Trace.h"
+#ifndef CAF_PORTABLE
 #include "PacketDecoder.h"
+#include "BitReader.h"
 
 namespace {
+    /*
+     * AudioSpecificConfig of the AAC-LC core of asc, whether SBR is
+     * signaled hierarchically (object type 5 or 29), backward compatibly
+     * (sync extension after the core config) or not at all. SBR is
+     * explicitly signaled absent in it, so that decoders don't go looking
+     * for it in the bitstream. False when there is no AAC-LC core to
+     * describe this way (escaped object types, a program config element).
+     */
+    bool aac_core_config(const std::vector<uint8_t> &asc,
+                         std::vector<uint8_t> *core, uint32_t *rate,
+                         unsigned *channels)
+    {
+        static const uint32_t rates[] = {
+            96000, 88200, 64000, 48000, 44100, 32000, 24000, 22050,
+            16000, 12000, 11025, 8000, 7350
+        };
+        static const unsigned config_channels[] = { 0, 1, 2, 3, 4, 5, 6, 8 };
+
+        std::vector<uint8_t> buf(asc);
+        buf.resize(asc.size() + BitReader::PADDING);
+        BitReader bits(buf.data(), asc.size());
+        unsigned aot = bits.read(5);
+        unsigned sfi = bits.read(4);
+        uint32_t explicit_rate = sfi == 15 ? bits.read(24) : 0;
+        unsigned config = bits.read(4);
+        if (aot == 5 || aot == 29) {
+            if (bits.read(4) == 15) /* extension sampling frequency */
+                bits.skip(24);
+            aot = bits.read(5);
+        }
+        unsigned frame_length_flag = bits.read(1);
+        if (bits.overrun() || aot != 2 || !config || config > 7
+         || (sfi > 12 && sfi != 15))
+            return false;
+        *rate     = sfi == 15 ? explicit_rate : rates[sfi];
+        *channels = config_channels[config];
+
+        uint64_t v = 0;
+        unsigned n = 0;
+        auto put = [&](uint32_t value, unsigned nbits) {
+            v = v << nbits | value;
+            n += nbits;
+        };
+        put(2, 5);                   /* AAC LC */
+        put(sfi, 4);
+        if (sfi == 15)
+            put(explicit_rate, 24);
+        put(config, 4);
+        put(frame_length_flag, 1);
+        put(0, 2);                   /* dependsOnCoreCoder, extensionFlag */
+        put(0x2b7, 11);              /* syncExtensionType */
+        put(5, 5);                   /* SBR */
+        put(0, 1);                   /* sbrPresentFlag */
+        put(0, (8 - n % 8) % 8);
+        core->clear();
+        for (; n; n -= 8)
+            core->push_back(static_cast<uint8_t>(v >> (n - 8)));
+        return true;
+    }
+    /*
+     * Options::aac_core_only: replaces asc with that of the core, and
+     * the demuxer's format with the core's, so that timing and trimming
+     * work at its rate. Left alone when there is no usable core.
+     */
+    void select_aac_core(std::shared_ptr<CAFFile> &demuxer,
+                         std::vector<uint8_t> *asc)
+    {
+        std::vector<uint8_t> core;
+        uint32_t rate;
+        unsigned channels;
+        if (!aac_core_config(*asc, &core, &rate, &channels))
+            return;
+        asc->swap(core);
+        auto asbd = demuxer->format().asbd;
+        if (asbd.mFormatID != FOURCC('a','a','c',' ')
+         || asbd.mSampleRate != rate || asbd.mChannelsPerFrame != channels) {
+            asbd.mFramesPerPacket = asbd.mFramesPerPacket * rate
+                                  / asbd.mSampleRate + .5;
+            asbd.mFormatID         = FOURCC('a','a','c',' ');
+            asbd.mSampleRate       = rate;
+            asbd.mChannelsPerFrame = channels;
+            demuxer->update_format(asbd);
+        }
+    }
     void check_aac_analyzed_info(std::shared_ptr<CAFFile>  &demuxer,
                                  std::shared_ptr<IDecoder> &decoder)
     {
@@ -49,16 +146,19 @@ namespace {
         wformat->wSamplesPerBlock    = asbd.mFramesPerPacket;
     }
 }
+#endif
 
 std::shared_ptr<IDecoder>
 IDecoder::create_decoder(std::shared_ptr<CAFFile> &demuxer,
-                         abort_callback &abort)
+                         abort_callback &abort, const Options &options)
 {
+    TraceSpan span("IDecoder::create_decoder");
     auto asbd = demuxer->format().asbd;
     std::shared_ptr<IDecoder> decoder;
+#ifndef CAF_PORTABLE
     bool is_aac = false;
+#endif
 
-#define MP std::make_shared<PacketDecoder>
     switch (asbd.mFormatID) {
     case FOURCC('l','p','c','m'):
         decoder = std::make_shared<LPCMDecoder>(demuxer->format());
@@ -66,6 +166,21 @@ IDecoder::create_decoder(std::shared_ptr<CAFFile> &demuxer,
     case FOURCC('i','m','a','4'):
         decoder = std::make_shared<IMA4Decoder>(demuxer->format());
         break;
+    case FOURCC('m','s','\0','\x02'):
+        decoder = std::make_shared<MSADPCMDecoder>(demuxer->format());
+        break;
+    case FOURCC('m','s','\0','\x11'):
+        decoder = std::make_shared<IMAADPCMDecoder>(demuxer->format());
+        break;
+    case FOURCC('a','l','a','c'):
+        {
+            std::vector<uint8_t> cookie;
+            demuxer->get_magic_cookie(&cookie);
+            decoder = std::make_shared<ALACDecoder>(demuxer->format(), cookie);
+            break;
+        }
+#ifndef CAF_PORTABLE
+#define MP std::make_shared<PacketDecoder>
     case FOURCC('.','m','p','1'):
         decoder = MP(packet_decoder::owner_MP1, 0, nullptr, 0, abort);
         break;
@@ -78,15 +193,14 @@ IDecoder::create_decoder(std::shared_ptr<CAFFile> &demuxer,
     case FOURCC('a','a','c',' '):
     case FOURCC('a','a','c','h'):
     case FOURCC('a','a','c','p'):
-        is_aac = true;
-        /* FALLTHROUGH */
-    case FOURCC('a','l','a','c'):
         {
+            is_aac = true;
             std::vector<uint8_t> asc;
             demuxer->get_magic_cookie(&asc);
-            GUID owner = is_aac ? packet_decoder::owner_MP4
-                                : packet_decoder::owner_MP4_ALAC;
-            decoder = MP(owner, 0x40, asc.data(), asc.size(), abort);
+            if (options.aac_core_only)
+                select_aac_core(demuxer, &asc);
+            decoder = MP(packet_decoder::owner_MP4, 0x40, asc.data(),
+                         asc.size(), abort);
             break;
         }
     case FOURCC('f','l','a','c'):
@@ -98,12 +212,9 @@ IDecoder::create_decoder(std::shared_ptr<CAFFile> &demuxer,
         }
     case FOURCC('a','l','a','w'):
     case FOURCC('u','l','a','w'):
-    case FOURCC('m','s','\0','\x02'):
-    case FOURCC('m','s','\0','\x11'):
     case FOURCC('m','s','\0','1'):
         {
-            std::vector<uint8_t> vec(sizeof(ADPCMWAVEFORMAT)+
-                                     sizeof(ADPCMCOEFSET)*7);
+            std::vector<uint8_t> vec(sizeof(ADPCMWAVEFORMAT));
             ADPCMWAVEFORMAT *wformat =
                 reinterpret_cast<ADPCMWAVEFORMAT *>(vec.data());
             fill_waveformat(asbd, wformat);
@@ -119,29 +230,10 @@ IDecoder::create_decoder(std::shared_ptr<CAFFile> &demuxer,
                 wformat->wfx.wBitsPerSample = 8;
                 wformat->wfx.cbSize         = 0;
                 break;
-            case FOURCC('m','s','\0','\x11'):
-                wformat->wfx.wFormatTag     = 0x11;
-                wformat->wfx.wBitsPerSample = 4;
-                wformat->wfx.cbSize         = 2;
-                break;
             case FOURCC('m','s','\0','1'):
                 wformat->wfx.wFormatTag = 0x31;
                 wformat->wfx.cbSize     = 2;
                 break;
-            case FOURCC('m','s','\0','\x02'):
-                {
-                    wformat->wfx.wFormatTag     = 0x02;
-                    wformat->wfx.wBitsPerSample = 4;
-                    wformat->wfx.cbSize         = 32;
-                    wformat->wNumCoef           = 7;
-                    const short coef1[] = { 64, 128, 0, 48, 60, 115, 98 };
-                    const short coef2[] = { 0, -64, 0, 16, 0, -52, -58 };
-                    for (int i = 0; i < 7; ++i) {
-                        wformat->aCoef[i].iCoef1 = coef1[i] * 4;
-                        wformat->aCoef[i].iCoef2 = coef2[i] * 4;
-                    }
-                    break;
-                }
             }
             packet_decoder::matroska_setup setup = { 0 };
             setup.codec_id           = "A_MS/ACM";
@@ -154,18 +246,197 @@ IDecoder::create_decoder(std::shared_ptr<CAFFile> &demuxer,
                          sizeof(setup), abort);
             break;
         }
+#undef MP
+#endif
     default:
         throw std::runtime_error("audio codec not supported");
     }
-#undef MP
+    decoder->set_counters(&demuxer->counters());
+    decoder->set_options(options);
+    decoder->reserve(demuxer->max_packet_size());
     if (decoder->analyze_first_frame_supported()) {
+        TraceSpan span("analyze_first_frame");
         std::vector<uint8_t> tmp_buffer;
         demuxer->read_packets(0, 1, &tmp_buffer, abort);
         decoder->analyze_first_frame(tmp_buffer.data(),
                                      tmp_buffer.size(), abort);
     }
+#ifndef CAF_PORTABLE
     if (is_aac)
         check_aac_analyzed_info(demuxer, decoder);
+#endif
     return decoder;
 }
 
+void IDecoder::decode_skipping(const void *buffer, t_size bytes,
+                               size_t skip, audio_chunk &chunk,
+                               abort_callback &abort)
+{
+    decode(buffer, bytes, chunk, abort);
+    drop_frames(chunk, skip);
+}
+
+void IDecoder::drop_frames(audio_chunk &chunk, size_t nframes)
+{
+    size_t count = chunk.get_sample_count();
+    nframes = std::min(nframes, count);
+    if (!nframes)
+        return;
+    unsigned nchannels = chunk.get_channels();
+    audio_sample *bp = chunk.get_data();
+    std::memmove(bp, bp + nframes * nchannels,
+                 (count - nframes) * nchannels * sizeof(audio_sample));
+    chunk.set_sample_count(count - nframes);
+}
+
+bool IDecoder::is_intra_only_format(uint32_t format_id)
+{
+    /*
+     * Not ima4: the decoder keeps the full predictor across packets when
+     * the next header agrees with it, so output depends on what came
+     * before.
+     */
+    switch (format_id) {
+    case FOURCC('l','p','c','m'):
+    case FOURCC('m','s','\0','\x02'):
+    case FOURCC('m','s','\0','\x11'):
+    case FOURCC('a','l','a','c'):
+    case FOURCC('f','l','a','c'):
+        return true;
+    }
+    return false;
+}
+
+void IDecoder::decode_all(std::shared_ptr<CAFFile> &demuxer,
+                          abort_callback &abort,
+                          const std::function<void(const audio_chunk &)>
+                              &sink)
+{
+    auto decoder = create_decoder(demuxer, abort);
+    audio_chunk_impl     chunk;
+    std::vector<uint8_t> buffer;
+
+    /* same chunking as input_caf */
+    auto asbd = demuxer->format().asbd;
+    uint32_t packets_per_chunk = 1;
+    if (asbd.mBytesPerPacket > 0) {
+        while (packets_per_chunk * asbd.mBytesPerPacket < 4096)
+            packets_per_chunk <<= 1;
+    }
+    int64_t num_packets = demuxer->num_packets();
+    for (int64_t packet = 0; packet < num_packets; ) {
+        uint32_t n = demuxer->read_packets(packet, packets_per_chunk,
+                                           &buffer, abort);
+        if (!n)
+            break;
+        packet += n;
+        decoder->decode(buffer.data(), buffer.size(), chunk, abort);
+        sink(chunk);
+    }
+}
+
+namespace {
+    template <typename O>
+    void store(const audio_sample *src, size_t nframes, unsigned channels,
+               const IDecoder::Output &out)
+    {
+        typedef typename O::type T;
+        if (out.planar) {
+            for (unsigned ch = 0; ch < channels; ++ch) {
+                T *dp = static_cast<T *>(out.data[ch]) + out.offset;
+                for (size_t i = 0; i < nframes; ++i)
+                    dp[i] = O::from_float(src[i * channels + ch]);
+            }
+        } else {
+            T *dp = static_cast<T *>(out.data[0]) + out.offset * channels;
+            for (size_t i = 0; i < nframes * channels; ++i)
+                dp[i] = O::from_float(src[i]);
+        }
+    }
+}
+
+void IDecoder::store_samples(const audio_sample *src, size_t nframes,
+                             unsigned channels, const Output &out)
+{
+    switch (out.format) {
+    case FLOAT32:     store<SampleStore::Float32>  (src, nframes, channels,
+                                                    out); break;
+    case INT16:       store<SampleStore::Int16>    (src, nframes, channels,
+                                                    out); break;
+    case INT24_IN_32: store<SampleStore::Int24In32>(src, nframes, channels,
+                                                    out); break;
+    case INT32:       store<SampleStore::Int32>    (src, nframes, channels,
+                                                    out); break;
+    }
+}
+
+uint32_t DecoderBase::channel_config(const CAFFile::Format &format)
+{
+    uint32_t mask = format.channel_mask;
+    if (!mask)
+        mask = audio_chunk::g_guess_channel_config(
+                    format.asbd.mChannelsPerFrame);
+    return mask;
+}
+
+std::vector<unsigned>
+DecoderBase::channel_positions(const CAFFile::Format &format)
+{
+    unsigned nchannels = format.asbd.mChannelsPerFrame;
+    std::vector<unsigned> pos(nchannels);
+    for (unsigned i = 0; i < nchannels; ++i)
+        pos[i] = i;
+    /* channel_map[i] is the coded channel that goes to output i */
+    if (format.channel_map.size() == nchannels) {
+        for (unsigned i = 0; i < nchannels; ++i)
+            pos[format.channel_map[i]] = i;
+    }
+    return pos;
+}
+
+std::vector<unsigned>
+DecoderBase::parse_channel_selection(const CAFFile::Format &format,
+                                     const std::string &spec)
+{
+    unsigned nchannels = format.asbd.mChannelsPerFrame;
+    uint32_t mask = channel_config(format);
+    bool has_layout = Helpers::bitcount(mask) == nchannels;
+    std::vector<bool> selected(nchannels);
+    std::vector<unsigned> result;
+
+    const char *p = spec.c_str();
+    for (;;) {
+        p += std::strspn(p, ", \t");
+        if (!*p)
+            break;
+        size_t len = std::strcspn(p, ", \t");
+        std::string token(p, len);
+        p += len;
+        unsigned first, last;
+        char *end;
+        if (std::isdigit(static_cast<unsigned char>(token[0]))) {
+            first = last = std::strtoul(token.c_str(), &end, 10);
+            if (*end == '-')
+                last = std::strtoul(end + 1, &end, 10);
+            if (*end || first < 1 || first > last || last > nchannels)
+                return result;
+            --first, --last;
+        } else {
+            /* speaker label: output position is its rank in the mask */
+            for (size_t i = 0; i < token.size(); ++i)
+                token[i] = std::toupper(static_cast<unsigned char>(token[i]));
+            unsigned bit = 0;
+            while (bit < 18 && token != Helpers::channel_name(bit + 1))
+                ++bit;
+            if (bit == 18 || !has_layout || !(mask & (1u << bit)))
+                return result;
+            first = last = Helpers::bitcount(mask & ((1u << bit) - 1));
+        }
+        for (unsigned i = first; i <= last; ++i)
+            selected[i] = true;
+    }
+    for (unsigned i = 0; i < nchannels; ++i)
+        if (selected[i])
+            result.push_back(i);
+    return result;
+}
@@ -1,10 +1,38 @@
 #ifndef DECODER_H
 #define DECODER_H
 
+#include <functional>
 #include <memory>
+#include <string>
 #include "CAFFile.h"
 
 struct IDecoder {
+    /* output transforms, applied while converting samples */
+    struct Options {
+        bool        stereo_downmix; /* mix multichannel down to stereo */
+        /*
+         * channels to extract, by number (1 based, in output order) or
+         * speaker label, e.g. "1-4,7" or "FL,FR,LFE"; empty for all.
+         * Takes precedence over stereo_downmix.
+         */
+        std::string channels;
+        /*
+         * HE-AAC: decode the AAC-LC core alone, switching the demuxer's
+         * format to it (half the sample rate, and mono for HE-AACv2)
+         */
+        bool        aac_core_only;
+        Options(): stereo_downmix(false), aac_core_only(false) {}
+    };
+    enum SampleFormat { FLOAT32, INT16, INT24_IN_32, INT32 };
+    /* caller buffers for decode_into() */
+    struct Output {
+        SampleFormat  format;
+        bool          planar;
+        void * const *data;     /* one pointer per channel when planar */
+        size_t        offset;   /* in frames, where storing starts */
+
+        Output(): format(FLOAT32), planar(false), data(0), offset(0) {}
+    };
     virtual ~IDecoder() {}
     virtual t_size set_stream_property(const GUID type, t_size p1,
                                        const void * p2, t_size p2size) = 0;
@@ -12,16 +40,66 @@ struct IDecoder {
     virtual unsigned get_max_frame_dependency() = 0;
     virtual void decode(const void *buffer, t_size bytes,
                         audio_chunk &chunk, abort_callback &abort) = 0;
+    /*
+     * decode(), with the first skip frames of the output dropped (all of
+     * them, when there are fewer). Decoders override it to skip them
+     * before conversion rather than move the rest down afterwards.
+     */
+    virtual void decode_skipping(const void *buffer, t_size bytes,
+                                 size_t skip, audio_chunk &chunk,
+                                 abort_callback &abort);
     virtual void reset_after_seek() = 0;
     virtual bool analyze_first_frame_supported() = 0;
     virtual void analyze_first_frame(const void *buffer, t_size bytes,
                                      abort_callback &abort) = 0;
+    /* optional; decoders that convert samples themselves time it here */
+    virtual void set_counters(PerfCounters *counters) {}
+    /*
+     * optional; false when the decoder (or the channel layout) doesn't
+     * allow them, in which case output is left as it is
+     */
+    virtual bool set_options(const Options &options) { return false; }
+    /*
+     * optional; decodes buffer like decode(), storing frames [skip, skip
+     * + count) of the result straight into out. Returns false, having
+     * decoded nothing, when the decoder (or its options) can't.
+     */
+    virtual bool decode_into(const void *buffer, t_size bytes, size_t skip,
+                             size_t count, const Output &out,
+                             abort_callback &abort)
+    {
+        return false;
+    }
+    /*
+     * optional; sizes internal buffers for decoding up to bytes of
+     * packets per call, so that decoding doesn't allocate afterwards.
+     * create_decoder() reserves for the largest packet of the file.
+     */
+    virtual void reserve(size_t bytes) {}
+    /* drops the first nframes of chunk, moving the rest down */
+    static void drop_frames(audio_chunk &chunk, size_t nframes);
+    /* stores nframes of decoder output (interleaved) into out */
+    static void store_samples(const audio_sample *src, size_t nframes,
+                              unsigned channels, const Output &out);
     static std::shared_ptr<IDecoder>
         create_decoder(std::shared_ptr<CAFFile> &demuxer,
-                       abort_callback &abort);
+                       abort_callback &abort,
+                       const Options &options=Options());
+    /* whether packets of the format decode independently of each other */
+    static bool is_intra_only_format(uint32_t format_id);
+    /*
+     * decodes every packet of the file in order, priming and padding
+     * included, handing each chunk to sink
+     */
+    static void decode_all(std::shared_ptr<CAFFile> &demuxer,
+                           abort_callback &abort,
+                           const std::function<void(const audio_chunk &)>
+                               &sink);
 };
 
 struct DecoderBase: public IDecoder {
+    DecoderBase(): m_counters(0) {}
+    void set_counters(PerfCounters *counters) { m_counters = counters; }
     t_size set_stream_property(const GUID type, t_size p1,
                                const void * p2, t_size p2size) { return 0; }
     unsigned get_max_frame_dependency() { return 0; }
@@ -29,6 +107,21 @@ struct DecoderBase: public IDecoder {
     bool analyze_first_frame_supported() { return false; }
     void analyze_first_frame(const void *buffer, t_size bytes,
                              abort_callback &abort) {}
+protected:
+    PerfCounters *m_counters;
+
+    /* channel mask to put on the output chunk */
+    static uint32_t channel_config(const CAFFile::Format &format);
+    /* output (interleaved) position of each coded channel */
+    static std::vector<unsigned>
+        channel_positions(const CAFFile::Format &format);
+    /*
+     * Output positions named by Options::channels, ascending and without
+     * duplicates; empty if anything in it doesn't name a channel.
+     */
+    static std::vector<unsigned>
+        parse_channel_selection(const CAFFile::Format &format,
+                                const std::string &spec);
 };
 
 #endif
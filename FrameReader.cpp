@@ -0,0 +1,109 @@
+#include <algorithm>
+#include "FrameReader.h"
+
+namespace {
+    /* bytes of packets read at a time, for formats with fixed sizes */
+    const uint32_t READ_BYTES = 65536;
+}
+
+FrameReader::FrameReader(const std::shared_ptr<CAFFile> &demuxer,
+                         abort_callback &abort)
+    : m_demuxer(demuxer), m_packets_per_read(1), m_next_packet(0),
+      m_chunk_frame(-1)
+{
+    m_decoder = IDecoder::create_decoder(m_demuxer, abort);
+    /* others decode a packet per call */
+    auto asbd = m_demuxer->format().asbd;
+    if (asbd.mBytesPerPacket > 0)
+        m_packets_per_read = std::max(READ_BYTES / asbd.mBytesPerPacket, 1u);
+    /* sized up front, so that reading doesn't allocate */
+    size_t bytes = static_cast<size_t>(m_demuxer->max_packet_size())
+                 * m_packets_per_read;
+    m_packet_data.reserve(bytes);
+    m_decoder->reserve(bytes);
+    m_chunk.set_data_size(static_cast<size_t>(asbd.mFramesPerPacket)
+                          * m_packets_per_read * channels());
+}
+
+size_t FrameReader::read(int64_t first, size_t count,
+                         const IDecoder::Output &out, abort_callback &abort)
+{
+    int64_t length = m_demuxer->duration();
+    if (first < 0 || first >= length)
+        return 0;
+    count = std::min<int64_t>(count, length - first);
+
+    uint32_t fpp       = m_demuxer->format().asbd.mFramesPerPacket;
+    unsigned nchannels = channels();
+    int64_t  pos       = first + m_demuxer->start_offset();
+    size_t   done      = 0;
+    IDecoder::Output o = out;
+    while (done < count) {
+        abort.check();
+        int64_t frame = pos + done;
+        o.offset      = out.offset + done;
+        int64_t chunk_end = m_chunk_frame + m_chunk.get_sample_count();
+        if (m_chunk_frame >= 0 && frame >= m_chunk_frame
+         && frame < chunk_end) {
+            size_t n = std::min<int64_t>(count - done, chunk_end - frame);
+            IDecoder::store_samples(m_chunk.get_data()
+                                    + (frame - m_chunk_frame) * nchannels,
+                                    n, nchannels, o);
+            done += n;
+            continue;
+        }
+        int64_t packet = frame / fpp;
+        if (packet != m_next_packet)
+            seek(packet, abort);
+        /*
+         * A packet needed only in part is decoded on its own into
+         * m_chunk, for the next read to continue from without decoding
+         * it again.
+         */
+        int64_t  last    = (pos + count - 1) / fpp;
+        uint32_t want    = std::min<int64_t>(last - packet + 1,
+                                             m_packets_per_read);
+        bool     partial = packet + want - 1 == last && (pos + count) % fpp;
+        if (partial && want > 1) {
+            --want;
+            partial = false;
+        }
+        uint32_t n = m_demuxer->read_packets(packet, want, &m_packet_data,
+                                             abort);
+        if (!n)
+            break;
+        m_next_packet = packet + n;
+        m_chunk_frame = -1;
+
+        size_t skip = frame - packet * fpp;
+        size_t take = std::min<int64_t>(count - done, n * fpp - skip);
+        if (!partial && m_decoder->decode_into(m_packet_data.data(),
+                                               m_packet_data.size(), skip,
+                                               take, o, abort)) {
+            done += take;
+            continue;
+        }
+        m_decoder->decode(m_packet_data.data(), m_packet_data.size(),
+                          m_chunk, abort);
+        m_chunk_frame = packet * fpp;
+        /* short of what the packet table promises: the end */
+        if (m_chunk.get_sample_count() <= skip)
+            break;
+    }
+    return done;
+}
+
+void FrameReader::seek(int64_t packet, abort_callback &abort)
+{
+    uint32_t preroll = m_decoder->get_max_frame_dependency();
+    if (!packet && preroll)
+        m_decoder = IDecoder::create_decoder(m_demuxer, abort);
+    m_decoder->reset_after_seek();
+    for (int64_t p = std::max<int64_t>(packet - preroll, 0); p < packet; ++p) {
+        m_demuxer->read_packets(p, 1, &m_packet_data, abort);
+        m_decoder->decode(m_packet_data.data(), m_packet_data.size(),
+                          m_chunk, abort);
+    }
+    m_chunk_frame = -1;
+    m_next_packet = packet;
+}
@@ -0,0 +1,51 @@
+#ifndef FRAMEREADER_H
+#define FRAMEREADER_H
+
+#include "Decoder.h"
+
+/*
+ * Pull-style decoding of frame ranges into caller buffers, on the
+ * timeline of CAFFile::duration() (priming trimmed). Decoders with
+ * decode_into() (LPCM and IMA4) store straight into the caller's buffers
+ * from the packet data; for the others, each decoded chunk is converted
+ * once, and kept for the next read to continue from.
+ *
+ * A read that starts where the previous one ended goes on decoding;
+ * anything else seeks, with the decoder's preroll. Decoders that add
+ * delay (and so need more than priming trimmed) are not accounted for.
+ */
+class FrameReader {
+    std::shared_ptr<CAFFile>  m_demuxer;
+    std::shared_ptr<IDecoder> m_decoder;
+    uint32_t                  m_packets_per_read;
+    int64_t                   m_next_packet;  /* the decoder expects */
+    std::vector<uint8_t>      m_packet_data;
+    audio_chunk_impl          m_chunk;
+    int64_t                   m_chunk_frame;  /* of m_chunk, or -1 */
+public:
+    FrameReader(const std::shared_ptr<CAFFile> &demuxer,
+                abort_callback &abort);
+
+    unsigned channels() const
+    {
+        return m_demuxer->format().asbd.mChannelsPerFrame;
+    }
+    int64_t length() const
+    {
+        return m_demuxer->duration();
+    }
+    /*
+     * Stores frames [first, first + count) at out.offset of out;
+     * returns the number stored, short of count only at the end.
+     */
+    size_t read(int64_t first, size_t count, const IDecoder::Output &out,
+                abort_callback &abort);
+private:
+    FrameReader(const FrameReader &);
+    FrameReader& operator=(const FrameReader &);
+
+    /* makes packet the next one decoded */
+    void seek(int64_t packet, abort_callback &abort);
+};
+
+#endif
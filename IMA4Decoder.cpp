@@ -1,27 +1,5 @@
 #include "IMA4Decoder.h"
-
-namespace {
-    const int8_t ima4_index_table[16] = {
-        -1, -1, -1, -1, 2, 4, 6, 8,
-        -1, -1, -1, -1, 2, 4, 6, 8,
-    };
-    const int16_t ima4_step_table[89] = {
-            7,     8,     9,    10,    11,    12,    13,    14,    16,    17,
-           19,    21,    23,    25,    28,    31,    34,    37,    41,    45,
-           50,    55,    60,    66,    73,    80,    88,    97,   107,   118,
-          130,   143,   157,   173,   190,   209,   230,   253,   279,   307,
-          337,   371,   408,   449,   494,   544,   598,   658,   724,   796,
-          876,   963,  1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,
-         2272,  2499,  2749,  3024,  3327,  3660,  4026,  4428,  4871,  5358,
-         5894,  6484,  7132,  7845,  8630,  9493, 10442, 11487, 12635, 13899,
-        15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
-    };
-
-    inline int32_t clamp(int32_t x, int32_t low, int32_t high)
-    {
-        return x < low ? low : x > high ? high : x;
-    }
-}
+#include "ADPCM.h"
 
 IMA4Decoder::IMA4Decoder(const CAFFile::Format &format): m_format(format)
 {
@@ -54,6 +32,44 @@ void IMA4Decoder::get_info(file_info &info)
 
 void IMA4Decoder::decode(const void *buffer, t_size bytes, audio_chunk &chunk,
                          abort_callback &abort)
+{
+    unsigned nsamples = decode_samples(buffer, bytes);
+    m_lpcm_decoder->decode(m_sample_buffer.data(), nsamples * 2, chunk, abort);
+}
+
+void IMA4Decoder::decode_skipping(const void *buffer, t_size bytes,
+                                  size_t skip, audio_chunk &chunk,
+                                  abort_callback &abort)
+{
+    /* every block is decoded for the predictors, but not converted */
+    unsigned nsamples = decode_samples(buffer, bytes);
+    size_t   offset   = std::min<size_t>(skip * m_channel_state.size(),
+                                         nsamples);
+    m_lpcm_decoder->decode(m_sample_buffer.data() + offset,
+                           (nsamples - offset) * 2, chunk, abort);
+}
+
+bool IMA4Decoder::decode_into(const void *buffer, t_size bytes, size_t skip,
+                              size_t count, const Output &out,
+                              abort_callback &abort)
+{
+    /* the predictors carry over, so check before decoding anything */
+    if (!m_lpcm_decoder->is_plain())
+        return false;
+    unsigned nsamples = decode_samples(buffer, bytes);
+    return m_lpcm_decoder->decode_into(m_sample_buffer.data(), nsamples * 2,
+                                       skip, count, out, abort);
+}
+
+void IMA4Decoder::reserve(size_t bytes)
+{
+    /* 34 byte blocks of 64 samples */
+    size_t nsamples = bytes / 34 * 64;
+    m_sample_buffer.reserve(nsamples);
+    m_lpcm_decoder->reserve(nsamples * 2);
+}
+
+unsigned IMA4Decoder::decode_samples(const void *buffer, t_size bytes)
 {
     unsigned nchannels = m_channel_state.size();
     unsigned nblocks   = bytes / nchannels / 34;
@@ -67,11 +83,9 @@ void IMA4Decoder::decode(const void *buffer, t_size bytes, audio_chunk &chunk,
                          &m_sample_buffer[i * nchannels * 64 + ch], nchannels);
         }
     }
-    m_lpcm_decoder->decode(m_sample_buffer.data(), nsamples * 2, chunk, abort);
+    return nsamples;
 }
 
-#define CLAMP(x, low, high) ((x)<(low)?(low):(x)>(high)?(high):(x))
-
 void IMA4Decoder::decode_block(ChannelState *cs, const uint8_t *bp, int16_t *sp,
                                unsigned stride)
 {
@@ -82,7 +96,7 @@ void IMA4Decoder::decode_block(ChannelState *cs, const uint8_t *bp, int16_t *sp,
     if (cs->step_index != step_index
      || std::abs(cs->predictor - predictor) > 0x7f) {
         cs->predictor  = predictor;
-        cs->step_index = clamp(step_index, 0, 88);
+        cs->step_index = ADPCM::clamp(step_index, 0, 88);
     }
     bp += 2;
     for (unsigned i = 0; i < 32; ++i, sp += stride * 2) {
@@ -94,13 +108,5 @@ void IMA4Decoder::decode_block(ChannelState *cs, const uint8_t *bp, int16_t *sp,
 
 int16_t IMA4Decoder::decode_nibble(ChannelState *cs, uint8_t nibble)
 {
-    int step = ima4_step_table[cs->step_index];
-    int diff = step >> 3;
-    if (nibble & 1) diff += step >> 2;
-    if (nibble & 2) diff += step >> 1;
-    if (nibble & 4) diff += step;
-    if (nibble & 8) diff = -diff;
-    cs->predictor  = clamp(cs->predictor + diff, -32768, 32767);
-    cs->step_index = clamp(cs->step_index + ima4_index_table[nibble], 0, 88);
-    return cs->predictor;
+    return ADPCM::ima_expand_nibble(&cs->predictor, &cs->step_index, nibble);
 }
@@ -15,10 +15,26 @@ class IMA4Decoder: public DecoderBase {
     std::vector<int16_t>         m_sample_buffer;
 public:
     IMA4Decoder(const CAFFile::Format &format);
+    void set_counters(PerfCounters *counters)
+    {
+        DecoderBase::set_counters(counters);
+        m_lpcm_decoder->set_counters(counters);
+    }
+    bool set_options(const Options &options)
+    {
+        return m_lpcm_decoder->set_options(options);
+    }
     void get_info(file_info &info);
     void decode(const void *buffer, t_size bytes, audio_chunk &chunk,
                 abort_callback &abort);
+    void decode_skipping(const void *buffer, t_size bytes, size_t skip,
+                         audio_chunk &chunk, abort_callback &abort);
+    bool decode_into(const void *buffer, t_size bytes, size_t skip,
+                     size_t count, const Output &out, abort_callback &abort);
+    void reserve(size_t bytes);
 private:
+    /* into m_sample_buffer, interleaved; returns the number of samples */
+    unsigned decode_samples(const void *buffer, t_size bytes);
     void decode_block(ChannelState *cs, const uint8_t *bp, int16_t *sp,
                       unsigned stride);
     int16_t decode_nibble(ChannelState *cs, uint8_t nibble);
@@ -0,0 +1,109 @@
+#include <algorithm>
+#include "IMAADPCMDecoder.h"
+#include "ADPCM.h"
+
+/*
+ * WAV-style (DVI) IMA ADPCM. Each packet is one block of mBytesPerPacket
+ * bytes:
+ *
+ *   { int16 predictor, uint8 step index, uint8 reserved } [nchannels]
+ *   groups of 4 bytes (8 samples) per channel, in channel order,
+ *   low nibble first
+ *
+ * The predictor in the header is the first output frame.
+ */
+IMAADPCMDecoder::IMAADPCMDecoder(const CAFFile::Format &format)
+    : m_format(format)
+{
+    auto     asbd      = format.asbd;
+    unsigned nchannels = asbd.mChannelsPerFrame;
+
+    if (!nchannels || asbd.mBytesPerPacket <= 4 * nchannels
+     || (asbd.mBytesPerPacket - 4 * nchannels) % (4 * nchannels))
+        throw std::runtime_error("invalid IMA ADPCM block size");
+    unsigned capacity =
+        (asbd.mBytesPerPacket - 4 * nchannels) * 2 / nchannels + 1;
+    m_frames_per_block = asbd.mFramesPerPacket;
+    if (!m_frames_per_block || m_frames_per_block > capacity)
+        m_frames_per_block = capacity;
+
+    m_channel_pos = channel_positions(format);
+    m_predictor.resize(nchannels);
+    m_step_index.resize(nchannels);
+}
+
+void IMAADPCMDecoder::get_info(file_info &info)
+{
+    info.info_set("codec",    "IMA ADPCM");
+    info.info_set("encoding", "lossy");
+    info.info_set_int("samplerate", m_format.asbd.mSampleRate);
+    uint32_t channel_mask = m_format.channel_mask;
+    std::string channels;
+    if (channel_mask) {
+        channels = Helpers::describe_channels(channel_mask);
+        info.info_set("channels", channels.c_str());
+    } else {
+        info.info_set_int("channels", m_format.asbd.mChannelsPerFrame);
+    }
+}
+
+void IMAADPCMDecoder::decode(const void *buffer, t_size bytes,
+                             audio_chunk &chunk, abort_callback &abort)
+{
+    auto     asbd      = m_format.asbd;
+    unsigned nchannels = asbd.mChannelsPerFrame;
+    unsigned nblocks   = bytes / asbd.mBytesPerPacket;
+    auto     bp        = static_cast<const uint8_t*>(buffer);
+    t_size   nframes   = nblocks * m_frames_per_block;
+
+    chunk.set_data_size(nframes * nchannels);
+    audio_sample *dp = chunk.get_data();
+    for (unsigned i = 0; i < nblocks; ++i) {
+        decode_block(bp, dp);
+        bp += asbd.mBytesPerPacket;
+        dp += m_frames_per_block * nchannels;
+    }
+    chunk.set_srate(asbd.mSampleRate);
+    chunk.set_channels(nchannels, channel_config(m_format));
+    chunk.set_sample_count(nframes);
+}
+
+void IMAADPCMDecoder::decode_block(const uint8_t *bp, audio_sample *dp)
+{
+    const audio_sample scale = 1.0 / 32768.0;
+    unsigned nchannels = m_format.asbd.mChannelsPerFrame;
+    const unsigned *pos = m_channel_pos.data();
+    int32_t *predictor  = m_predictor.data();
+    int32_t *step_index = m_step_index.data();
+    unsigned ch;
+
+    for (ch = 0; ch < nchannels; ++ch, bp += 4) {
+        predictor[ch]  = static_cast<int16_t>(bp[0] | (bp[1] << 8));
+        step_index[ch] = ADPCM::clamp(bp[2], 0, 88);
+        dp[pos[ch]]    = predictor[ch] * scale;
+    }
+    dp += nchannels;
+
+    /*
+     * Process one 8-frame group at a time; within a group every channel
+     * owns 4 consecutive bytes, so channels advance in lockstep. With
+     * fewer frames per packet than the block holds, the last group may
+     * be partial.
+     */
+    for (unsigned nleft = m_frames_per_block - 1; nleft > 0; ) {
+        unsigned n = std::min(nleft, 8u);
+        for (unsigned i = 0; i < n; ++i) {
+            for (ch = 0; ch < nchannels; ++ch) {
+                uint8_t  b      = bp[ch * 4 + (i >> 1)];
+                unsigned nibble = (i & 1) ? b >> 4 : b & 0xf;
+                int32_t  v = ADPCM::ima_expand_nibble(&predictor[ch],
+                                                      &step_index[ch],
+                                                      nibble);
+                dp[i * nchannels + pos[ch]] = v * scale;
+            }
+        }
+        bp += 4 * nchannels;
+        dp += n * nchannels;
+        nleft -= n;
+    }
+}
@@ -0,0 +1,22 @@
+#ifndef IMAADPCMDECODER_H
+#define IMAADPCMDECODER_H
+
+#include "Decoder.h"
+
+class IMAADPCMDecoder: public DecoderBase {
+    CAFFile::Format       m_format;
+    unsigned              m_frames_per_block;
+    std::vector<unsigned> m_channel_pos;
+    /* decoder state, laid out so that each channel is one lane */
+    std::vector<int32_t>  m_predictor;
+    std::vector<int32_t>  m_step_index;
+public:
+    IMAADPCMDecoder(const CAFFile::Format &format);
+    void get_info(file_info &info);
+    void decode(const void *buffer, t_size bytes, audio_chunk &chunk,
+                abort_callback &abort);
+private:
+    void decode_block(const uint8_t *bp, audio_sample *dp);
+};
+
+#endif
@@ -1,4 +1,377 @@
+#include <algorithm>
+#include <stdexcept>
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#endif
 #include "LPCMDecoder.h"
+#include "SampleStore.h"
+
+namespace {
+    /*
+     * Integer samples are loaded left justified into 32 bits, so that
+     * every width shares the same scale.
+     */
+    template <unsigned N, bool BigEndian>
+    inline int32_t load_int(const uint8_t *p)
+    {
+        uint32_t v = 0;
+        for (unsigned i = 0; i < N; ++i)
+            v |= static_cast<uint32_t>(p[BigEndian ? i : N - 1 - i])
+                    << (24 - 8 * i);
+        return static_cast<int32_t>(v);
+    }
+    template <unsigned N, bool BigEndian>
+    struct IntSample {
+        enum { SIZE = N };
+        static audio_sample load(const uint8_t *p)
+        {
+            const audio_sample scale = 1.0 / 2147483648.0;
+            return load_int<N, BigEndian>(p) * scale;
+        }
+        template <typename O>
+        static typename O::type load_as(const uint8_t *p)
+        {
+            return O::from_int(load_int<N, BigEndian>(p));
+        }
+    };
+    template <typename T, typename U, bool BigEndian>
+    struct FloatSample {
+        enum { SIZE = sizeof(T) };
+        static audio_sample load(const uint8_t *p)
+        {
+            const unsigned N = sizeof(T);
+            U u = 0;
+            for (unsigned j = 0; j < N; ++j)
+                u |= static_cast<U>(p[BigEndian ? j : N - 1 - j])
+                        << (8 * (N - 1 - j));
+            T v;
+            std::memcpy(&v, &u, N);
+            return static_cast<audio_sample>(v);
+        }
+        template <typename O>
+        static typename O::type load_as(const uint8_t *p)
+        {
+            return O::from_float(load(p));
+        }
+    };
+
+    template <typename S>
+    void convert(const uint8_t *src, size_t count, audio_sample *dst)
+    {
+        for (size_t i = 0; i < count; ++i, src += S::SIZE)
+            dst[i] = S::load(src);
+    }
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    /*
+     * (L, R) partial sums of one frame in lanes 0-1 and 2-3: coefs holds
+     * (left, right) pairs per channel, which line up with
+     * unpack{lo,hi}(x, x) of four consecutive samples.
+     */
+    template <unsigned C>
+    inline __m128 mix_frame(const audio_sample *sp, unsigned channels,
+                            const audio_sample *coefs)
+    {
+        const unsigned nc = C ? C : channels;
+        __m128 acc = _mm_setzero_ps();
+        unsigned ch = 0;
+        for (; ch + 4 <= nc; ch += 4) {
+            __m128 x = _mm_loadu_ps(sp + ch);
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_unpacklo_ps(x, x),
+                                             _mm_loadu_ps(coefs + 2 * ch)));
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_unpackhi_ps(x, x),
+                                             _mm_loadu_ps(coefs + 2 * ch + 4)));
+        }
+        if (ch + 2 <= nc) {
+            __m128 x = _mm_castpd_ps(_mm_load_sd(
+                            reinterpret_cast<const double *>(sp + ch)));
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_unpacklo_ps(x, x),
+                                             _mm_loadu_ps(coefs + 2 * ch)));
+            ch += 2;
+        }
+        if (ch < nc) {
+            __m128 x = _mm_load_ss(sp + ch);
+            __m128 k = _mm_castpd_ps(_mm_load_sd(
+                            reinterpret_cast<const double *>(coefs + 2 * ch)));
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_unpacklo_ps(x, x), k));
+        }
+        return acc;
+    }
+    template <unsigned C>
+    void mix(const audio_sample *sp, size_t nframes, unsigned channels,
+             const audio_sample *coefs, audio_sample *dp)
+    {
+        const unsigned nc = C ? C : channels;
+        size_t i = 0;
+        /* two frames at a time, so that one fold yields (L, R, L, R) */
+        for (; i + 2 <= nframes; i += 2, sp += 2 * nc, dp += 4) {
+            __m128 a = mix_frame<C>(sp,      channels, coefs);
+            __m128 b = mix_frame<C>(sp + nc, channels, coefs);
+            _mm_storeu_ps(dp, _mm_add_ps(_mm_movelh_ps(a, b),
+                                         _mm_movehl_ps(b, a)));
+        }
+        if (i < nframes) {
+            __m128 a = mix_frame<C>(sp, channels, coefs);
+            _mm_store_sd(reinterpret_cast<double *>(dp),
+                         _mm_castps_pd(_mm_add_ps(a, _mm_movehl_ps(a, a))));
+        }
+    }
+#else
+    template <unsigned C>
+    void mix(const audio_sample *sp, size_t nframes, unsigned channels,
+             const audio_sample *coefs, audio_sample *dp)
+    {
+        const unsigned nc = C ? C : channels;
+        for (size_t i = 0; i < nframes; ++i, sp += nc) {
+            audio_sample l = 0, r = 0;
+            for (unsigned ch = 0; ch < nc; ++ch) {
+                l += sp[ch] * coefs[2 * ch];
+                r += sp[ch] * coefs[2 * ch + 1];
+            }
+            dp[2 * i]     = l;
+            dp[2 * i + 1] = r;
+        }
+    }
+#endif
+    /*
+     * Converts and mixes down to stereo block by block, so that the
+     * converted samples are mixed while still in L1; coefs holds a
+     * (left, right) pair per coded channel. C fixes the channel count
+     * for the common layouts, so that the mix is unrolled.
+     */
+    template <typename S, unsigned C>
+    void downmix(const uint8_t *src, size_t nframes, unsigned channels,
+                 const audio_sample *coefs, audio_sample *dst)
+    {
+        enum { BLOCK_SAMPLES = 2048 };
+        const unsigned nc = C ? C : channels;
+        const size_t block = std::max<size_t>(BLOCK_SAMPLES / nc, 1);
+        std::vector<audio_sample> heap;
+        audio_sample stack[BLOCK_SAMPLES], *tmp = stack;
+        if (nc > BLOCK_SAMPLES) {
+            heap.resize(nc);
+            tmp = heap.data();
+        }
+        for (size_t n = 0; n < nframes; n += block) {
+            size_t count = std::min(block, nframes - n);
+            convert<S>(src + n * nc * S::SIZE, count * nc, tmp);
+            mix<C>(tmp, count, channels, coefs, dst + 2 * n);
+        }
+    }
+
+    /*
+     * Converts only the selected channels, reading their bytes straight
+     * out of each frame: cost follows the number of channels extracted,
+     * not the width of the file.
+     */
+    template <typename S>
+    void extract(const uint8_t *src, size_t nframes, unsigned bpf,
+                 const uint32_t *offsets, unsigned count, audio_sample *dst)
+    {
+        for (size_t i = 0; i < nframes; ++i, src += bpf)
+            for (unsigned k = 0; k < count; ++k)
+                *dst++ = S::load(src + offsets[k]);
+    }
+
+    /*
+     * Converts frames straight from the file bytes into the caller's
+     * sample format and layout; offsets hold the byte offset of each
+     * output channel in a frame, so that the channel map costs nothing
+     * (null when the channels are in order).
+     */
+    template <typename S, typename O>
+    void store(const uint8_t *src, size_t nframes, unsigned bpf,
+               const uint32_t *offsets, unsigned channels,
+               const IDecoder::Output &out)
+    {
+        typedef typename O::type T;
+        if (out.planar) {
+            for (unsigned ch = 0; ch < channels; ++ch) {
+                T *dp = static_cast<T *>(out.data[ch]) + out.offset;
+                const uint8_t *sp = src + (offsets ? offsets[ch]
+                                                   : ch * S::SIZE);
+                for (size_t i = 0; i < nframes; ++i, sp += bpf)
+                    dp[i] = S::template load_as<O>(sp);
+            }
+        } else if (offsets) {
+            T *dp = static_cast<T *>(out.data[0]) + out.offset * channels;
+            for (size_t i = 0; i < nframes; ++i, src += bpf)
+                for (unsigned ch = 0; ch < channels; ++ch)
+                    *dp++ = S::template load_as<O>(src + offsets[ch]);
+        } else {
+            T *dp = static_cast<T *>(out.data[0]) + out.offset * channels;
+            for (size_t i = 0; i < nframes * channels; ++i, src += S::SIZE)
+                dp[i] = S::template load_as<O>(src);
+        }
+    }
+
+    template <typename S>
+    void select(LPCMDecoder::convert_t *conv, LPCMDecoder::downmix_t *dmx,
+                LPCMDecoder::extract_t *ext, LPCMDecoder::store_t *sto,
+                unsigned channels)
+    {
+        *conv = convert<S>;
+        *ext  = extract<S>;
+        sto[IDecoder::FLOAT32]     = store<S, SampleStore::Float32>;
+        sto[IDecoder::INT16]       = store<S, SampleStore::Int16>;
+        sto[IDecoder::INT24_IN_32] = store<S, SampleStore::Int24In32>;
+        sto[IDecoder::INT32]       = store<S, SampleStore::Int32>;
+        switch (channels) {
+        case 6:  *dmx = downmix<S, 6>; break;
+        case 8:  *dmx = downmix<S, 8>; break;
+        default: *dmx = downmix<S, 0>; break;
+        }
+    }
+
+    /*
+     * ITU-R BS.775 style stereo downmix, by WAVEFORMATEXTENSIBLE speaker
+     * position. LFE is dropped. No normalization: samples are float and
+     * can go past full scale.
+     */
+    const audio_sample K = 0.70710678f;
+    const audio_sample downmix_matrix[18][2] = {
+        { 1,     0     },   /* FL  */
+        { 0,     1     },   /* FR  */
+        { K,     K     },   /* FC  */
+        { 0,     0     },   /* LFE */
+        { K,     0     },   /* BL  */
+        { 0,     K     },   /* BR  */
+        { 1,     0     },   /* FLC */
+        { 0,     1     },   /* FRC */
+        { K * K, K * K },   /* BC  */
+        { K,     0     },   /* SL  */
+        { 0,     K     },   /* SR  */
+        { K * K, K * K },   /* TC  */
+        { 1,     0     },   /* TFL */
+        { K,     K     },   /* TFC */
+        { 0,     1     },   /* TFR */
+        { K,     0     },   /* TBL */
+        { K * K, K * K },   /* TBC */
+        { 0,     K     },   /* TBR */
+    };
+}
+
+LPCMDecoder::LPCMDecoder(const CAFFile::Format &format)
+    : m_format(format), m_need_channel_remap(false),
+      m_stereo_downmix(false), m_selection_mask(0)
+{
+    auto     asbd      = m_format.asbd;
+    unsigned channels  = asbd.mChannelsPerFrame;
+    bool     is_float  = asbd.mFormatFlags & 1;
+    bool     is_be     = !(asbd.mFormatFlags & 2);
+
+    m_bytes_per_sample = asbd.mBytesPerPacket / channels;
+    m_channel_mask     = channel_config(m_format);
+
+    m_convert = 0;
+    m_downmix = 0;
+    m_extract = 0;
+    if (is_float) {
+        switch (m_bytes_per_sample) {
+        case 4: if (is_be) select<FloatSample<float, uint32_t, true> >
+                                (&m_convert, &m_downmix, &m_extract,
+                                 m_store, channels);
+                else       select<FloatSample<float, uint32_t, false> >
+                                (&m_convert, &m_downmix, &m_extract,
+                                 m_store, channels);
+                break;
+        case 8: if (is_be) select<FloatSample<double, uint64_t, true> >
+                                (&m_convert, &m_downmix, &m_extract,
+                                 m_store, channels);
+                else       select<FloatSample<double, uint64_t, false> >
+                                (&m_convert, &m_downmix, &m_extract,
+                                 m_store, channels);
+                break;
+        }
+    } else {
+        switch (m_bytes_per_sample) {
+#define SELECT_INT(N) \
+        case N: if (is_be) select<IntSample<N, true> > \
+                                (&m_convert, &m_downmix, &m_extract, \
+                                 m_store, channels); \
+                else       select<IntSample<N, false> > \
+                                (&m_convert, &m_downmix, &m_extract, \
+                                 m_store, channels); \
+                break;
+        SELECT_INT(1)
+        SELECT_INT(2)
+        SELECT_INT(3)
+        SELECT_INT(4)
+#undef SELECT_INT
+        }
+    }
+    if (!m_convert)
+        throw std::runtime_error("unsupported LPCM format");
+
+    auto chanmap = m_format.channel_map;
+    if (chanmap.size()
+     && !Helpers::is_increasing(chanmap.begin(), chanmap.end()))
+        m_need_channel_remap = true;
+    for (unsigned ch = 0; ch < channels; ++ch) {
+        unsigned coded = chanmap.size() == channels ? chanmap[ch] : ch;
+        m_channel_offsets.push_back(coded * m_bytes_per_sample);
+    }
+}
+
+bool LPCMDecoder::set_options(const Options &options)
+{
+    m_stereo_downmix = false;
+    m_lane_offsets.clear();
+    if (options.channels.size())
+        return select_channels(options.channels) && !options.stereo_downmix;
+    unsigned channels = m_format.asbd.mChannelsPerFrame;
+    if (!options.stereo_downmix || channels <= 2)
+        return !options.stereo_downmix;
+    /* needs to know the speaker of every channel */
+    uint32_t mask = m_channel_mask;
+    std::vector<unsigned> speakers;
+    for (unsigned bit = 0; bit < 18; ++bit)
+        if (mask & (1u << bit))
+            speakers.push_back(bit);
+    if (speakers.size() != channels || (mask >> 18))
+        return false;
+    /* coefficients by coded channel, so that no remap is needed */
+    std::vector<unsigned> pos = channel_positions(m_format);
+    m_downmix_coefs.resize(channels * 2);
+    for (unsigned ch = 0; ch < channels; ++ch) {
+        const audio_sample *c = downmix_matrix[speakers[pos[ch]]];
+        m_downmix_coefs[2 * ch]     = c[0];
+        m_downmix_coefs[2 * ch + 1] = c[1];
+    }
+    m_stereo_downmix = true;
+    return true;
+}
+
+bool LPCMDecoder::select_channels(const std::string &spec)
+{
+    std::vector<unsigned> selection = parse_channel_selection(m_format, spec);
+    unsigned channels = m_format.asbd.mChannelsPerFrame;
+    if (selection.empty())
+        return false;
+    if (selection.size() == channels)
+        return true; /* everything: the plain conversion is faster */
+    uint32_t mask = m_channel_mask;
+    bool has_layout = Helpers::bitcount(mask) == channels;
+    const auto &chanmap = m_format.channel_map;
+    m_selection_mask = 0;
+    for (size_t k = 0; k < selection.size(); ++k) {
+        unsigned pos = selection[k];
+        unsigned coded = chanmap.size() == channels ? chanmap[pos] : pos;
+        m_lane_offsets.push_back(coded * m_bytes_per_sample);
+        if (has_layout) {
+            /* speaker of output pos is the pos-th bit set in the mask */
+            uint32_t bits = mask;
+            for (unsigned i = 0; i < pos; ++i)
+                bits &= bits - 1;
+            m_selection_mask |= bits & (~bits + 1);
+        }
+    }
+    if (!has_layout)
+        m_selection_mask =
+            audio_chunk::g_guess_channel_config(selection.size());
+    return true;
+}
 
 void LPCMDecoder::get_info(file_info &info)
 {
@@ -19,36 +392,79 @@ void LPCMDecoder::get_info(file_info &info)
     }
 }
 
+void LPCMDecoder::decode_skipping(const void *buffer, t_size bytes,
+                                  size_t skip, audio_chunk &chunk,
+                                  abort_callback &abort)
+{
+    /* frames are independent, so conversion just starts past them */
+    unsigned bpf    = m_bytes_per_sample * m_format.asbd.mChannelsPerFrame;
+    size_t   offset = std::min<size_t>(skip, bytes / bpf) * bpf;
+    decode(static_cast<const uint8_t *>(buffer) + offset, bytes - offset,
+           chunk, abort);
+}
+
 void LPCMDecoder::decode(const void *buffer, t_size bytes, audio_chunk &chunk,
                          abort_callback &abort)
 {
-    auto     asbd      = m_format.asbd;
-    unsigned channels  = asbd.mChannelsPerFrame;
-    unsigned bpc       = asbd.mBytesPerPacket * 8 / channels;
-    unsigned flags     = audio_chunk::FLAG_SIGNED;
-    unsigned chanmask  = m_format.channel_mask;
+    PerfTimer timer(m_counters, PerfCounters::CONVERT_NS);
+    unsigned channels = m_format.asbd.mChannelsPerFrame;
+    unsigned bpf      = m_bytes_per_sample * channels;
+    size_t   nframes  = bytes / bpf;
+    auto     src      = static_cast<const uint8_t *>(buffer);
 
-    if (asbd.mFormatFlags & 2)
-        flags |= audio_chunk::FLAG_LITTLE_ENDIAN;
-    else
-        flags |= audio_chunk::FLAG_BIG_ENDIAN;
-    if (!chanmask)
-        chanmask = audio_chunk::g_guess_channel_config(channels);
-    if (asbd.mFormatFlags & 1)
-        chunk.set_data_floatingpoint_ex(buffer, bytes, asbd.mSampleRate,
-                                        channels, bpc, flags, chanmask);
-    else
-        chunk.set_data_fixedpoint_ex(buffer, bytes, asbd.mSampleRate,
-                                     channels, bpc, flags, chanmask);
+    if (m_lane_offsets.size()) {
+        unsigned count = m_lane_offsets.size();
+        chunk.set_data_size(nframes * count);
+        m_extract(src, nframes, bpf, m_lane_offsets.data(), count,
+                  chunk.get_data());
+        chunk.set_srate(m_format.asbd.mSampleRate);
+        chunk.set_channels(count, m_selection_mask);
+        chunk.set_sample_count(nframes);
+        return;
+    }
+    if (m_stereo_downmix) {
+        chunk.set_data_size(nframes * 2);
+        m_downmix(src, nframes, channels, m_downmix_coefs.data(),
+                  chunk.get_data());
+        chunk.set_srate(m_format.asbd.mSampleRate);
+        chunk.set_channels(2, 0x3); /* FL | FR */
+        chunk.set_sample_count(nframes);
+        return;
+    }
     if (m_need_channel_remap) {
-        audio_sample *dp = chunk.get_data(),
-                     *endp = dp + chunk.get_sample_count() * channels;
-        std::vector<audio_sample> work(channels);
+        /* reorder raw frames first, so conversion stays a single pass */
+        m_remap_buffer.resize(nframes * bpf);
         const char *chanmap = m_format.channel_map.data();
-        for (; dp < endp; dp += channels) {
-            std::memcpy(work.data(), dp, channels * sizeof(audio_sample));
-            for (unsigned i = 0; i < channels; ++i)
-                dp[i] = work[chanmap[i]];
-        }
+        uint8_t *dp = m_remap_buffer.data();
+        for (size_t i = 0; i < nframes; ++i, src += bpf, dp += bpf)
+            for (unsigned ch = 0; ch < channels; ++ch)
+                std::memcpy(dp + ch * m_bytes_per_sample,
+                            src + chanmap[ch] * m_bytes_per_sample,
+                            m_bytes_per_sample);
+        src = m_remap_buffer.data();
     }
+    chunk.set_data_size(nframes * channels);
+    m_convert(src, nframes * channels, chunk.get_data());
+    chunk.set_srate(m_format.asbd.mSampleRate);
+    chunk.set_channels(channels, m_channel_mask);
+    chunk.set_sample_count(nframes);
+}
+
+bool LPCMDecoder::decode_into(const void *buffer, t_size bytes, size_t skip,
+                              size_t count, const Output &out,
+                              abort_callback &abort)
+{
+    if (!is_plain())
+        return false;
+    PerfTimer timer(m_counters, PerfCounters::CONVERT_NS);
+    unsigned channels = m_format.asbd.mChannelsPerFrame;
+    unsigned bpf      = m_bytes_per_sample * channels;
+    size_t   nframes  = bytes / bpf;
+    auto     src      = static_cast<const uint8_t *>(buffer);
+    if (skip >= nframes)
+        return true;
+    m_store[out.format](src + skip * bpf, std::min(count, nframes - skip),
+                        bpf, m_need_channel_remap ? m_channel_offsets.data()
+                                                  : 0, channels, out);
+    return true;
 }
@@ -4,20 +4,59 @@
 #include "Decoder.h"
 
 class LPCMDecoder: public DecoderBase {
-    CAFFile::Format m_format;
-    bool            m_need_channel_remap;
 public:
-    LPCMDecoder(const CAFFile::Format &format)
-        : m_format(format), m_need_channel_remap(false)
-    {
-        auto chanmap = m_format.channel_map;
-        if (chanmap.size()
-         && !Helpers::is_increasing(chanmap.begin(), chanmap.end()))
-            m_need_channel_remap = true;
-    }
+    typedef void (*convert_t)(const uint8_t *src, size_t count,
+                              audio_sample *dst);
+    typedef void (*downmix_t)(const uint8_t *src, size_t nframes,
+                              unsigned channels, const audio_sample *coefs,
+                              audio_sample *dst);
+    typedef void (*extract_t)(const uint8_t *src, size_t nframes,
+                              unsigned bytes_per_frame,
+                              const uint32_t *offsets, unsigned count,
+                              audio_sample *dst);
+    typedef void (*store_t)(const uint8_t *src, size_t nframes,
+                            unsigned bytes_per_frame,
+                            const uint32_t *offsets, unsigned channels,
+                            const Output &out);
+private:
+    CAFFile::Format           m_format;
+    unsigned                  m_bytes_per_sample;
+    uint32_t                  m_channel_mask;
+    convert_t                 m_convert;
+    downmix_t                 m_downmix;
+    extract_t                 m_extract;
+    store_t                   m_store[4];    /* by SampleFormat */
+    bool                      m_need_channel_remap;
+    bool                      m_stereo_downmix;
+    std::vector<uint8_t>      m_remap_buffer;
+    std::vector<audio_sample> m_downmix_coefs;
+    /* byte offset in a frame of each extracted channel, in output order */
+    std::vector<uint32_t>     m_lane_offsets;
+    uint32_t                  m_selection_mask;
+    /* byte offset in a frame of each channel, in output order */
+    std::vector<uint32_t>     m_channel_offsets;
+
+    bool select_channels(const std::string &spec);
+public:
+    LPCMDecoder(const CAFFile::Format &format);
+    bool set_options(const Options &options);
     void get_info(file_info &info);
     void decode(const void *buffer, t_size bytes, audio_chunk &chunk,
                 abort_callback &abort);
+    void decode_skipping(const void *buffer, t_size bytes, size_t skip,
+                         audio_chunk &chunk, abort_callback &abort);
+    bool decode_into(const void *buffer, t_size bytes, size_t skip,
+                     size_t count, const Output &out, abort_callback &abort);
+    void reserve(size_t bytes)
+    {
+        if (m_need_channel_remap)
+            m_remap_buffer.reserve(bytes);
+    }
+    /* whether output is every channel as it is, without Options */
+    bool is_plain() const
+    {
+        return !m_stereo_downmix && m_lane_offsets.empty();
+    }
 };
 
 #endif
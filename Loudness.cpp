@@ -0,0 +1,389 @@
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LOUDNESS_SSE2
+#endif
+#include "Loudness.h"
+#include "PeakScanner.h"
+#include "ThreadPool.h"
+#include "Trace.h"
+
+namespace {
+    const double PI = 3.14159265358979323846;
+
+    struct Coefs {
+        double b0, b1, b2, a1, a2;  /* high shelf */
+        double h1, h2;              /* high pass denominator */
+    };
+
+    /*
+     * Runs one pair of channels through both K-weighting stages
+     * (transposed direct form II, in double), adding the squared output
+     * to sums when measuring. With Single, the second lane is a dummy.
+     */
+#ifdef LOUDNESS_SSE2
+    template <bool Single>
+    void filter_pair(const audio_sample *sp, size_t nframes, unsigned stride,
+                     const Coefs &k, double *state, double *sums)
+    {
+        __m128d b0 = _mm_set1_pd(k.b0), b1 = _mm_set1_pd(k.b1);
+        __m128d b2 = _mm_set1_pd(k.b2), a1 = _mm_set1_pd(k.a1);
+        __m128d a2 = _mm_set1_pd(k.a2), h1 = _mm_set1_pd(k.h1);
+        __m128d h2 = _mm_set1_pd(k.h2), m2 = _mm_set1_pd(-2.0);
+        __m128d s1 = _mm_loadu_pd(state),     s2 = _mm_loadu_pd(state + 2);
+        __m128d t1 = _mm_loadu_pd(state + 4), t2 = _mm_loadu_pd(state + 6);
+        __m128d acc = _mm_setzero_pd();
+        for (size_t i = 0; i < nframes; ++i, sp += stride) {
+            __m128 xf = Single ? _mm_load_ss(sp)
+                               : _mm_castpd_ps(_mm_load_sd(
+                                    reinterpret_cast<const double *>(sp)));
+            __m128d x = _mm_cvtps_pd(xf);
+            __m128d y = _mm_add_pd(_mm_mul_pd(b0, x), s1);
+            s1 = _mm_add_pd(_mm_sub_pd(_mm_mul_pd(b1, x), _mm_mul_pd(a1, y)),
+                            s2);
+            s2 = _mm_sub_pd(_mm_mul_pd(b2, x), _mm_mul_pd(a2, y));
+            __m128d z = _mm_add_pd(y, t1);
+            t1 = _mm_add_pd(_mm_sub_pd(_mm_mul_pd(m2, y), _mm_mul_pd(h1, z)),
+                            t2);
+            t2 = _mm_sub_pd(y, _mm_mul_pd(h2, z));
+            acc = _mm_add_pd(acc, _mm_mul_pd(z, z));
+        }
+        _mm_storeu_pd(state,     s1);
+        _mm_storeu_pd(state + 2, s2);
+        _mm_storeu_pd(state + 4, t1);
+        _mm_storeu_pd(state + 6, t2);
+        if (sums)
+            _mm_storeu_pd(sums, _mm_add_pd(_mm_loadu_pd(sums), acc));
+    }
+#else
+    template <bool Single>
+    void filter_pair(const audio_sample *sp, size_t nframes, unsigned stride,
+                     const Coefs &k, double *state, double *sums)
+    {
+        for (unsigned lane = 0; lane < (Single ? 1 : 2); ++lane) {
+            double s1 = state[lane],     s2 = state[lane + 2];
+            double t1 = state[lane + 4], t2 = state[lane + 6];
+            double acc = 0;
+            const audio_sample *p = sp + lane;
+            for (size_t i = 0; i < nframes; ++i, p += stride) {
+                double x = *p;
+                double y = k.b0 * x + s1;
+                s1 = k.b1 * x - k.a1 * y + s2;
+                s2 = k.b2 * x - k.a2 * y;
+                double z = y + t1;
+                t1 = -2.0 * y - k.h1 * z + t2;
+                t2 = y - k.h2 * z;
+                acc += z * z;
+            }
+            state[lane]     = s1; state[lane + 2] = s2;
+            state[lane + 4] = t1; state[lane + 6] = t2;
+            if (sums)
+                sums[lane] += acc;
+        }
+    }
+#endif
+
+    /* BS.1770 channel weights by WAVEFORMATEXTENSIBLE speaker position */
+    double channel_weight(unsigned bit)
+    {
+        switch (bit) {
+        case 3:                     /* LFE */
+            return 0.0;
+        case 4: case 5:             /* BL, BR */
+        case 9: case 10:            /* SL, SR */
+            return 1.41;
+        }
+        return 1.0;
+    }
+}
+
+LoudnessMeter::LoudnessMeter(double sample_rate, unsigned channels,
+                             uint32_t channel_mask)
+    : m_channels(channels), m_pairs((channels + 1) / 2),
+      m_subblock_frames(subblock_frames(sample_rate)),
+      m_frames_in_subblock(0),
+      m_weights(2 * m_pairs, 1.0), m_state(8 * m_pairs),
+      m_sums(2 * m_pairs)
+{
+    /* coefficients of BS.1770 at 48 kHz, redesigned for the actual rate */
+    double K  = std::tan(PI * 1681.974450955533 / sample_rate);
+    double Q  = 0.7071752369554196;
+    double Vh = std::pow(10.0, 3.999843853973347 / 20);
+    double Vb = std::pow(Vh, 0.4996667741545416);
+    double a0 = 1 + K / Q + K * K;
+    m_shelf_b[0] = (Vh + Vb * K / Q + K * K) / a0;
+    m_shelf_b[1] = 2 * (K * K - Vh) / a0;
+    m_shelf_b[2] = (Vh - Vb * K / Q + K * K) / a0;
+    m_shelf_a[0] = 2 * (K * K - 1) / a0;
+    m_shelf_a[1] = (1 - K / Q + K * K) / a0;
+    K  = std::tan(PI * 38.13547087602444 / sample_rate);
+    Q  = 0.5003270373238773;
+    a0 = 1 + K / Q + K * K;
+    m_hipass_a[0] = 2 * (K * K - 1) / a0;
+    m_hipass_a[1] = (1 - K / Q + K * K) / a0;
+
+    if (Helpers::bitcount(channel_mask) == channels) {
+        unsigned ch = 0;
+        for (unsigned bit = 0; bit < 32; ++bit)
+            if (channel_mask & (1u << bit))
+                m_weights[ch++] = channel_weight(bit);
+    }
+    if (channels & 1)
+        m_weights[channels] = 0;
+}
+
+void LoudnessMeter::add(const audio_sample *src, size_t nframes,
+                        bool measure)
+{
+    if (!measure) {
+        filter(src, nframes, false);
+        return;
+    }
+    while (nframes) {
+        size_t n = std::min<size_t>(nframes,
+                                    m_subblock_frames - m_frames_in_subblock);
+        filter(src, n, true);
+        src     += n * m_channels;
+        nframes -= n;
+        m_frames_in_subblock += n;
+        if (m_frames_in_subblock == m_subblock_frames) {
+            double energy = 0;
+            for (size_t ch = 0; ch < m_sums.size(); ++ch) {
+                energy += m_weights[ch] * m_sums[ch];
+                m_sums[ch] = 0;
+            }
+            m_subblocks.push_back(energy / m_subblock_frames);
+            m_frames_in_subblock = 0;
+        }
+    }
+}
+
+void LoudnessMeter::filter(const audio_sample *src, size_t nframes,
+                           bool measure)
+{
+    Coefs k = { m_shelf_b[0], m_shelf_b[1], m_shelf_b[2],
+                m_shelf_a[0], m_shelf_a[1], m_hipass_a[0], m_hipass_a[1] };
+    for (unsigned p = 0; p < m_pairs; ++p) {
+        double *state = &m_state[8 * p];
+        double *sums  = measure ? &m_sums[2 * p] : 0;
+        if (2 * p + 1 < m_channels)
+            filter_pair<false>(src + 2 * p, nframes, m_channels, k,
+                               state, sums);
+        else
+            filter_pair<true>(src + 2 * p, nframes, m_channels, k,
+                              state, sums);
+        /* keep silence from decaying into denormals */
+        for (unsigned i = 0; i < 8; ++i)
+            if (std::fabs(state[i]) < 1e-30)
+                state[i] = 0;
+    }
+}
+
+double LoudnessMeter::integrated_loudness(
+        const std::vector<double> &subblocks)
+{
+    if (subblocks.size() < 4)
+        return -HUGE_VAL;
+    /* 400 ms blocks overlapping by 75%, gated at -70 LUFS, then -10 LU */
+    size_t nblocks = subblocks.size() - 3;
+    double gate = std::pow(10.0, (-70.0 + 0.691) / 10);
+    double mean = 0;
+    for (int pass = 0; pass < 2; ++pass) {
+        double sum = 0;
+        size_t count = 0;
+        for (size_t j = 0; j < nblocks; ++j) {
+            double z = (subblocks[j]     + subblocks[j + 1]
+                      + subblocks[j + 2] + subblocks[j + 3]) / 4;
+            if (z > gate) {
+                sum += z;
+                ++count;
+            }
+        }
+        if (!count)
+            return -HUGE_VAL;
+        mean = sum / count;
+        gate = std::max(gate, mean * 0.1);
+    }
+    return -0.691 + 10 * std::log10(mean);
+}
+
+namespace {
+    /* minimum length of a parallel segment, next to its priming */
+    const double MIN_SEGMENT_SECONDS = 10.0;
+    const double WARMUP_SECONDS      = 0.5;
+
+    struct Segment {
+        int64_t             begin;      /* decoded frames, priming included */
+        int64_t             end;
+        int64_t             warm_begin; /* filters are primed from here */
+        std::vector<double> subblocks;
+        float               peak;
+        std::exception_ptr  error;
+    };
+
+    /*
+     * Decodes and measures one segment. With read_mutex (segments run
+     * in parallel), decoding starts at the packet holding warm_begin,
+     * and reads are serialized; otherwise it starts at the beginning.
+     */
+    void scan_segment(std::shared_ptr<CAFFile> &demuxer, IDecoder *decoder,
+                      std::mutex *read_mutex, Segment *seg,
+                      abort_callback &abort)
+    {
+        const CAFFile::Format &format = demuxer->format();
+        auto     asbd = format.asbd;
+        uint32_t mask = format.channel_mask;
+        LoudnessMeter meter(asbd.mSampleRate, asbd.mChannelsPerFrame, mask);
+        PeakScanner   peaks(format);
+        audio_chunk_impl     chunk;
+        std::vector<uint8_t> buffer;
+
+        /* same chunking as input_caf */
+        uint32_t packets_per_chunk = 1;
+        if (asbd.mBytesPerPacket > 0) {
+            while (packets_per_chunk * asbd.mBytesPerPacket < 4096)
+                packets_per_chunk <<= 1;
+        }
+        int64_t packet = 0;
+        if (read_mutex)
+            packet = seg->warm_begin / asbd.mFramesPerPacket;
+        int64_t pos = packet * asbd.mFramesPerPacket;
+        int64_t num_packets = demuxer->num_packets();
+        decoder->reset_after_seek();
+        while (pos < seg->end && packet < num_packets) {
+            uint32_t n;
+            if (read_mutex) {
+                std::lock_guard<std::mutex> lock(*read_mutex);
+                n = demuxer->read_packets(packet, packets_per_chunk,
+                                          &buffer, abort);
+            } else {
+                n = demuxer->read_packets(packet, packets_per_chunk,
+                                          &buffer, abort);
+            }
+            if (!n)
+                break;
+            packet += n;
+            decoder->decode(buffer.data(), buffer.size(), chunk, abort);
+            unsigned channels = chunk.get_channels();
+            if (chunk.get_sample_count()
+             && channels != asbd.mChannelsPerFrame)
+                throw std::runtime_error("unexpected channel count");
+            const audio_sample *data = chunk.get_data();
+            int64_t chunk_end = pos + chunk.get_sample_count();
+
+            int64_t a = std::max(pos, seg->warm_begin);
+            int64_t b = std::min(chunk_end, seg->begin);
+            if (a < b)
+                meter.add(data + (a - pos) * channels, b - a, false);
+            a = std::max(pos, seg->begin);
+            b = std::min(chunk_end, seg->end);
+            if (a < b) {
+                meter.add(data + (a - pos) * channels, b - a);
+                peaks.add(data + (a - pos) * channels, b - a);
+            }
+            pos = chunk_end;
+        }
+        seg->subblocks = meter.subblocks();
+        seg->peak = 0;
+        for (size_t i = 0; i < peaks.peaks().size(); ++i)
+            seg->peak = std::max(seg->peak, peaks.peaks()[i].value);
+    }
+}
+
+void LoudnessScanner::scan(std::shared_ptr<CAFFile> &demuxer,
+                           unsigned nthreads, Result *result,
+                           abort_callback &abort)
+{
+    TraceSpan span("LoudnessScanner::scan");
+    auto     asbd     = demuxer->format().asbd;
+    int64_t  begin    = demuxer->start_offset();
+    int64_t  end      = begin + demuxer->duration();
+    uint32_t subblock = LoudnessMeter::subblock_frames(asbd.mSampleRate);
+
+    std::vector<Segment> segments;
+    Segment seg;
+    if (nthreads > 1 && asbd.mFramesPerPacket > 0
+     && IDecoder::is_intra_only_format(asbd.mFormatID)) {
+        /*
+         * A few segments per thread to even out the load; every one but
+         * the last is a whole number of sub-blocks.
+         */
+        int64_t len = std::max<int64_t>(
+                (end - begin) / (4 * nthreads),
+                MIN_SEGMENT_SECONDS * asbd.mSampleRate);
+        len = (len + subblock - 1) / subblock * subblock;
+        int64_t warm = WARMUP_SECONDS * asbd.mSampleRate;
+        for (int64_t pos = begin; pos < end; pos += len) {
+            seg.begin      = pos;
+            seg.end        = std::min(pos + len, end);
+            seg.warm_begin = std::max(begin, pos - warm);
+            segments.push_back(seg);
+        }
+    }
+    if (segments.size() < 2) {
+        seg.begin = seg.warm_begin = begin;
+        seg.end   = end;
+        auto decoder = IDecoder::create_decoder(demuxer, abort);
+        scan_segment(demuxer, decoder.get(), 0, &seg, abort);
+        result->loudness = LoudnessMeter::integrated_loudness(seg.subblocks);
+        result->peak     = seg.peak;
+        return;
+    }
+
+    nthreads = std::min<size_t>(nthreads, segments.size());
+    std::vector<std::shared_ptr<IDecoder>> decoders;
+    for (unsigned i = 0; i < nthreads; ++i)
+        decoders.push_back(IDecoder::create_decoder(demuxer, abort));
+    std::mutex              read_mutex, mutex;
+    std::condition_variable cond;
+    size_t                  remaining = segments.size();
+    {
+        ThreadPool pool(nthreads);
+        for (size_t i = 0; i < segments.size(); ++i) {
+            Segment *s = &segments[i];
+            pool.submit([&, s](unsigned worker) {
+                try {
+                    scan_segment(demuxer, decoders[worker].get(),
+                                 &read_mutex, s, abort);
+                } catch (...) {
+                    s->error = std::current_exception();
+                }
+                std::lock_guard<std::mutex> lock(mutex);
+                if (--remaining == 0)
+                    cond.notify_all();
+            });
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        cond.wait(lock, [&] { return remaining == 0; });
+    }
+    /* sub-blocks of consecutive segments line up; merging is appending */
+    std::vector<double> subblocks;
+    result->peak = 0;
+    for (size_t i = 0; i < segments.size(); ++i) {
+        if (segments[i].error)
+            std::rethrow_exception(segments[i].error);
+        subblocks.insert(subblocks.end(), segments[i].subblocks.begin(),
+                         segments[i].subblocks.end());
+        result->peak = std::max(result->peak, segments[i].peak);
+    }
+    result->loudness = LoudnessMeter::integrated_loudness(subblocks);
+}
+
+void LoudnessScanner::put_tags(const Result &result, CAFFile::tags_t *tags)
+{
+    char buf[32];
+    tags->remove("REPLAYGAIN_TRACK_GAIN");
+    if (std::isfinite(result.loudness)) {
+        std::snprintf(buf, sizeof buf, "%+.2f dB", result.gain());
+        tags->add("REPLAYGAIN_TRACK_GAIN", buf);
+    }
+    std::snprintf(buf, sizeof buf, "%.6f", result.peak);
+    tags->set("REPLAYGAIN_TRACK_PEAK", buf);
+}
@@ -0,0 +1,70 @@
+#ifndef LOUDNESS_H
+#define LOUDNESS_H
+
+#include "Decoder.h"
+
+/*
+ * ITU-R BS.1770-4 / EBU R128 integrated loudness.
+ * Energy is kept per 100 ms sub-block (the step of the 400 ms gating
+ * blocks), so that meters run over consecutive aligned ranges of a file
+ * can be merged by concatenating their sub-blocks.
+ */
+class LoudnessMeter {
+    unsigned            m_channels;
+    unsigned            m_pairs;
+    uint32_t            m_subblock_frames;
+    uint32_t            m_frames_in_subblock;
+    /* K-weighting: high shelf, then high pass (b0 = 1, b1 = -2, b2 = 1) */
+    double              m_shelf_b[3];
+    double              m_shelf_a[2];
+    double              m_hipass_a[2];
+    /* per channel, padded to whole pairs */
+    std::vector<double> m_weights;
+    std::vector<double> m_state;    /* 4 per channel, in pairs */
+    std::vector<double> m_sums;
+    /* weighted mean square of every completed sub-block */
+    std::vector<double> m_subblocks;
+public:
+    /* channel_mask 0: all channels weighted 1 */
+    LoudnessMeter(double sample_rate, unsigned channels,
+                  uint32_t channel_mask);
+    /*
+     * Interleaved, in decoder output order. With measure false, samples
+     * only prime the filters (for a meter starting in the middle of a
+     * file).
+     */
+    void add(const audio_sample *src, size_t nframes, bool measure=true);
+    const std::vector<double> &subblocks() const { return m_subblocks; }
+
+    static uint32_t subblock_frames(double sample_rate)
+    {
+        return static_cast<uint32_t>((sample_rate + 5) / 10);
+    }
+    /* gated loudness in LUFS, -HUGE_VAL when there is nothing to gate */
+    static double integrated_loudness(const std::vector<double> &subblocks);
+private:
+    void filter(const audio_sample *src, size_t nframes, bool measure);
+};
+
+/*
+ * Loudness and sample peak of a whole file. Intra-only codecs are split
+ * into segments aligned to sub-blocks, decoded and measured in parallel;
+ * each segment primes its filters on the audio just before it, so the
+ * merged result equals a sequential scan to double precision.
+ */
+class LoudnessScanner {
+public:
+    struct Result {
+        double loudness;    /* integrated, LUFS */
+        float  peak;
+        Result(): loudness(0), peak(0) {}
+        /* ReplayGain 2.0 track gain (-18 LUFS reference) */
+        double gain() const { return -18.0 - loudness; }
+    };
+    static void scan(std::shared_ptr<CAFFile> &demuxer, unsigned nthreads,
+                     Result *result, abort_callback &abort);
+    /* replaces ReplayGain track gain and peak in tags */
+    static void put_tags(const Result &result, CAFFile::tags_t *tags);
+};
+
+#endif
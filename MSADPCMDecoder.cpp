@@ -0,0 +1,126 @@
+#include "MSADPCMDecoder.h"
+#include "ADPCM.h"
+
+/*
+ * WAV-style MS ADPCM. Each packet is one block of mBytesPerPacket bytes:
+ *
+ *   uint8  predictor index [nchannels]
+ *   int16  delta           [nchannels]
+ *   int16  sample1         [nchannels]
+ *   int16  sample2         [nchannels]
+ *   nibbles, interleaved by channel, high nibble first
+ *
+ * sample2 and sample1 are the first two output frames.
+ */
+MSADPCMDecoder::MSADPCMDecoder(const CAFFile::Format &format)
+    : m_format(format)
+{
+    auto     asbd      = format.asbd;
+    unsigned nchannels = asbd.mChannelsPerFrame;
+
+    if (!nchannels || asbd.mBytesPerPacket <= 7 * nchannels)
+        throw std::runtime_error("invalid MS ADPCM block size");
+    unsigned capacity =
+        (asbd.mBytesPerPacket - 7 * nchannels) * 2 / nchannels + 2;
+    m_frames_per_block = asbd.mFramesPerPacket;
+    if (!m_frames_per_block || m_frames_per_block > capacity)
+        m_frames_per_block = capacity;
+
+    m_channel_pos = channel_positions(format);
+    m_coef1.resize(nchannels);
+    m_coef2.resize(nchannels);
+    m_delta.resize(nchannels);
+    m_sample1.resize(nchannels);
+    m_sample2.resize(nchannels);
+}
+
+void MSADPCMDecoder::get_info(file_info &info)
+{
+    info.info_set("codec",    "MS ADPCM");
+    info.info_set("encoding", "lossy");
+    info.info_set_int("samplerate", m_format.asbd.mSampleRate);
+    uint32_t channel_mask = m_format.channel_mask;
+    std::string channels;
+    if (channel_mask) {
+        channels = Helpers::describe_channels(channel_mask);
+        info.info_set("channels", channels.c_str());
+    } else {
+        info.info_set_int("channels", m_format.asbd.mChannelsPerFrame);
+    }
+}
+
+void MSADPCMDecoder::decode(const void *buffer, t_size bytes,
+                            audio_chunk &chunk, abort_callback &abort)
+{
+    auto     asbd      = m_format.asbd;
+    unsigned nchannels = asbd.mChannelsPerFrame;
+    unsigned nblocks   = bytes / asbd.mBytesPerPacket;
+    auto     bp        = static_cast<const uint8_t*>(buffer);
+    t_size   nframes   = nblocks * m_frames_per_block;
+
+    chunk.set_data_size(nframes * nchannels);
+    audio_sample *dp = chunk.get_data();
+    for (unsigned i = 0; i < nblocks; ++i) {
+        decode_block(bp, dp);
+        bp += asbd.mBytesPerPacket;
+        dp += m_frames_per_block * nchannels;
+    }
+    chunk.set_srate(asbd.mSampleRate);
+    chunk.set_channels(nchannels, channel_config(m_format));
+    chunk.set_sample_count(nframes);
+}
+
+void MSADPCMDecoder::decode_block(const uint8_t *bp, audio_sample *dp)
+{
+    const audio_sample scale = 1.0 / 32768.0;
+    unsigned nchannels = m_format.asbd.mChannelsPerFrame;
+    const unsigned *pos = m_channel_pos.data();
+    int32_t *coef1   = m_coef1.data();
+    int32_t *coef2   = m_coef2.data();
+    int32_t *delta   = m_delta.data();
+    int32_t *sample1 = m_sample1.data();
+    int32_t *sample2 = m_sample2.data();
+    unsigned ch;
+
+    for (ch = 0; ch < nchannels; ++ch) {
+        unsigned index = bp[ch] < 7 ? bp[ch] : 0;
+        coef1[ch] = ADPCM::ms_coef1[index];
+        coef2[ch] = ADPCM::ms_coef2[index];
+    }
+    bp += nchannels;
+    for (ch = 0; ch < nchannels; ++ch, bp += 2)
+        delta[ch]   = static_cast<int16_t>(bp[0] | (bp[1] << 8));
+    for (ch = 0; ch < nchannels; ++ch, bp += 2)
+        sample1[ch] = static_cast<int16_t>(bp[0] | (bp[1] << 8));
+    for (ch = 0; ch < nchannels; ++ch, bp += 2)
+        sample2[ch] = static_cast<int16_t>(bp[0] | (bp[1] << 8));
+
+    for (ch = 0; ch < nchannels; ++ch) {
+        dp[pos[ch]]             = sample2[ch] * scale;
+        dp[nchannels + pos[ch]] = sample1[ch] * scale;
+    }
+    dp += 2 * nchannels;
+
+    /*
+     * Nibbles run through the channels in order, so the n-th nibble of
+     * the block belongs to channel (n % nchannels).
+     */
+    unsigned nibble_index = 0;
+    for (unsigned i = 2; i < m_frames_per_block; ++i, dp += nchannels) {
+        for (ch = 0; ch < nchannels; ++ch, ++nibble_index) {
+            uint8_t  b      = bp[nibble_index >> 1];
+            unsigned nibble = (nibble_index & 1) ? b & 0xf : b >> 4;
+            int32_t  signed_nibble = (nibble ^ 8) - 8;
+            int32_t  predictor =
+                (sample1[ch] * coef1[ch] + sample2[ch] * coef2[ch]) >> 8;
+            predictor = ADPCM::clamp(predictor + signed_nibble * delta[ch],
+                                     -32768, 32767);
+            sample2[ch] = sample1[ch];
+            sample1[ch] = predictor;
+            delta[ch]   = (ADPCM::ms_adaptation_table[nibble] * delta[ch]) >> 8;
+            if (delta[ch] < 16)
+                delta[ch] = 16;
+            dp[pos[ch]] = predictor * scale;
+        }
+    }
+}
@@ -0,0 +1,25 @@
+#ifndef MSADPCMDECODER_H
+#define MSADPCMDECODER_H
+
+#include "Decoder.h"
+
+class MSADPCMDecoder: public DecoderBase {
+    CAFFile::Format       m_format;
+    unsigned              m_frames_per_block;
+    std::vector<unsigned> m_channel_pos;
+    /* decoder state, laid out so that each channel is one lane */
+    std::vector<int32_t>  m_coef1;
+    std::vector<int32_t>  m_coef2;
+    std::vector<int32_t>  m_delta;
+    std::vector<int32_t>  m_sample1;
+    std::vector<int32_t>  m_sample2;
+public:
+    MSADPCMDecoder(const CAFFile::Format &format);
+    void get_info(file_info &info);
+    void decode(const void *buffer, t_size bytes, audio_chunk &chunk,
+                abort_callback &abort);
+private:
+    void decode_block(const uint8_t *bp, audio_sample *dp);
+};
+
+#endif
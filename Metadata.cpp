@@ -126,13 +126,7 @@ namespace {
         { "WRITER",                     "lyricist"                      },
     };
 
-    typedef std::pair<std::string, std::string> string_pair;
-
-    string_pair make_string_pair(const char *first, const char *second)
-    {
-        return std::make_pair(std::string(first), std::string(second));
-    }
-    void put_entry(std::vector<string_pair> *meta, const char *key,
+    void put_entry(TagList *meta, const char *key,
                    const char *value, bool only_found=false)
     {
         typedef const char *entry_t[2];
@@ -150,49 +144,47 @@ namespace {
                                                Lambda::op));
         if (!entry && only_found)
             return;
-        std::string skey;
         if (entry)
-            skey = (*entry)[1];
+            meta->add((*entry)[1], value);
         else
-            std::transform(key, key + strlen(key), std::back_inserter(skey),
-                           toupper);
-        meta->push_back(make_string_pair(skey.c_str(), value));
+            meta->add(key, value, true);
     }
-    void put_rg(std::vector<string_pair> *meta, const file_info &info)
+    void put_rg(TagList *meta, const file_info &info)
     {
         replaygain_info rg = info.get_replaygain();
         char buf[replaygain_info::text_buffer_size];
 
         if (rg.is_album_gain_present()) {
             rg.format_album_gain(buf);
-            meta->push_back(make_string_pair("REPLAYGAIN_ALBUM_GAIN", buf));
+            meta->add("REPLAYGAIN_ALBUM_GAIN", buf);
         }
         if (rg.is_track_gain_present()) {
             rg.format_track_gain(buf);
-            meta->push_back(make_string_pair("REPLAYGAIN_TRACK_GAIN", buf));
+            meta->add("REPLAYGAIN_TRACK_GAIN", buf);
         }
         if (rg.is_album_peak_present()) {
             rg.format_album_peak(buf);
-            meta->push_back(make_string_pair("REPLAYGAIN_ALBUM_PEAK", buf));
+            meta->add("REPLAYGAIN_ALBUM_PEAK", buf);
         }
         if (rg.is_track_peak_present()) {
             rg.format_track_peak(buf);
-            meta->push_back(make_string_pair("REPLAYGAIN_TRACK_PEAK", buf));
+            meta->add("REPLAYGAIN_TRACK_PEAK", buf);
         }
     }
 }
 
 namespace Metadata {
-    void get_entries(file_info *info, const std::vector<string_pair> &meta)
+    void get_entries(file_info *info, const TagList &meta)
     {
         for (size_t i = 0; i < meta.size(); ++i)
-            get_entry(info, meta[i].first.c_str(), meta[i].second.c_str());
+            get_entry(info, meta.key(i), meta.value(i));
     }
 
-    void put_entries(std::vector<string_pair> *tags, const file_info &info)
+    void put_entries(TagList *tags, const file_info &info)
     {
         unsigned track = 0, track_total = 0, disc = 0, disc_total = 0;
-        std::vector<string_pair> meta;
+        TagList &meta = *tags;
+        meta.clear();
         t_size count = info.meta_get_count();
         for (t_size i = 0; i < count; ++i) {
             t_size vcount = info.meta_enum_value_count(i);
@@ -219,7 +211,7 @@ namespace Metadata {
                 char buf[256];
                 if (total) sprintf(buf, "%u/%u", number, total);
                 else       sprintf(buf, "%u", number);
-                meta.push_back(make_string_pair(name, buf));
+                meta.add(name, buf);
             }
         };
         put_number_pair("track number", track, track_total);
@@ -229,6 +221,5 @@ namespace Metadata {
         for (t_size i = 0; i < count; ++i)
             put_entry(&meta, info.info_enum_name(i), info.info_enum_value(i),
                       true);
-        tags->swap(meta);
     }
 }
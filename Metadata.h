@@ -1,16 +1,13 @@
 #ifndef METADATA_H
 #define METADATA_H
 
-#include <string>
-#include <vector>
-#include <utility>
 #include "../SDK/foobar2000-winver.h"
 #include "../SDK/foobar2000.h"
+#include "TagList.h"
 
 namespace Metadata {
-    typedef std::pair<std::string, std::string> string_pair;
-
-    void get_entries(file_info *info, const std::vector<string_pair> &meta);
-    void put_entries(std::vector<string_pair> *meta, const file_info &info);
+    void get_entries(file_info *info, const TagList &meta);
+    /* meta is cleared first, keeping its buffers */
+    void put_entries(TagList *meta, const file_info &info);
 }
 #endif
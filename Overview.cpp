@@ -0,0 +1,224 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include "Overview.h"
+#include "FrameReader.h"
+#include "Trace.h"
+
+namespace {
+    /* rounded outwards, so that points never understate the peaks */
+    int16_t to_int16(audio_sample v, bool round_up)
+    {
+        double x = v * 32768.0;
+        x = round_up ? std::ceil(x) : std::floor(x);
+        return static_cast<int16_t>(std::max(-32768.0, std::min(x, 32767.0)));
+    }
+
+    /* 0 .. n - 1, each half of the way between the ones so far */
+    std::vector<uint32_t> bit_reversed_order(uint32_t n)
+    {
+        unsigned bits = 0;
+        while ((uint64_t(1) << bits) < n)
+            ++bits;
+        std::vector<uint32_t> order;
+        order.reserve(n);
+        for (uint64_t i = 0; i < (uint64_t(1) << bits); ++i) {
+            uint64_t r = 0;
+            for (unsigned b = 0; b < bits; ++b)
+                r |= ((i >> b) & 1) << (bits - 1 - b);
+            if (r < n)
+                order.push_back(static_cast<uint32_t>(r));
+        }
+        return order;
+    }
+}
+
+OverviewBuilder::OverviewBuilder(const CAFFile::Format &format,
+                                 uint32_t frames_per_point)
+    : m_channels(format.asbd.mChannelsPerFrame), m_frames_in_point(0),
+      m_min(m_channels), m_max(m_channels)
+{
+    if (!frames_per_point)
+        throw std::runtime_error("invalid overview resolution");
+    m_overview.frames_per_point = frames_per_point;
+    m_coded.resize(m_channels);
+    for (unsigned i = 0; i < m_channels; ++i)
+        m_coded[i] = format.channel_map.size() == m_channels
+                   ? format.channel_map[i] : i;
+}
+
+void OverviewBuilder::add(const audio_chunk &chunk)
+{
+    if (chunk.get_channels() != m_channels)
+        throw std::runtime_error("channel count changed while decoding");
+    const audio_sample *p = chunk.get_data();
+    size_t nframes = chunk.get_sample_count();
+    uint32_t fpp = m_overview.frames_per_point;
+    while (nframes) {
+        if (!m_frames_in_point) {
+            std::copy(p, p + m_channels, m_min.begin());
+            std::copy(p, p + m_channels, m_max.begin());
+        }
+        size_t n = std::min<size_t>(nframes, fpp - m_frames_in_point);
+        for (size_t i = 0; i < n; ++i, p += m_channels) {
+            for (unsigned ch = 0; ch < m_channels; ++ch) {
+                m_min[ch] = std::min(m_min[ch], p[ch]);
+                m_max[ch] = std::max(m_max[ch], p[ch]);
+            }
+        }
+        nframes -= n;
+        m_frames_in_point += n;
+        if (m_frames_in_point == fpp)
+            flush();
+    }
+}
+
+const CAFFile::Overview &OverviewBuilder::finish()
+{
+    if (m_frames_in_point)
+        flush();
+    return m_overview;
+}
+
+void OverviewBuilder::flush()
+{
+    size_t base = m_overview.data.size();
+    m_overview.data.resize(base + 2 * m_channels);
+    int16_t *dp = &m_overview.data[base];
+    for (unsigned ch = 0; ch < m_channels; ++ch) {
+        dp[2 * m_coded[ch]]     = to_int16(m_min[ch], false);
+        dp[2 * m_coded[ch] + 1] = to_int16(m_max[ch], true);
+    }
+    m_frames_in_point = 0;
+}
+
+void OverviewBuilder::generate(std::shared_ptr<CAFFile> &demuxer,
+                               uint32_t frames_per_point,
+                               CAFFile::Overview *overview,
+                               abort_callback &abort)
+{
+    TraceSpan span("OverviewBuilder::generate");
+    OverviewBuilder builder(demuxer->primary_format(), frames_per_point);
+    IDecoder::decode_all(demuxer, abort, [&builder](const audio_chunk &c) {
+        builder.add(c);
+    });
+    *overview = builder.finish();
+}
+
+void SampledOverview::scan(const std::shared_ptr<CAFFile> &demuxer,
+                           const Options &options, SampledOverview *result,
+                           abort_callback &abort)
+{
+    TraceSpan span("SampledOverview::scan");
+    typedef std::chrono::steady_clock clock_type;
+    auto start = clock_type::now();
+    if (!demuxer->format().asbd.mFramesPerPacket)
+        throw std::runtime_error("variable frames per packet are not "
+                                 "supported");
+    if (!options.buckets || !options.samples_per_bucket
+     || !options.frames_per_sample)
+        throw std::runtime_error("invalid overview resolution");
+
+    FrameReader reader(demuxer, abort);
+    int64_t  fpp       = demuxer->format().asbd.mFramesPerPacket;
+    int64_t  offset    = demuxer->start_offset();
+    unsigned nchannels = reader.channels();
+    int64_t  length    = reader.length();
+    uint32_t nbuckets  = options.buckets;
+    SampledOverview &r = *result;
+    r.channels = nchannels;
+    r.min.assign(nbuckets * nchannels,
+                 std::numeric_limits<audio_sample>::max());
+    r.max.assign(nbuckets * nchannels,
+                 -std::numeric_limits<audio_sample>::max());
+    r.rms.assign(nbuckets * nchannels, 0);
+    r.samples.assign(nbuckets, 0);
+    r.frames_decoded = 0;
+
+    std::vector<audio_sample> buffer(options.frames_per_sample * nchannels);
+    void *planes[] = { buffer.data() };
+    IDecoder::Output out;
+    out.data = planes;
+    std::vector<double> sumsq(nbuckets * nchannels);
+    std::vector<uint64_t> frames(nbuckets);
+    std::vector<uint32_t> order = bit_reversed_order(nbuckets);
+    bool in_time = true;
+
+    /* a stretch for every bucket per pass, while there is time */
+    for (uint32_t pass = 0; in_time && pass < options.samples_per_bucket;
+         ++pass) {
+        for (size_t k = 0; k < order.size(); ++k) {
+            uint32_t b  = order[k];
+            int64_t  f0 = length * b / nbuckets;
+            int64_t  f1 = length * (b + 1) / nbuckets;
+            int64_t  n  = std::min<int64_t>(options.frames_per_sample,
+                                            f1 - f0);
+            /* empty when there are fewer frames than buckets */
+            if (n <= 0)
+                continue;
+            /* no more stretches than fit in the bucket side by side */
+            uint32_t nsamples = std::min<int64_t>(options.samples_per_bucket,
+                                                  std::max<int64_t>(
+                                                    (f1 - f0) / n, 1));
+            if (pass >= nsamples)
+                continue;
+            if (options.time_budget > 0 && r.frames_decoded
+             && std::chrono::duration<double>(clock_type::now() - start)
+                    .count() >= options.time_budget) {
+                in_time = false;
+                break;
+            }
+            /* centered in the pass-th of nsamples equal parts */
+            int64_t first = f0 + (f1 - f0) * (2 * pass + 1) / (2 * nsamples)
+                          - n / 2;
+            /* from a packet boundary, not to decode one more packet */
+            first = (first + offset) / fpp * fpp - offset;
+            first = std::max(f0, std::min(first, f1 - n));
+            size_t got = reader.read(first, n, out, abort);
+
+            const audio_sample *p = buffer.data();
+            audio_sample *lo = &r.min[b * nchannels];
+            audio_sample *hi = &r.max[b * nchannels];
+            double       *sq = &sumsq[b * nchannels];
+            for (size_t i = 0; i < got; ++i, p += nchannels) {
+                for (unsigned ch = 0; ch < nchannels; ++ch) {
+                    lo[ch] = std::min(lo[ch], p[ch]);
+                    hi[ch] = std::max(hi[ch], p[ch]);
+                    sq[ch] += static_cast<double>(p[ch]) * p[ch];
+                }
+            }
+            frames[b] += got;
+            r.frames_decoded += got;
+            if (got)
+                ++r.samples[b];
+        }
+    }
+    for (uint32_t b = 0; b < nbuckets; ++b) {
+        for (unsigned ch = 0; frames[b] && ch < nchannels; ++ch)
+            r.rms[b * nchannels + ch] =
+                std::sqrt(sumsq[b * nchannels + ch] / frames[b]);
+    }
+    /* the rest from the nearest sampled bucket, earlier one on a tie */
+    for (uint32_t b = 0; b < nbuckets; ++b) {
+        if (r.samples[b])
+            continue;
+        int64_t src = -1;
+        for (uint32_t d = 1; src < 0 && d < nbuckets; ++d) {
+            if (b >= d && r.samples[b - d])
+                src = b - d;
+            else if (b + d < nbuckets && r.samples[b + d])
+                src = b + d;
+        }
+        if (src < 0) {
+            /* nothing decoded at all: silence */
+            std::fill_n(&r.min[b * nchannels], nchannels, 0);
+            std::fill_n(&r.max[b * nchannels], nchannels, 0);
+            continue;
+        }
+        std::copy_n(&r.min[src * nchannels], nchannels, &r.min[b * nchannels]);
+        std::copy_n(&r.max[src * nchannels], nchannels, &r.max[b * nchannels]);
+        std::copy_n(&r.rms[src * nchannels], nchannels, &r.rms[b * nchannels]);
+    }
+}
@@ -0,0 +1,72 @@
+#ifndef OVERVIEW_H
+#define OVERVIEW_H
+
+#include "Decoder.h"
+
+/*
+ * Builds the min/max overview stored in an ovvw chunk from decoded audio,
+ * a point at a time as chunks come in.
+ */
+class OverviewBuilder {
+    CAFFile::Overview         m_overview;
+    unsigned                  m_channels;
+    /* coded (file) channel of each channel in decoder output order */
+    std::vector<unsigned>     m_coded;
+    uint32_t                  m_frames_in_point;
+    std::vector<audio_sample> m_min;
+    std::vector<audio_sample> m_max;
+public:
+    enum { DEFAULT_FRAMES_PER_POINT = 4096 };
+
+    OverviewBuilder(const CAFFile::Format &format,
+                    uint32_t frames_per_point=DEFAULT_FRAMES_PER_POINT);
+    void add(const audio_chunk &chunk);
+    /* completes the last point, which may be short */
+    const CAFFile::Overview &finish();
+
+    /* decodes the whole file in one pass and returns its overview */
+    static void generate(std::shared_ptr<CAFFile> &demuxer,
+                         uint32_t frames_per_point,
+                         CAFFile::Overview *overview, abort_callback &abort);
+private:
+    void flush();
+};
+
+/*
+ * Approximate overview, for waveforms and scrubbing when there is no ovvw
+ * chunk to read: min, max and RMS per bucket, from a few short stretches
+ * per bucket decoded through FrameReader (so after the decoder's minimal
+ * preroll) instead of from every packet.
+ *
+ * Buckets are visited in bit-reversed order, so that the stretches
+ * decoded when the time budget runs out are spread over the whole file;
+ * buckets left without one take the values of the nearest one that has.
+ */
+struct SampledOverview {
+    struct Options {
+        uint32_t buckets;
+        uint32_t samples_per_bucket;  /* stretches decoded, at most */
+        uint32_t frames_per_sample;
+        double   time_budget;         /* in seconds, 0 for none */
+
+        Options(): buckets(1000), samples_per_bucket(1),
+                   frames_per_sample(4096), time_budget(0) {}
+    };
+    unsigned                  channels;
+    /* [bucket * channels + channel], channels in decoder output order */
+    std::vector<audio_sample> min;
+    std::vector<audio_sample> max;
+    std::vector<audio_sample> rms;
+    /* stretches decoded in each bucket, 0 where a neighbour's were taken */
+    std::vector<uint32_t>     samples;
+    uint64_t                  frames_decoded;
+
+    SampledOverview(): channels(0), frames_decoded(0) {}
+
+    uint32_t buckets() const { return samples.size(); }
+    static void scan(const std::shared_ptr<CAFFile> &demuxer,
+                     const Options &options, SampledOverview *result,
+                     abort_callback &abort);
+};
+
+#endif
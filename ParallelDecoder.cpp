@@ -0,0 +1,109 @@
+#include <chrono>
+#include "ParallelDecoder.h"
+#include "Trace.h"
+
+ParallelDecoder::ParallelDecoder(std::shared_ptr<CAFFile> &demuxer,
+                                 uint32_t packets_per_job, unsigned nthreads,
+                                 abort_callback &abort,
+                                 const IDecoder::Options &options)
+    : m_demuxer(demuxer), m_next_packet(0),
+      m_packets_per_job(packets_per_job), m_max_jobs(nthreads * 2)
+{
+    for (unsigned i = 0; i < nthreads; ++i)
+        m_decoders.push_back(IDecoder::create_decoder(demuxer, abort,
+                                                      options));
+    m_pool.reset(new ThreadPool(nthreads));
+}
+
+ParallelDecoder::~ParallelDecoder()
+{
+    cancel_all();
+    m_pool.reset();
+}
+
+void ParallelDecoder::reset(int64_t packet)
+{
+    cancel_all();
+    m_next_packet = packet;
+}
+
+uint32_t ParallelDecoder::decode(audio_chunk &chunk, abort_callback &abort)
+{
+    fill(abort);
+    if (m_jobs.empty())
+        return 0;
+    std::shared_ptr<Job> job = m_jobs.front();
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (!job->done) {
+            abort.check();
+            m_cond.wait_for(lock, std::chrono::milliseconds(10));
+        }
+    }
+    m_jobs.pop_front();
+    if (job->error)
+        std::rethrow_exception(job->error);
+    const audio_chunk &src = job->chunk;
+    chunk.set_data(src.get_data(), src.get_sample_count(),
+                   src.get_channels(), src.get_srate(),
+                   src.get_channel_config());
+    m_free_jobs.push_back(job);
+    /* keep the workers busy while the caller consumes this chunk */
+    fill(abort);
+    return job->npackets;
+}
+
+void ParallelDecoder::fill(abort_callback &abort)
+{
+    while (m_jobs.size() < m_max_jobs
+        && m_next_packet < m_demuxer->num_packets())
+    {
+        std::shared_ptr<Job> job;
+        if (m_free_jobs.size()) {
+            job = m_free_jobs.back();
+            m_free_jobs.pop_back();
+            job->done = false;
+        } else {
+            job = std::make_shared<Job>();
+        }
+        job->npackets = m_demuxer->read_packets(m_next_packet,
+                                                m_packets_per_job,
+                                                &job->data, abort);
+        if (!job->npackets)
+            break;
+        m_next_packet += job->npackets;
+        m_jobs.push_back(job);
+
+        auto decoders = &m_decoders;
+        auto mutex    = &m_mutex;
+        auto cond     = &m_cond;
+        auto counters = &m_demuxer->counters();
+        m_pool->submit([job, decoders, mutex, cond,
+                        counters](unsigned worker) {
+            if (!job->cancelled) {
+                try {
+                    TraceSpan span("ParallelDecoder job");
+                    PerfTimer timer(counters, PerfCounters::DECODE_NS);
+                    abort_callback_dummy noabort;
+                    (*decoders)[worker]->decode(job->data.data(),
+                                                job->data.size(),
+                                                job->chunk, noabort);
+                } catch (...) {
+                    job->error = std::current_exception();
+                }
+            }
+            {
+                std::lock_guard<std::mutex> lock(*mutex);
+                job->done = true;
+            }
+            cond->notify_all();
+        });
+    }
+}
+
+void ParallelDecoder::cancel_all()
+{
+    for (auto it = m_jobs.begin(); it != m_jobs.end(); ++it)
+        (*it)->cancelled = true;
+    m_jobs.clear();
+}
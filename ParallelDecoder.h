@@ -0,0 +1,58 @@
+#ifndef PARALLELDECODER_H
+#define PARALLELDECODER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include "Decoder.h"
+#include "ThreadPool.h"
+
+/*
+ * Frame-parallel decoding for codecs without inter-packet dependency.
+ * Packet ranges are read on the caller's thread, decoded on a thread pool
+ * where every worker owns a decoder instance, and handed back in packet
+ * order through a bounded reorder buffer.
+ */
+class ParallelDecoder {
+    struct Job {
+        std::vector<uint8_t> data;
+        audio_chunk_impl     chunk;
+        uint32_t             npackets;
+        bool                 done;
+        std::atomic<bool>    cancelled;
+        std::exception_ptr   error;
+        Job(): npackets(0), done(false), cancelled(false) {}
+    };
+    std::shared_ptr<CAFFile>               m_demuxer;
+    std::vector<std::shared_ptr<IDecoder>> m_decoders;
+    std::deque<std::shared_ptr<Job>>       m_jobs;
+    /* finished jobs, reused with their buffers */
+    std::vector<std::shared_ptr<Job>>      m_free_jobs;
+    std::mutex                             m_mutex;
+    std::condition_variable                m_cond;
+    int64_t                                m_next_packet;
+    uint32_t                               m_packets_per_job;
+    unsigned                               m_max_jobs;
+    /* declared last, so that workers are joined before anything else dies */
+    std::unique_ptr<ThreadPool>            m_pool;
+public:
+    ParallelDecoder(std::shared_ptr<CAFFile> &demuxer,
+                    uint32_t packets_per_job, unsigned nthreads,
+                    abort_callback &abort,
+                    const IDecoder::Options &options=IDecoder::Options());
+    ~ParallelDecoder();
+    /* drop everything queued and restart at the given packet */
+    void reset(int64_t packet);
+    /* returns number of packets the chunk covers, 0 at the end */
+    uint32_t decode(audio_chunk &chunk, abort_callback &abort);
+private:
+    ParallelDecoder(const ParallelDecoder &);
+    ParallelDecoder& operator=(const ParallelDecoder &);
+
+    void fill(abort_callback &abort);
+    void cancel_all();
+};
+
+#endif
@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PEAK_SSE2
+#endif
+#include "PeakScanner.h"
+#include "Trace.h"
+
+namespace {
+    void block_peaks_scalar(const audio_sample *src, size_t nframes,
+                            unsigned channels, audio_sample *peaks)
+    {
+        std::fill(peaks, peaks + channels, audio_sample(0));
+        for (size_t i = 0; i < nframes; ++i, src += channels)
+            for (unsigned ch = 0; ch < channels; ++ch) {
+                audio_sample v = std::fabs(src[ch]);
+                if (v > peaks[ch]) /* false for NaN */
+                    peaks[ch] = v;
+            }
+    }
+#ifdef PEAK_SSE2
+    enum { MAX_SIMD_CHANNELS = 16 };
+    /*
+     * V vectors make a whole number of frames (4V a multiple of C), so
+     * lane j of accumulator k always holds channel (4k + j) % C and the
+     * loop runs without shuffles; lanes are sorted out once at the end.
+     * V is at least 4, so that mono and stereo aren't latency bound.
+     * C is fixed for the common layouts, so that accumulators stay in
+     * registers.
+     */
+    template <unsigned C>
+    void block_peaks(const audio_sample *src, size_t nframes,
+                     unsigned channels, audio_sample *peaks)
+    {
+        enum { V_MAX = C ? (C < 4 ? 4 : C) : MAX_SIMD_CHANNELS };
+        const unsigned nc  = C ? C : channels;
+        const unsigned nv  = C ? V_MAX : nc;
+        const unsigned fpi = 4 * nv / nc;   /* frames per iteration */
+        const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+        __m128 acc[V_MAX];
+        for (unsigned k = 0; k < nv; ++k)
+            acc[k] = _mm_setzero_ps();
+        size_t i = 0;
+        for (; i + fpi <= nframes; i += fpi, src += 4 * nv) {
+            for (unsigned k = 0; k < nv; ++k) {
+                __m128 v = _mm_and_ps(_mm_loadu_ps(src + 4 * k), abs_mask);
+                /* NaN in v yields acc */
+                acc[k] = _mm_max_ps(v, acc[k]);
+            }
+        }
+        float lanes[4 * V_MAX];
+        for (unsigned k = 0; k < nv; ++k)
+            _mm_storeu_ps(lanes + 4 * k, acc[k]);
+        block_peaks_scalar(src, nframes - i, nc, peaks);
+        for (unsigned j = 0; j < 4 * nv; ++j)
+            peaks[j % nc] = std::max(peaks[j % nc], lanes[j]);
+    }
+#endif
+
+    PeakScanner::block_peaks_t select_block_peaks(unsigned channels)
+    {
+#ifdef PEAK_SSE2
+        switch (channels) {
+        case 1: return block_peaks<1>;
+        case 2: return block_peaks<2>;
+        case 4: return block_peaks<4>;
+        case 6: return block_peaks<6>;
+        case 8: return block_peaks<8>;
+        }
+        if (channels <= MAX_SIMD_CHANNELS)
+            return block_peaks<0>;
+#endif
+        return block_peaks_scalar;
+    }
+}
+
+PeakScanner::PeakScanner(const CAFFile::Format &format)
+    : m_channels(format.asbd.mChannelsPerFrame), m_frames(0),
+      m_block_peaks(m_channels),
+      m_block_peaks_fn(select_block_peaks(m_channels))
+{
+    CAFFile::Peak zero = { 0, 0 };
+    m_peaks.assign(m_channels, zero);
+    m_coded.resize(m_channels);
+    for (unsigned i = 0; i < m_channels; ++i)
+        m_coded[i] = format.channel_map.size() == m_channels
+                   ? format.channel_map[i] : i;
+}
+
+void PeakScanner::add(const audio_chunk &chunk)
+{
+    if (chunk.get_channels() != m_channels)
+        throw std::runtime_error("channel count changed while decoding");
+    add(chunk.get_data(), chunk.get_sample_count());
+}
+
+void PeakScanner::add(const audio_sample *src, size_t nframes)
+{
+    m_block_peaks_fn(src, nframes, m_channels, m_block_peaks.data());
+    /*
+     * The position is only looked for in the rare chunk that raises a
+     * peak.
+     */
+    for (unsigned ch = 0; ch < m_channels; ++ch) {
+        CAFFile::Peak &peak = m_peaks[m_coded[ch]];
+        audio_sample v = m_block_peaks[ch];
+        if (v <= peak.value)
+            continue;
+        size_t i = 0;
+        while (i < nframes && std::fabs(src[i * m_channels + ch]) != v)
+            ++i;
+        peak.value = v;
+        peak.frame = m_frames + i;
+    }
+    m_frames += nframes;
+}
+
+void PeakScanner::scan(std::shared_ptr<CAFFile> &demuxer,
+                       std::vector<CAFFile::Peak> *peaks,
+                       abort_callback &abort)
+{
+    TraceSpan span("PeakScanner::scan");
+    PeakScanner scanner(demuxer->primary_format());
+    IDecoder::decode_all(demuxer, abort, [&scanner](const audio_chunk &c) {
+        scanner.add(c);
+    });
+    *peaks = scanner.peaks();
+}
@@ -0,0 +1,35 @@
+#ifndef PEAKSCANNER_H
+#define PEAKSCANNER_H
+
+#include "Decoder.h"
+
+/*
+ * Per-channel absolute peak and its position over decoded audio, as
+ * stored in a peak chunk.
+ */
+class PeakScanner {
+public:
+    typedef void (*block_peaks_t)(const audio_sample *src, size_t nframes,
+                                  unsigned channels, audio_sample *peaks);
+private:
+    unsigned                   m_channels;
+    std::vector<unsigned>      m_coded;
+    uint64_t                   m_frames;
+    std::vector<CAFFile::Peak> m_peaks;
+    std::vector<audio_sample>  m_block_peaks;
+    block_peaks_t              m_block_peaks_fn;
+public:
+    explicit PeakScanner(const CAFFile::Format &format);
+    void add(const audio_chunk &chunk);
+    /* interleaved, in decoder output order */
+    void add(const audio_sample *src, size_t nframes);
+    /* in file (coded) channel order */
+    const std::vector<CAFFile::Peak> &peaks() const { return m_peaks; }
+
+    /* decodes the whole file in one pass and returns its peaks */
+    static void scan(std::shared_ptr<CAFFile> &demuxer,
+                     std::vector<CAFFile::Peak> *peaks,
+                     abort_callback &abort);
+};
+
+#endif
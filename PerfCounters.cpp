@@ -0,0 +1,34 @@
+#include <sstream>
+#include "PerfCounters.h"
+
+const char *PerfCounters::name(Counter c)
+{
+    static const char *names[NUM_COUNTERS] = {
+        "read_packets calls",
+        "packet bytes read",
+        "seeks",
+        "packets decoded",
+        "decode time (ms)",
+        "conversion/remap time (ms)",
+        "trim time (ms)",
+        "seek preroll packets",
+        "peak packet buffer (bytes)",
+        "peak chunk size (samples)",
+    };
+    return names[c];
+}
+
+std::string PerfCounters::report() const
+{
+    std::stringstream ss;
+    for (unsigned i = 0; i < NUM_COUNTERS; ++i) {
+        Counter c = static_cast<Counter>(i);
+        ss << name(c) << ": ";
+        if (c == DECODE_NS || c == CONVERT_NS || c == TRIM_NS)
+            ss << get(c) / 1e6;
+        else
+            ss << get(c);
+        ss << "\n";
+    }
+    return ss.str();
+}
@@ -0,0 +1,94 @@
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/*
+ * Per-instance hot path counters.
+ * Updates are relaxed atomics (the decode-ahead worker and the parallel
+ * decoder bump them from other threads); define CAF_NO_PERF_COUNTERS to
+ * compile them out entirely.
+ */
+class PerfCounters {
+public:
+    enum Counter {
+        READ_CALLS,         /* CAFFile::read_packets() calls */
+        BYTES_READ,         /* packet bytes read */
+        SEEKS,              /* seeks issued for packet reads */
+        PACKETS_DECODED,
+        DECODE_NS,          /* in IDecoder::decode(), summed over threads */
+        CONVERT_NS,         /* sample format conversion and channel remap */
+        TRIM_NS,            /* start skip / end trim */
+        PREROLL_PACKETS,    /* decoded and discarded after seeking */
+        PEAK_PACKET_BUFFER, /* bytes */
+        PEAK_CHUNK_SAMPLES,
+        NUM_COUNTERS
+    };
+private:
+    std::atomic<uint64_t> m_values[NUM_COUNTERS];
+public:
+    PerfCounters() { reset(); }
+    void reset()
+    {
+        for (unsigned i = 0; i < NUM_COUNTERS; ++i)
+            m_values[i].store(0, std::memory_order_relaxed);
+    }
+    void add(Counter c, uint64_t n)
+    {
+#ifndef CAF_NO_PERF_COUNTERS
+        m_values[c].fetch_add(n, std::memory_order_relaxed);
+#endif
+    }
+    void peak(Counter c, uint64_t n)
+    {
+#ifndef CAF_NO_PERF_COUNTERS
+        uint64_t cur = m_values[c].load(std::memory_order_relaxed);
+        while (cur < n && !m_values[c].compare_exchange_weak(
+                                cur, n, std::memory_order_relaxed))
+            ;
+#endif
+    }
+    uint64_t get(Counter c) const
+    {
+        return m_values[c].load(std::memory_order_relaxed);
+    }
+    static const char *name(Counter c);
+    /* one "name: value" line per counter */
+    std::string report() const;
+private:
+    PerfCounters(const PerfCounters &);
+    PerfCounters& operator=(const PerfCounters &);
+};
+
+/* adds the lifetime of the object to a *_NS counter */
+class PerfTimer {
+#ifndef CAF_NO_PERF_COUNTERS
+    typedef std::chrono::steady_clock clock_type;
+    PerfCounters           *m_counters;
+    PerfCounters::Counter   m_counter;
+    clock_type::time_point  m_start;
+public:
+    PerfTimer(PerfCounters *counters, PerfCounters::Counter counter)
+        : m_counters(counters), m_counter(counter)
+    {
+        if (m_counters)
+            m_start = clock_type::now();
+    }
+    ~PerfTimer()
+    {
+        if (m_counters) {
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            clock_type::now() - m_start).count();
+            m_counters->add(m_counter, ns);
+        }
+    }
+#else
+public:
+    PerfTimer(PerfCounters *, PerfCounters::Counter) {}
+#endif
+};
+
+#endif
@@ -0,0 +1,204 @@
+#ifndef PORTABLE_H
+#define PORTABLE_H
+
+/*
+ * The demuxer and the native decoders are written against a handful of
+ * foobar2000 SDK types. When built as a standalone library (CAF_PORTABLE,
+ * see CMakeLists.txt), minimal stand-ins for those types are provided here
+ * instead, so that the core can be built and profiled without the SDK.
+ */
+#ifndef CAF_PORTABLE
+
+#include "../SDK/foobar2000-winver.h"
+#include "../SDK/foobar2000.h"
+
+#else
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+typedef size_t   t_size;
+typedef uint64_t t_filesize;
+typedef float    audio_sample;
+
+struct GUID {
+    uint32_t Data1;
+    uint16_t Data2;
+    uint16_t Data3;
+    uint8_t  Data4[8];
+};
+
+class exception_aborted: public std::runtime_error {
+public:
+    exception_aborted(): std::runtime_error("aborted") {}
+};
+
+class abort_callback {
+public:
+    virtual ~abort_callback() {}
+    virtual bool is_aborting() const = 0;
+    void check() const
+    {
+        if (is_aborting())
+            throw exception_aborted();
+    }
+};
+
+class abort_callback_dummy: public abort_callback {
+public:
+    bool is_aborting() const { return false; }
+};
+
+class abort_callback_impl: public abort_callback {
+    std::atomic<bool> m_aborting;
+public:
+    abort_callback_impl(): m_aborting(false) {}
+    bool is_aborting() const { return m_aborting; }
+    void abort() { m_aborting = true; }
+    void reset() { m_aborting = false; }
+};
+
+/*
+ * Sample sink: interleaved float samples plus the stream parameters,
+ * with the subset of the audio_chunk interface the decoders use.
+ */
+class audio_chunk {
+    std::vector<audio_sample> m_data;
+    unsigned                  m_sample_rate;
+    unsigned                  m_channels;
+    unsigned                  m_channel_config;
+    size_t                    m_sample_count;
+public:
+    audio_chunk()
+        : m_sample_rate(0), m_channels(0), m_channel_config(0),
+          m_sample_count(0)
+    {}
+    virtual ~audio_chunk() {}
+
+    audio_sample *get_data() { return m_data.data(); }
+    const audio_sample *get_data() const { return m_data.data(); }
+    t_size get_data_size() const { return m_data.size(); }
+    void set_data_size(t_size size)
+    {
+        if (m_data.size() < size)
+            m_data.resize(size);
+    }
+    unsigned get_srate() const { return m_sample_rate; }
+    void set_srate(unsigned rate) { m_sample_rate = rate; }
+    unsigned get_channels() const { return m_channels; }
+    unsigned get_channel_config() const { return m_channel_config; }
+    void set_channels(unsigned channels, unsigned config)
+    {
+        m_channels       = channels;
+        m_channel_config = config;
+    }
+    t_size get_sample_count() const { return m_sample_count; }
+    void set_sample_count(t_size count) { m_sample_count = count; }
+
+    void set_data(const audio_sample *src, t_size samples, unsigned channels,
+                  unsigned rate, unsigned config)
+    {
+        set_data_size(samples * channels);
+        if (samples)
+            std::memcpy(m_data.data(), src,
+                        samples * channels * sizeof(audio_sample));
+        set_srate(rate);
+        set_channels(channels, config);
+        set_sample_count(samples);
+    }
+    void reset()
+    {
+        m_sample_rate = m_channels = m_channel_config = 0;
+        m_sample_count = 0;
+    }
+    /* same bit assignment as WAVEFORMATEXTENSIBLE dwChannelMask */
+    static unsigned g_guess_channel_config(unsigned channels)
+    {
+        switch (channels) {
+        case 1: return 0x4;
+        case 2: return 0x3;
+        case 3: return 0x7;
+        case 4: return 0x33;
+        case 5: return 0x37;
+        case 6: return 0x3f;
+        case 7: return 0x13f;
+        case 8: return 0x63f;
+        }
+        return 0;
+    }
+};
+
+class audio_chunk_impl: public audio_chunk {};
+
+/*
+ * Technical info only; tags are handled as plain key/value pairs by
+ * CAFFile in this build.
+ */
+class file_info {
+    std::vector<std::pair<std::string, std::string> > m_info;
+public:
+    virtual ~file_info() {}
+    void info_set(const char *name, const char *value)
+    {
+        for (size_t i = 0; i < m_info.size(); ++i) {
+            if (m_info[i].first == name) {
+                m_info[i].second = value;
+                return;
+            }
+        }
+        m_info.push_back(std::make_pair(std::string(name),
+                                        std::string(value)));
+    }
+    void info_set_int(const char *name, int64_t value)
+    {
+        info_set(name, std::to_string(value).c_str());
+    }
+    const char *info_get(const char *name) const
+    {
+        for (size_t i = 0; i < m_info.size(); ++i)
+            if (m_info[i].first == name)
+                return m_info[i].second.c_str();
+        return 0;
+    }
+    int64_t info_get_int(const char *name) const
+    {
+        const char *value = info_get(name);
+        return value ? std::strtoll(value, 0, 10) : 0;
+    }
+    t_size info_get_count() const { return m_info.size(); }
+    const char *info_enum_name(t_size i) const
+    {
+        return m_info[i].first.c_str();
+    }
+    const char *info_enum_value(t_size i) const
+    {
+        return m_info[i].second.c_str();
+    }
+};
+
+class file_info_impl: public file_info {};
+
+/* one line to stderr per instance */
+class FB2K_console_formatter {
+    std::stringstream m_ss;
+public:
+    ~FB2K_console_formatter() { std::cerr << m_ss.str() << std::endl; }
+    template <typename T>
+    FB2K_console_formatter &operator<<(const T &value)
+    {
+        m_ss << value;
+        return *this;
+    }
+};
+
+#endif
+
+#endif
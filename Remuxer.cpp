@@ -0,0 +1,543 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include "BitReader.h"
+#include "Remuxer.h"
+#include "Trace.h"
+
+namespace {
+    bool is_aac(uint32_t format_id)
+    {
+        return format_id == FOURCC('a','a','c',' ')
+            || format_id == FOURCC('a','a','c','h')
+            || format_id == FOURCC('a','a','c','p');
+    }
+
+    /* what goes into the ADTS header, taken from an AudioSpecificConfig */
+    struct ADTSConfig {
+        unsigned profile;   /* object type - 1 */
+        unsigned sf_index;
+        unsigned channels;
+    };
+
+    unsigned read_object_type(BitReader &br)
+    {
+        unsigned aot = br.read(5);
+        return aot == 31 ? 32 + br.read(6) : aot;
+    }
+
+    bool parse_asc(const std::vector<uint8_t> &asc, ADTSConfig *config)
+    {
+        std::vector<uint8_t> buf(asc);
+        buf.resize(asc.size() + BitReader::PADDING);
+        BitReader br(buf.data(), asc.size());
+        unsigned aot      = read_object_type(br);
+        unsigned sf_index = br.read(4);
+        if (sf_index == 15)
+            br.skip(24);
+        unsigned channels = br.read(4);
+        if (aot == 5 || aot == 29) {
+            /* explicit SBR / PS; the core rate comes first, then its type */
+            if (br.read(4) == 15)
+                br.skip(24);
+            aot = read_object_type(br);
+        }
+        if (br.overrun() || aot < 1 || aot > 4 || sf_index > 12
+         || channels < 1 || channels > 7)
+            return false;
+        config->profile  = aot - 1;
+        config->sf_index = sf_index;
+        config->channels = channels;
+        return true;
+    }
+
+    void put_adts_header(const ADTSConfig &config, size_t frame_length,
+                         uint8_t *h)
+    {
+        /* MPEG-4, no CRC, buffer fullness 0x7ff (VBR), one raw block */
+        h[0] = 0xff;
+        h[1] = 0xf1;
+        h[2] = config.profile << 6 | config.sf_index << 2
+             | config.channels >> 2;
+        h[3] = (config.channels & 3) << 6 | frame_length >> 11;
+        h[4] = (frame_length >> 3) & 0xff;
+        h[5] = (frame_length & 7) << 5 | 0x1f;
+        h[6] = 0xfc;
+    }
+
+    /*
+     * Metadata blocks following "fLaC" in the cookie, up to the one
+     * flagged last (which is flagged again in case the cookie ends
+     * without one).
+     */
+    bool flac_metadata(const std::vector<uint8_t> &cookie,
+                       std::vector<uint8_t> *blocks)
+    {
+        /* STREAMINFO (type 0, 34 bytes) must come first, complete */
+        if (cookie.size() < 4 + 4 + 34
+         || std::memcmp(cookie.data(), "fLaC", 4) || (cookie[4] & 0x7f)
+         || (cookie[5] << 16 | cookie[6] << 8 | cookie[7]) != 34)
+            return false;
+        blocks->assign(cookie.begin() + 4, cookie.end());
+        std::vector<uint8_t> &b = *blocks;
+        size_t pos = 0, last = 0;
+        while (pos + 4 <= b.size()) {
+            size_t len = b[pos + 1] << 16 | b[pos + 2] << 8 | b[pos + 3];
+            if (pos + 4 + len > b.size())
+                break;
+            bool is_last = (b[pos] & 0x80) != 0;
+            b[pos] &= 0x7f;
+            last = pos;
+            pos += 4 + len;
+            if (is_last)
+                break;
+        }
+        if (!pos)
+            return false;
+        b.resize(pos);
+        b[last] |= 0x80;
+        return true;
+    }
+
+    unsigned flac_bits_per_sample(const std::vector<uint8_t> &blocks)
+    {
+        const uint8_t *si = blocks.data() + 4;
+        return ((si[12] & 1) << 4 | si[13] >> 4) + 1;
+    }
+
+    /* ISO BMFF boxes, serialized into a buffer */
+    class BoxWriter {
+        std::vector<uint8_t> *m_buf;
+        std::vector<size_t>   m_open;
+    public:
+        explicit BoxWriter(std::vector<uint8_t> *buf): m_buf(buf) {}
+
+        void u8(uint32_t v) { m_buf->push_back(v & 0xff); }
+        void u16(uint32_t v) { put(v, 2); }
+        void u24(uint32_t v) { put(v, 3); }
+        void u32(uint32_t v) { put(v, 4); }
+        void u64(uint64_t v) { put(v, 8); }
+        void bytes(const void *data, size_t size)
+        {
+            auto p = static_cast<const uint8_t *>(data);
+            m_buf->insert(m_buf->end(), p, p + size);
+        }
+        void fourcc(const char *type) { bytes(type, 4); }
+        void zeros(size_t n) { m_buf->resize(m_buf->size() + n); }
+        size_t position() const { return m_buf->size(); }
+        void patch32(size_t pos, uint32_t v)
+        {
+            for (int i = 3; i >= 0; --i, v >>= 8)
+                (*m_buf)[pos + i] = v & 0xff;
+        }
+
+        void begin(const char *type)
+        {
+            m_open.push_back(m_buf->size());
+            u32(0);
+            fourcc(type);
+        }
+        void begin_full(const char *type, unsigned version, uint32_t flags)
+        {
+            begin(type);
+            u8(version);
+            u24(flags);
+        }
+        void end()
+        {
+            size_t pos = m_open.back();
+            m_open.pop_back();
+            patch32(pos, m_buf->size() - pos);
+        }
+        /* MPEG-4 descriptor header, with the 4 byte length form */
+        void descriptor(unsigned tag, uint32_t size)
+        {
+            u8(tag);
+            u8(0x80 | (size >> 21 & 0x7f));
+            u8(0x80 | (size >> 14 & 0x7f));
+            u8(0x80 | (size >> 7 & 0x7f));
+            u8(size & 0x7f);
+        }
+    private:
+        void put(uint64_t v, unsigned n)
+        {
+            for (unsigned i = n; i > 0; --i)
+                m_buf->push_back((v >> (8 * (i - 1))) & 0xff);
+        }
+    };
+
+    void put_matrix(BoxWriter &w)
+    {
+        static const uint32_t unity[9] = {
+            0x10000, 0, 0, 0, 0x10000, 0, 0, 0, 0x40000000
+        };
+        for (int i = 0; i < 9; ++i)
+            w.u32(unity[i]);
+    }
+
+    void put_esds(BoxWriter &w, CAFFile *demuxer,
+                  const std::vector<uint8_t> &asc)
+    {
+        auto     asbd     = demuxer->format().asbd;
+        uint32_t max_size = 0, size;
+        for (int64_t i = 0; i < demuxer->num_packets(); ++i) {
+            demuxer->packet_info(i, &size);
+            max_size = std::max(max_size, size);
+        }
+        double packets_per_sec = asbd.mSampleRate / asbd.mFramesPerPacket;
+        uint32_t dsi_size = 5 + asc.size();
+        uint32_t dcd_size = 5 + 13 + dsi_size;
+
+        w.begin_full("esds", 0, 0);
+        w.descriptor(3, 3 + dcd_size + 6);      /* ES_Descriptor */
+        w.u16(0);                               /* ES_ID */
+        w.u8(0);
+        w.descriptor(4, 13 + dsi_size);         /* DecoderConfig */
+        w.u8(0x40);                             /* MPEG-4 audio */
+        w.u8(0x15);                             /* audio stream */
+        w.u24(max_size);
+        w.u32(static_cast<uint32_t>(max_size * 8 * packets_per_sec));
+        w.u32(demuxer->bitrate() * 1000);
+        w.descriptor(5, asc.size());            /* DecSpecificInfo */
+        w.bytes(asc.data(), asc.size());
+        w.descriptor(6, 1);                     /* SLConfig */
+        w.u8(2);
+        w.end();
+    }
+
+    void put_sample_entry(BoxWriter &w, CAFFile *demuxer)
+    {
+        auto asbd = demuxer->format().asbd;
+        std::vector<uint8_t> cookie, blocks;
+        demuxer->get_magic_cookie(&cookie);
+        uint32_t rate = static_cast<uint32_t>(asbd.mSampleRate + .5);
+        unsigned bits = 16;
+        const char *type = "mp4a";
+        if (asbd.mFormatID == FOURCC('a','l','a','c')) {
+            /* version/flags, then ALACSpecificConfig */
+            if (cookie.size() < 28)
+                throw std::runtime_error("ALAC configuration is missing");
+            cookie.resize(28);
+            bits = cookie[9];
+            type = "alac";
+        } else if (asbd.mFormatID == FOURCC('f','l','a','c')) {
+            if (!flac_metadata(cookie, &blocks))
+                throw std::runtime_error("FLAC STREAMINFO is missing");
+            bits = flac_bits_per_sample(blocks);
+            type = "fLaC";
+        } else if (cookie.empty()) {
+            throw std::runtime_error("AudioSpecificConfig is missing");
+        }
+
+        w.begin(type);
+        w.zeros(6);
+        w.u16(1);                   /* data_reference_index */
+        w.zeros(8);
+        w.u16(asbd.mChannelsPerFrame);
+        w.u16(bits);
+        w.u32(0);
+        w.u32(rate < 65536 ? rate << 16 : 0);
+        if (asbd.mFormatID == FOURCC('a','l','a','c')) {
+            w.begin("alac");
+            w.bytes(cookie.data(), cookie.size());
+            w.end();
+        } else if (asbd.mFormatID == FOURCC('f','l','a','c')) {
+            w.begin_full("dfLa", 0, 0);
+            w.bytes(blocks.data(), blocks.size());
+            w.end();
+        } else {
+            put_esds(w, demuxer, cookie);
+        }
+        w.end();
+    }
+
+    /* iTunes style gapless info, as a freeform tag */
+    void put_itunsmpb(BoxWriter &w, CAFFile *demuxer)
+    {
+        char smpb[160];
+        int n = std::snprintf(smpb, sizeof smpb,
+                              " 00000000 %08X %08X %016llX",
+                              static_cast<unsigned>(demuxer->start_offset()),
+                              demuxer->end_padding(),
+                              static_cast<unsigned long long>(
+                                  demuxer->duration()));
+        for (int i = 0; i < 8; ++i)
+            n += std::snprintf(smpb + n, sizeof smpb - n, " 00000000");
+
+        w.begin("udta");
+        w.begin_full("meta", 0, 0);
+        w.begin_full("hdlr", 0, 0);
+        w.u32(0);
+        w.fourcc("mdir");
+        w.fourcc("appl");
+        w.zeros(9);
+        w.end();
+        w.begin("ilst");
+        w.begin("----");
+        w.begin_full("mean", 0, 0);
+        w.bytes("com.apple.iTunes", 16);
+        w.end();
+        w.begin_full("name", 0, 0);
+        w.bytes("iTunSMPB", 8);
+        w.end();
+        w.begin("data");
+        w.u32(1);                   /* UTF-8 */
+        w.u32(0);
+        w.bytes(smpb, n);
+        w.end();
+        w.end();
+        w.end();
+        w.end();
+        w.end();
+    }
+
+    /* ftyp and moov of a fragmented file, with a single audio track */
+    void put_init_segment(BoxWriter &w, CAFFile *demuxer)
+    {
+        auto     asbd      = demuxer->format().asbd;
+        uint32_t timescale = static_cast<uint32_t>(asbd.mSampleRate + .5);
+        uint64_t total     = demuxer->num_packets() * asbd.mFramesPerPacket;
+
+        w.begin("ftyp");
+        w.fourcc("iso6");
+        w.u32(0);
+        w.fourcc("iso6");
+        w.fourcc("mp41");
+        w.fourcc("M4A ");
+        w.end();
+
+        w.begin("moov");
+        w.begin_full("mvhd", 0, 0);
+        w.u32(0);
+        w.u32(0);
+        w.u32(timescale);
+        w.u32(0);                   /* durations are in the fragments */
+        w.u32(0x10000);
+        w.u16(0x100);
+        w.zeros(10);
+        put_matrix(w);
+        w.zeros(24);
+        w.u32(2);                   /* next_track_ID */
+        w.end();
+
+        w.begin("trak");
+        w.begin_full("tkhd", 0, 3); /* enabled, in movie */
+        w.u32(0);
+        w.u32(0);
+        w.u32(1);                   /* track_ID */
+        w.u32(0);
+        w.u32(0);
+        w.zeros(8);
+        w.u16(0);
+        w.u16(1);                   /* alternate_group */
+        w.u16(0x100);
+        w.u16(0);
+        put_matrix(w);
+        w.u32(0);
+        w.u32(0);
+        w.end();
+        /* play duration() frames, skipping the priming */
+        w.begin("edts");
+        w.begin_full("elst", 1, 0);
+        w.u32(1);
+        w.u64(demuxer->duration());
+        w.u64(demuxer->start_offset());
+        w.u16(1);
+        w.u16(0);
+        w.end();
+        w.end();
+        w.begin("mdia");
+        w.begin_full("mdhd", 0, 0);
+        w.u32(0);
+        w.u32(0);
+        w.u32(timescale);
+        w.u32(0);
+        w.u16(0x55c4);              /* "und" */
+        w.u16(0);
+        w.end();
+        w.begin_full("hdlr", 0, 0);
+        w.u32(0);
+        w.fourcc("soun");
+        w.zeros(12);
+        w.bytes("SoundHandler", 13);
+        w.end();
+        w.begin("minf");
+        w.begin_full("smhd", 0, 0);
+        w.u32(0);
+        w.end();
+        w.begin("dinf");
+        w.begin_full("dref", 0, 0);
+        w.u32(1);
+        w.begin_full("url ", 0, 1); /* in this file */
+        w.end();
+        w.end();
+        w.end();
+        w.begin("stbl");
+        w.begin_full("stsd", 0, 0);
+        w.u32(1);
+        put_sample_entry(w, demuxer);
+        w.end();
+        const char *empty[] = { "stts", "stsc", "stco" };
+        for (int i = 0; i < 3; ++i) {
+            w.begin_full(empty[i], 0, 0);
+            w.u32(0);
+            w.end();
+        }
+        w.begin_full("stsz", 0, 0);
+        w.u32(0);
+        w.u32(0);
+        w.end();
+        w.end();
+        w.end();
+        w.end();
+        w.end();
+
+        w.begin("mvex");
+        w.begin_full("mehd", 1, 0);
+        w.u64(total);
+        w.end();
+        w.begin_full("trex", 0, 0);
+        w.u32(1);
+        w.u32(1);                   /* sample description */
+        w.u32(asbd.mFramesPerPacket);
+        w.u32(0);
+        w.u32(0);
+        w.end();
+        w.end();
+        put_itunsmpb(w, demuxer);
+        w.end();
+    }
+
+    /* moof and the mdat header for packets of the given sizes */
+    void put_fragment(BoxWriter &w, uint32_t sequence, uint64_t decode_time,
+                      const std::vector<uint32_t> &sizes, size_t data_size)
+    {
+        size_t moof = w.position();
+        w.begin("moof");
+        w.begin_full("mfhd", 0, 0);
+        w.u32(sequence);
+        w.end();
+        w.begin("traf");
+        w.begin_full("tfhd", 0, 0x020000);      /* default-base-is-moof */
+        w.u32(1);
+        w.end();
+        w.begin_full("tfdt", 1, 0);
+        w.u64(decode_time);
+        w.end();
+        w.begin_full("trun", 0, 0x000201);      /* data offset, sizes */
+        w.u32(sizes.size());
+        size_t data_offset = w.position();
+        w.u32(0);
+        for (size_t i = 0; i < sizes.size(); ++i)
+            w.u32(sizes[i]);
+        w.end();
+        w.end();
+        w.end();
+        w.patch32(data_offset, w.position() - moof + 8);
+        w.u32(8 + data_size);
+        w.fourcc("mdat");
+    }
+}
+
+bool Remuxer::can_remux(const CAFFile::Format &format, Container container)
+{
+    uint32_t id = format.asbd.mFormatID;
+    switch (container) {
+    case ADTS:
+        return is_aac(id);
+    case FLAC:
+        return id == FOURCC('f','l','a','c');
+    case MP4:
+        return (is_aac(id) || id == FOURCC('a','l','a','c')
+             || id == FOURCC('f','l','a','c'))
+            && format.asbd.mFramesPerPacket > 0;
+    }
+    return false;
+}
+
+void Remuxer::remux(std::shared_ptr<CAFFile> &demuxer, Container container,
+                    IByteSource *dst, abort_callback &abort)
+{
+    TraceSpan span("Remuxer::remux");
+    if (!can_remux(demuxer->format(), container))
+        throw std::runtime_error("the codec cannot be stored in this "
+                                 "container");
+    auto asbd = demuxer->format().asbd;
+    std::vector<uint8_t> cookie, out, data;
+    demuxer->get_magic_cookie(&cookie);
+    ADTSConfig adts = { 0 };
+    BoxWriter w(&out);
+    if (container == ADTS && !parse_asc(cookie, &adts))
+        throw std::runtime_error("the AAC configuration cannot be carried "
+                                 "in ADTS");
+    if (container == FLAC) {
+        if (!flac_metadata(cookie, &data))
+            throw std::runtime_error("FLAC STREAMINFO is missing");
+        out.assign(cookie.begin(), cookie.begin() + 4);
+        out.insert(out.end(), data.begin(), data.end());
+        dst->write(out.data(), out.size(), abort);
+    } else if (container == MP4) {
+        put_init_segment(w, demuxer.get());
+        dst->write(out.data(), out.size(), abort);
+    }
+
+    int64_t  num_packets = demuxer->num_packets();
+    uint64_t decode_time = 0;
+    uint32_t sequence    = 0;
+    std::vector<uint32_t> sizes;
+    for (int64_t packet = 0; packet < num_packets; ) {
+        abort.check();
+        sizes.clear();
+        uint64_t bytes = 0;
+        uint32_t size;
+        while (packet + sizes.size() < num_packets && bytes < BATCH_BYTES) {
+            demuxer->packet_info(packet + sizes.size(), &size);
+            sizes.push_back(size);
+            bytes += size;
+        }
+        uint32_t n = demuxer->read_packets(packet, sizes.size(), &data,
+                                           abort);
+        if (!n)
+            break;
+        packet += n;
+        /* keep only the packets that were read in whole, and stop there */
+        if (n < sizes.size()) {
+            sizes.resize(n);
+            packet = num_packets;
+        }
+        size_t whole = 0;
+        for (uint32_t i = 0; i < n; ++i) {
+            if (whole + sizes[i] > data.size()) {
+                sizes.resize(i);
+                packet = num_packets;
+                break;
+            }
+            whole += sizes[i];
+        }
+        if (sizes.empty())
+            break;
+        n = sizes.size();
+        data.resize(whole);
+
+        out.clear();
+        if (container == ADTS) {
+            const uint8_t *p = data.data();
+            for (uint32_t i = 0; i < n; p += sizes[i++]) {
+                if (sizes[i] > 8191 - 7)
+                    throw std::runtime_error("AAC frame too large for ADTS");
+                out.resize(out.size() + 7);
+                put_adts_header(adts, sizes[i] + 7, &out[out.size() - 7]);
+                out.insert(out.end(), p, p + sizes[i]);
+            }
+            dst->write(out.data(), out.size(), abort);
+            continue;
+        }
+        if (container == MP4) {
+            put_fragment(w, ++sequence, decode_time, sizes, data.size());
+            dst->write(out.data(), out.size(), abort);
+            decode_time += n * asbd.mFramesPerPacket;
+        }
+        dst->write(data.data(), data.size(), abort);
+    }
+}
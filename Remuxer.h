@@ -0,0 +1,29 @@
+#ifndef REMUXER_H
+#define REMUXER_H
+
+#include "CAFFile.h"
+
+/*
+ * Copies the packets of a CAF file into another container without
+ * decoding them:
+ *
+ *   ADTS  AAC (the core layer of HE-AAC, as ADTS cannot signal SBR)
+ *   FLAC  native FLAC stream
+ *   MP4   fragmented MP4 of AAC, ALAC or FLAC; priming and remainder go
+ *         into an edit list and an iTunSMPB tag
+ *
+ * Packets are read BATCH_BYTES at a time (one fragment each in MP4) and
+ * written out as they come, so memory use does not grow with the file.
+ * The output is written sequentially from its current position.
+ */
+class Remuxer {
+public:
+    enum Container { ADTS, FLAC, MP4 };
+    enum { BATCH_BYTES = 1 << 20 };
+
+    static bool can_remux(const CAFFile::Format &format, Container container);
+    static void remux(std::shared_ptr<CAFFile> &demuxer, Container container,
+                      IByteSource *dst, abort_callback &abort);
+};
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef SPSCRING_H
+#define SPSCRING_H
+
+#include <atomic>
+#include <vector>
+
+/*
+ * Lock-free single-producer/single-consumer ring of preallocated slots.
+ * The producer fills write_slot() and then publish()es it; the consumer
+ * uses read_slot() and then release()s it. Slots are reused, so whatever
+ * buffers they own stay allocated across laps.
+ */
+template <typename T>
+class SPSCRing {
+    std::vector<T>      m_slots;
+    std::atomic<size_t> m_head; /* next slot to read, advanced by consumer */
+    std::atomic<size_t> m_tail; /* next slot to write, advanced by producer */
+public:
+    explicit SPSCRing(size_t capacity)
+        : m_slots(capacity ? capacity : 1), m_head(0), m_tail(0)
+    {}
+    size_t capacity() const { return m_slots.size(); }
+
+    /* producer side: returns 0 when full */
+    T *write_slot()
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) == m_slots.size())
+            return 0;
+        return &m_slots[tail % m_slots.size()];
+    }
+    void publish()
+    {
+        m_tail.store(m_tail.load(std::memory_order_relaxed) + 1,
+                     std::memory_order_release);
+    }
+    /* consumer side: returns 0 when empty */
+    T *read_slot()
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire))
+            return 0;
+        return &m_slots[head % m_slots.size()];
+    }
+    void release()
+    {
+        m_head.store(m_head.load(std::memory_order_relaxed) + 1,
+                     std::memory_order_release);
+    }
+    /* only while the producer is stopped */
+    void clear()
+    {
+        m_head.store(m_tail.load(std::memory_order_acquire),
+                     std::memory_order_release);
+    }
+private:
+    SPSCRing(const SPSCRing &);
+    SPSCRing& operator=(const SPSCRing &);
+};
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef SAMPLESTORE_H
+#define SAMPLESTORE_H
+
+#include <cmath>
+#include <cstdint>
+
+/*
+ * Output sample formats of IDecoder::decode_into(), from integer samples
+ * (left justified into 32 bits) or from float ones (full scale 1.0).
+ * Integers are rounded to nearest and clipped; there is no dither.
+ */
+namespace SampleStore {
+    template <unsigned Bits>
+    inline int32_t narrow(int32_t v)
+    {
+        const int64_t max = (int64_t(1) << (Bits - 1)) - 1;
+        int64_t r = (static_cast<int64_t>(v) + (int64_t(1) << (31 - Bits)))
+                    >> (32 - Bits);
+        return static_cast<int32_t>(r > max ? max : r);
+    }
+    template <unsigned Bits>
+    inline int32_t quantize(double x)
+    {
+        const double max = static_cast<double>((int64_t(1) << (Bits - 1)) - 1);
+        double v = std::floor(x * (max + 1) + 0.5);
+        if (v > max) v = max;
+        if (v < -max - 1) v = -max - 1;
+        return static_cast<int32_t>(v);
+    }
+
+    struct Float32 {
+        typedef float type;
+        static float from_int(int32_t v)
+        {
+            return v * (1.0f / 2147483648.0f);
+        }
+        static float from_float(double x) { return static_cast<float>(x); }
+    };
+    struct Int16 {
+        typedef int16_t type;
+        static int16_t from_int(int32_t v)
+        {
+            return static_cast<int16_t>(narrow<16>(v));
+        }
+        static int16_t from_float(double x)
+        {
+            return static_cast<int16_t>(quantize<16>(x));
+        }
+    };
+    /* 24 bit values in the low bits of 32, sign extended */
+    struct Int24In32 {
+        typedef int32_t type;
+        static int32_t from_int(int32_t v) { return narrow<24>(v); }
+        static int32_t from_float(double x) { return quantize<24>(x); }
+    };
+    struct Int32 {
+        typedef int32_t type;
+        static int32_t from_int(int32_t v) { return v; }
+        static int32_t from_float(double x) { return quantize<32>(x); }
+    };
+}
+
+#endif
@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <cctype>
+#include "TagList.h"
+
+namespace {
+    int compare_nocase(const char *a, const char *b)
+    {
+        for (;; ++a, ++b) {
+            int ca = std::tolower(static_cast<unsigned char>(*a));
+            int cb = std::tolower(static_cast<unsigned char>(*b));
+            if (ca != cb || !ca)
+                return ca - cb;
+        }
+    }
+}
+
+int64_t TagList::info_size() const
+{
+    int64_t n = 4;
+    for (size_t i = 0; i < m_entries.size(); ++i)
+        n += m_entries[i].key_size + m_entries[i].value_size + 2;
+    return n;
+}
+
+void TagList::add(const char *key, size_t key_size,
+                  const char *value, size_t value_size, bool upcase_key)
+{
+    Entry e;
+    e.key        = m_arena.size();
+    e.key_size   = key_size;
+    e.value      = e.key + key_size + 1;
+    e.value_size = value_size;
+    m_arena.insert(m_arena.end(), key, key + key_size);
+    m_arena.push_back(0);
+    m_arena.insert(m_arena.end(), value, value + value_size);
+    m_arena.push_back(0);
+    if (upcase_key) {
+        char *p = m_arena.data() + e.key;
+        std::transform(p, p + key_size, p, [](char c) -> char {
+            return std::toupper(static_cast<unsigned char>(c));
+        });
+    }
+    m_entries.push_back(e);
+    m_index_valid = false;
+}
+
+void TagList::assign(std::vector<char> &payload, uint32_t count_hint)
+{
+    m_arena.swap(payload);
+    m_entries.clear();
+    m_index_valid = false;
+    /* the count comes from the file; don't let it size anything alone */
+    m_entries.reserve(std::min<size_t>(count_hint, m_arena.size() / 2));
+
+    const char *begin = m_arena.data();
+    const char *end   = begin + m_arena.size();
+    const char *p     = begin;
+    while (p < end) {
+        auto key_end = static_cast<const char *>(std::memchr(p, 0, end - p));
+        if (!key_end)
+            break;
+        auto val_end = static_cast<const char *>(
+                std::memchr(key_end + 1, 0, end - key_end - 1));
+        if (!val_end)
+            break;
+        Entry e;
+        e.key        = p - begin;
+        e.key_size   = key_end - p;
+        e.value      = key_end + 1 - begin;
+        e.value_size = val_end - key_end - 1;
+        m_entries.push_back(e);
+        p = val_end + 1;
+    }
+}
+
+void TagList::serialize(std::vector<uint8_t> *buf) const
+{
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        const Entry &e = m_entries[i];
+        const char *p = m_arena.data();
+        buf->insert(buf->end(), p + e.key, p + e.key + e.key_size + 1);
+        buf->insert(buf->end(), p + e.value, p + e.value + e.value_size + 1);
+    }
+}
+
+const char *TagList::find(const char *key) const
+{
+    if (!m_index_valid) {
+        m_index.resize(m_entries.size());
+        for (size_t i = 0; i < m_index.size(); ++i)
+            m_index[i] = i;
+        std::stable_sort(m_index.begin(), m_index.end(),
+                         [this](uint32_t a, uint32_t b) {
+                             return compare_nocase(this->key(a),
+                                                   this->key(b)) < 0;
+                         });
+        m_index_valid = true;
+    }
+    auto it = std::lower_bound(m_index.begin(), m_index.end(), key,
+                               [this](uint32_t a, const char *k) {
+                                   return compare_nocase(this->key(a), k) < 0;
+                               });
+    if (it == m_index.end() || compare_nocase(this->key(*it), key))
+        return 0;
+    return value(*it);
+}
+
+void TagList::remove(const char *key)
+{
+    auto end = std::remove_if(m_entries.begin(), m_entries.end(),
+                              [this, key](const Entry &e) {
+                                  return !compare_nocase(
+                                      m_arena.data() + e.key, key);
+                              });
+    if (end != m_entries.end()) {
+        m_entries.erase(end, m_entries.end());
+        m_index_valid = false;
+    }
+}
+
+bool TagList::operator==(const TagList &other) const
+{
+    if (size() != other.size())
+        return false;
+    for (size_t i = 0; i < size(); ++i) {
+        if (key_size(i) != other.key_size(i)
+         || value_size(i) != other.value_size(i)
+         || std::memcmp(key(i), other.key(i), key_size(i))
+         || std::memcmp(value(i), other.value(i), value_size(i)))
+            return false;
+    }
+    return true;
+}
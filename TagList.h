@@ -0,0 +1,82 @@
+#ifndef TAGLIST_H
+#define TAGLIST_H
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/*
+ * info chunk entries, kept as one arena of NUL terminated keys and values
+ * (laid out as in the file) plus offsets into it.
+ * Whatever the number of entries, a list costs three allocations, and
+ * clear() keeps them for reuse.
+ */
+class TagList {
+    struct Entry {
+        uint32_t key;
+        uint32_t key_size;
+        uint32_t value;
+        uint32_t value_size;
+    };
+    std::vector<char>             m_arena;
+    std::vector<Entry>            m_entries;
+    /* entry indices sorted by key, case insensitive; built on demand */
+    mutable std::vector<uint32_t> m_index;
+    mutable bool                  m_index_valid;
+public:
+    TagList(): m_index_valid(false) {}
+
+    size_t size() const { return m_entries.size(); }
+    bool empty() const { return m_entries.empty(); }
+    const char *key(size_t i) const
+    {
+        return m_arena.data() + m_entries[i].key;
+    }
+    size_t key_size(size_t i) const { return m_entries[i].key_size; }
+    const char *value(size_t i) const
+    {
+        return m_arena.data() + m_entries[i].value;
+    }
+    size_t value_size(size_t i) const { return m_entries[i].value_size; }
+    /* payload size of an info chunk holding these */
+    int64_t info_size() const;
+
+    void clear()
+    {
+        m_arena.clear();
+        m_entries.clear();
+        m_index_valid = false;
+    }
+    void add(const char *key, size_t key_size,
+             const char *value, size_t value_size, bool upcase_key=false);
+    void add(const char *key, const char *value, bool upcase_key=false)
+    {
+        add(key, std::strlen(key), value, std::strlen(value), upcase_key);
+    }
+    /*
+     * Takes over the payload of an info chunk (after the entry count);
+     * a key without value at the end is dropped.
+     */
+    void assign(std::vector<char> &payload, uint32_t count_hint);
+    /* appends entries as stored in an info chunk */
+    void serialize(std::vector<uint8_t> *buf) const;
+
+    /* value of the first entry with the key (case insensitive), or 0 */
+    const char *find(const char *key) const;
+    /*
+     * Removes the entries with the key (case insensitive); their text
+     * stays in the arena until clear().
+     */
+    void remove(const char *key);
+    /* replaces the entries with the key by one at the end */
+    void set(const char *key, const char *value)
+    {
+        remove(key);
+        add(key, value);
+    }
+
+    bool operator==(const TagList &other) const;
+    bool operator!=(const TagList &other) const { return !(*this == other); }
+};
+
+#endif
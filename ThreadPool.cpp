@@ -0,0 +1,89 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(unsigned nthreads)
+    : m_pending(0), m_next(0), m_quit(false)
+{
+    if (!nthreads)
+        nthreads = 1;
+    for (unsigned i = 0; i < nthreads; ++i)
+        m_queues.push_back(std::unique_ptr<Queue>(new Queue()));
+    for (unsigned i = 0; i < nthreads; ++i)
+        m_threads.push_back(std::thread(&ThreadPool::run, this, i));
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_cond.notify_all();
+    for (size_t i = 0; i < m_threads.size(); ++i)
+        m_threads[i].join();
+}
+
+void ThreadPool::submit(const task_t &task)
+{
+    unsigned index;
+    /*
+     * Count the task before it becomes visible, so that a worker never
+     * takes a task that has not been accounted for.
+     */
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        index = m_next++ % m_queues.size();
+        ++m_pending;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_queues[index]->mutex);
+        m_queues[index]->tasks.push_back(task);
+    }
+    m_cond.notify_one();
+}
+
+void ThreadPool::run(unsigned index)
+{
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cond.wait(lock, [this]() { return m_quit || m_pending > 0; });
+            if (m_quit)
+                return;
+        }
+        task_t task;
+        if (take(index, &task)) {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                --m_pending;
+            }
+            task(index);
+        } else {
+            /* pending task is queued but not visible yet; retry */
+            std::this_thread::yield();
+        }
+    }
+}
+
+bool ThreadPool::take(unsigned index, task_t *task)
+{
+    size_t n = m_queues.size();
+    {
+        Queue *q = m_queues[index].get();
+        std::lock_guard<std::mutex> lock(q->mutex);
+        if (q->tasks.size()) {
+            *task = std::move(q->tasks.front());
+            q->tasks.pop_front();
+            return true;
+        }
+    }
+    for (size_t i = 1; i < n; ++i) {
+        Queue *q = m_queues[(index + i) % n].get();
+        std::lock_guard<std::mutex> lock(q->mutex);
+        if (q->tasks.size()) {
+            *task = std::move(q->tasks.back());
+            q->tasks.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
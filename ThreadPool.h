@@ -0,0 +1,49 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * Small work-stealing thread pool.
+ * Every worker has its own queue; submit() distributes tasks round robin,
+ * a worker takes from the front of its own queue and steals from the back
+ * of the others when it runs dry.
+ * Tasks receive the index of the worker running them, so that callers
+ * can keep per-worker state (such as a decoder instance) without locking.
+ */
+class ThreadPool {
+public:
+    typedef std::function<void(unsigned)> task_t;
+private:
+    struct Queue {
+        std::mutex         mutex;
+        std::deque<task_t> tasks;
+    };
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread>            m_threads;
+    std::mutex                          m_mutex;
+    std::condition_variable             m_cond;
+    unsigned                            m_pending;
+    unsigned                            m_next;
+    bool                                m_quit;
+public:
+    explicit ThreadPool(unsigned nthreads);
+    ~ThreadPool();
+    unsigned size() const { return m_threads.size(); }
+    void submit(const task_t &task);
+private:
+    ThreadPool(const ThreadPool &);
+    ThreadPool& operator=(const ThreadPool &);
+
+    void run(unsigned index);
+    bool take(unsigned index, task_t *task);
+};
+
+#endif
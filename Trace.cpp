@@ -0,0 +1,152 @@
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+#include "Trace.h"
+
+namespace {
+    typedef std::chrono::steady_clock clock_type;
+
+    struct Event {
+        const char *name;
+        uint64_t    start;
+        uint64_t    end;
+    };
+    /*
+     * Written only by the owning thread; count is published with release
+     * semantics so that take_events() can read concurrently. A block is
+     * done with once next is set, as that only happens when it is full.
+     */
+    struct Block {
+        enum { CAPACITY = 4096 };
+        Event                 events[CAPACITY];
+        std::atomic<unsigned> count;
+        std::atomic<Block *>  next;
+        Block(): count(0), next(0) {}
+    };
+    struct ThreadBuffer {
+        unsigned tid;
+        Block   *head;          /* oldest block not yet taken */
+        unsigned taken;         /* events of head already taken */
+        Block   *tail;          /* owning thread only */
+    };
+
+    /* cap on memory held by trace buffers */
+    const uint64_t MAX_EVENTS = 1 << 20;
+
+    const clock_type::time_point g_epoch = clock_type::now();
+    /* events held, i.e. recorded but not yet taken */
+    std::atomic<uint64_t>        g_event_count(0);
+    /*
+     * ThreadBuffers are never freed, since threads may be recording up to
+     * process exit; take_events() frees their blocks as it goes. Also
+     * serializes take_events().
+     */
+    std::mutex                   g_registry_mutex;
+    std::vector<ThreadBuffer *>  g_buffers;
+
+    ThreadBuffer *local_buffer()
+    {
+        thread_local ThreadBuffer *buffer = 0;
+        if (!buffer) {
+            buffer = new ThreadBuffer();
+            buffer->head = buffer->tail = new Block();
+            buffer->taken = 0;
+            std::lock_guard<std::mutex> lock(g_registry_mutex);
+            buffer->tid = g_buffers.size() + 1;
+            g_buffers.push_back(buffer);
+        }
+        return buffer;
+    }
+
+    void append_escaped(std::string *out, const char *s)
+    {
+        for (; *s; ++s) {
+            if (*s == '"' || *s == '\\')
+                out->push_back('\\');
+            out->push_back(*s);
+        }
+    }
+}
+
+namespace Trace {
+    std::atomic<bool> g_enabled(false);
+
+    void set_enabled(bool enable)
+    {
+        g_enabled.store(enable, std::memory_order_relaxed);
+    }
+
+    uint64_t now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    clock_type::now() - g_epoch).count();
+    }
+
+    void record(const char *name, uint64_t start, uint64_t end)
+    {
+        if (g_event_count.load(std::memory_order_relaxed) >= MAX_EVENTS)
+            return;
+        g_event_count.fetch_add(1, std::memory_order_relaxed);
+        ThreadBuffer *buffer = local_buffer();
+        Block *block = buffer->tail;
+        unsigned n = block->count.load(std::memory_order_relaxed);
+        if (n == Block::CAPACITY) {
+            Block *next = new Block();
+            block->next.store(next, std::memory_order_release);
+            buffer->tail = block = next;
+            n = 0;
+        }
+        Event &e = block->events[n];
+        e.name  = name;
+        e.start = start;
+        e.end   = end;
+        block->count.store(n + 1, std::memory_order_release);
+    }
+
+    std::string take_events()
+    {
+        std::lock_guard<std::mutex> lock(g_registry_mutex);
+        std::string json;
+        uint64_t taken = 0;
+        char buf[128];
+        for (size_t i = 0; i < g_buffers.size(); ++i) {
+            ThreadBuffer *buffer = g_buffers[i];
+            for (;;) {
+                Block *block = buffer->head;
+                /* next first: once it is set, count is final */
+                Block *next = block->next.load(std::memory_order_acquire);
+                unsigned n = block->count.load(std::memory_order_acquire);
+                for (unsigned j = buffer->taken; j < n; ++j) {
+                    const Event &e = block->events[j];
+                    json += ",\n{\"name\":\"";
+                    append_escaped(&json, e.name);
+                    std::snprintf(buf, sizeof buf,
+                                  "\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,"
+                                  "\"ts\":%.3f,\"dur\":%.3f}",
+                                  buffer->tid, e.start / 1e3,
+                                  (e.end - e.start) / 1e3);
+                    json += buf;
+                }
+                taken += n - buffer->taken;
+                buffer->taken = n;
+                if (!next)
+                    break;
+                buffer->head  = next;
+                buffer->taken = 0;
+                delete block;
+            }
+        }
+        g_event_count.fetch_sub(taken, std::memory_order_relaxed);
+        return json;
+    }
+
+    std::string to_json()
+    {
+        std::string events = take_events();
+        if (events.size())
+            events.erase(0, 1);
+        return "{\"displayTimeUnit\":\"ms\",\"traceEvents\":["
+             + events + "\n]}\n";
+    }
+}
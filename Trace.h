@@ -0,0 +1,63 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/*
+ * Scoped timing spans, exported as Chrome trace event JSON
+ * (chrome://tracing, ui.perfetto.dev).
+ * Every thread appends to its own buffer without locking; when tracing is
+ * disabled a span costs one relaxed load. Define CAF_NO_TRACE to compile
+ * spans out altogether.
+ */
+namespace Trace {
+    extern std::atomic<bool> g_enabled;
+
+    inline bool enabled()
+    {
+        return g_enabled.load(std::memory_order_relaxed);
+    }
+    void set_enabled(bool enable);
+    /* nanoseconds since process start */
+    uint64_t now();
+    /* name must be a string literal (only the pointer is kept) */
+    void record(const char *name, uint64_t start, uint64_t end);
+    /*
+     * Everything recorded since the previous call, on all threads, as
+     * trace event objects each preceded by ",\n" (empty when there is
+     * nothing new). The events are dropped from the buffers, so that
+     * MAX_EVENTS in Trace.cpp limits what is held between two dumps.
+     */
+    std::string take_events();
+    /* take_events() as a complete trace */
+    std::string to_json();
+}
+
+class TraceSpan {
+#ifndef CAF_NO_TRACE
+    const char *m_name;
+    uint64_t    m_start;
+public:
+    explicit TraceSpan(const char *name)
+        : m_name(Trace::enabled() ? name : 0), m_start(0)
+    {
+        if (m_name)
+            m_start = Trace::now();
+    }
+    ~TraceSpan()
+    {
+        if (m_name)
+            Trace::record(m_name, m_start, Trace::now());
+    }
+#else
+public:
+    explicit TraceSpan(const char *) {}
+#endif
+private:
+    TraceSpan(const TraceSpan &);
+    TraceSpan& operator=(const TraceSpan &);
+};
+
+#endif
@@ -0,0 +1,258 @@
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include "ThreadPool.h"
+#include "Trace.h"
+#include "Verifier.h"
+
+const char Verifier::PCM_HASH_KEY[] = "CAF_PCM_XXH64";
+
+namespace {
+    /* bytes of audio data handed to a worker at a time */
+    const uint32_t JOB_BYTES = 65536;
+
+    struct Job {
+        int64_t                             first_packet;
+        uint32_t                            npackets;
+        std::vector<uint8_t>                data;
+        std::vector<uint32_t>               calls; /* bytes per decode() */
+        std::unique_ptr<audio_chunk_impl[]> chunks;
+        bool                                done;
+        std::exception_ptr                  error;
+        Job(): first_packet(0), npackets(0), done(false) {}
+    };
+
+    /*
+     * Reads the packets of one job from packet on. With single_call,
+     * they go to the decoder at once; otherwise in the same groups as
+     * input_caf feeds them.
+     */
+    uint32_t read_job(CAFFile *demuxer, int64_t packet, bool single_call,
+                      Job *job, abort_callback &abort)
+    {
+        auto asbd = demuxer->format().asbd;
+        int64_t num_packets = demuxer->num_packets();
+        uint32_t n = 0;
+        if (asbd.mBytesPerPacket > 0) {
+            uint32_t per_call = 1;
+            while (per_call * asbd.mBytesPerPacket < 4096)
+                per_call <<= 1;
+            uint32_t per_job = per_call;
+            while (per_job * asbd.mBytesPerPacket < JOB_BYTES)
+                per_job <<= 1;
+            n = demuxer->read_packets(packet, per_job, &job->data, abort);
+            if (single_call)
+                per_call = n;
+            for (uint32_t i = 0; i < n; i += per_call)
+                job->calls.push_back(std::min(per_call, n - i)
+                                     * asbd.mBytesPerPacket);
+        } else {
+            uint32_t bytes = 0, size;
+            for (; bytes < JOB_BYTES && packet + n < num_packets; ++n) {
+                demuxer->packet_info(packet + n, &size);
+                job->calls.push_back(size);
+                bytes += size;
+            }
+            n = demuxer->read_packets(packet, n, &job->data, abort);
+        }
+        job->first_packet = packet;
+        job->npackets     = n;
+        job->chunks.reset(new audio_chunk_impl[job->calls.size()]);
+        return n;
+    }
+}
+
+void Verifier::run(std::shared_ptr<CAFFile> &demuxer, unsigned nthreads,
+                   Result *result, abort_callback &abort,
+                   uint32_t decoder_delay)
+{
+    TraceSpan span("Verifier::run");
+    *result = Result();
+    demuxer->check_structure(&result->problems);
+
+    auto asbd  = demuxer->format().asbd;
+    bool intra = IDecoder::is_intra_only_format(asbd.mFormatID);
+    if (!intra || nthreads < 1)
+        nthreads = 1;
+    std::vector<std::shared_ptr<IDecoder>> decoders;
+    for (unsigned i = 0; i < nthreads; ++i)
+        decoders.push_back(IDecoder::create_decoder(demuxer, abort));
+
+    int64_t begin       = demuxer->start_offset() + decoder_delay;
+    int64_t end         = begin + demuxer->duration();
+    int64_t num_packets = demuxer->num_packets();
+    int64_t next_packet = 0, pos = 0, at = 0, at_end = 0;
+    bool    failed      = false;
+    /* the player feeds the last packet twice to flush a long delay */
+    bool    pull_tail   = decoder_delay > demuxer->end_padding();
+    size_t  max_jobs    = 4 * nthreads;
+    XXH64   data_hash, pcm_hash;
+
+    std::deque<std::shared_ptr<Job>> jobs;
+    std::mutex                       mutex;
+    std::condition_variable          cond;
+    {
+        /* one worker keeps the packets of stateful codecs in order */
+        ThreadPool pool(nthreads);
+        try {
+            for (;;) {
+                while (jobs.size() < max_jobs && next_packet < num_packets) {
+                    abort.check();
+                    at = at_end = next_packet;
+                    auto job = std::make_shared<Job>();
+                    uint32_t n = read_job(demuxer.get(), next_packet,
+                                          intra, job.get(), abort);
+                    if (!n)
+                        break;
+                    next_packet += n;
+                    data_hash.update(job->data.data(), job->data.size());
+                    result->data_bytes += job->data.size();
+                    if (next_packet == num_packets && pull_tail) {
+                        uint32_t size;
+                        demuxer->packet_info(num_packets - 1, &size);
+                        std::vector<uint8_t> &data = job->data;
+                        data.insert(data.end(), data.end() - size,
+                                    data.end());
+                        job->calls.push_back(size);
+                        job->chunks.reset(
+                            new audio_chunk_impl[job->calls.size()]);
+                    }
+                    jobs.push_back(job);
+
+                    auto decs = &decoders;
+                    auto mtx  = &mutex;
+                    auto cv   = &cond;
+                    pool.submit([job, decs, mtx, cv](unsigned worker) {
+                        try {
+                            TraceSpan span("Verifier job");
+                            abort_callback_dummy noabort;
+                            const uint8_t *p = job->data.data();
+                            for (size_t i = 0; i < job->calls.size(); ++i) {
+                                (*decs)[worker]->decode(p, job->calls[i],
+                                                        job->chunks[i],
+                                                        noabort);
+                                p += job->calls[i];
+                            }
+                        } catch (...) {
+                            job->error = std::current_exception();
+                        }
+                        {
+                            std::lock_guard<std::mutex> lock(*mtx);
+                            job->done = true;
+                        }
+                        cv->notify_all();
+                    });
+                }
+                if (jobs.empty())
+                    break;
+                /* hash this one while the workers decode the next ones */
+                std::shared_ptr<Job> job = jobs.front();
+                at     = job->first_packet;
+                at_end = at + job->npackets - 1;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    while (!job->done) {
+                        abort.check();
+                        cond.wait_for(lock, std::chrono::milliseconds(10));
+                    }
+                }
+                jobs.pop_front();
+                if (job->error)
+                    std::rethrow_exception(job->error);
+                for (size_t i = 0; i < job->calls.size(); ++i) {
+                    const audio_chunk &c = job->chunks[i];
+                    unsigned channels = c.get_channels();
+                    int64_t  a = std::max(pos, begin);
+                    int64_t  b = std::min<int64_t>(
+                            pos + c.get_sample_count(), end);
+                    if (a < b) {
+                        hash_samples(&pcm_hash,
+                                     c.get_data() + (a - pos) * channels,
+                                     (b - a) * channels);
+                        result->frames += b - a;
+                    }
+                    pos += c.get_sample_count();
+                }
+            }
+        } catch (std::exception &e) {
+            /* the file is at fault unless we are being cancelled */
+            abort.check();
+            failed = true;
+            char msg[64];
+            if (at == at_end)
+                std::snprintf(msg, sizeof msg, "packet %lld: ",
+                              static_cast<long long>(at));
+            else
+                std::snprintf(msg, sizeof msg, "packets %lld to %lld: ",
+                              static_cast<long long>(at),
+                              static_cast<long long>(at_end));
+            result->problems.push_back(msg + std::string(e.what()));
+        }
+    }
+    result->data_hash = data_hash.digest();
+    result->pcm_hash  = pcm_hash.digest();
+
+    uint64_t stored = 0;
+    result->has_stored_hash = stored_pcm_hash(demuxer->tags(), &stored);
+    char msg[160];
+    if (failed)
+        return;
+    /*
+     * Encoders are not always exact about the length of the last packet
+     * in the header; only a shortfall of more than that counts.
+     */
+    int64_t slack = demuxer->format().asbd.mFramesPerPacket;
+    if (result->frames + std::max<int64_t>(slack, 1) <= demuxer->duration()) {
+        std::snprintf(msg, sizeof msg, "decoded %lld of %lld frames",
+                      static_cast<long long>(result->frames),
+                      static_cast<long long>(demuxer->duration()));
+        result->problems.push_back(msg);
+    } else if (result->has_stored_hash && stored != result->pcm_hash) {
+        std::snprintf(msg, sizeof msg,
+                      "decoded audio hashes to %016llx, %016llx stored",
+                      static_cast<unsigned long long>(result->pcm_hash),
+                      static_cast<unsigned long long>(stored));
+        result->problems.push_back(msg);
+    }
+}
+
+void Verifier::hash_samples(XXH64 *state, const audio_sample *data,
+                            size_t count)
+{
+    if (sizeof(audio_sample) == sizeof(float)) {
+        state->update(data, count * sizeof(float));
+        return;
+    }
+    float buf[1024];
+    while (count) {
+        size_t n = std::min<size_t>(count, 1024);
+        for (size_t i = 0; i < n; ++i)
+            buf[i] = static_cast<float>(data[i]);
+        state->update(buf, n * sizeof(float));
+        data  += n;
+        count -= n;
+    }
+}
+
+bool Verifier::stored_pcm_hash(const CAFFile::tags_t &tags, uint64_t *hash)
+{
+    const char *value = tags.find(PCM_HASH_KEY);
+    if (!value)
+        return false;
+    char *end;
+    *hash = std::strtoull(value, &end, 16);
+    return end != value && !*end;
+}
+
+void Verifier::put_tags(const Result &result, CAFFile::tags_t *tags)
+{
+    char buf[32];
+    std::snprintf(buf, sizeof buf, "%016llx",
+                  static_cast<unsigned long long>(result.pcm_hash));
+    tags->set(PCM_HASH_KEY, buf);
+}
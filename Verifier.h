@@ -0,0 +1,51 @@
+#ifndef VERIFIER_H
+#define VERIFIER_H
+
+#include <string>
+#include <vector>
+#include "Decoder.h"
+#include "XXHash.h"
+
+/*
+ * Integrity check of a whole file: the packet table against the data
+ * chunk, XXH64 of the audio data (every packet, in order) and XXH64 of the
+ * decoded PCM. Packets are read and hashed on the calling thread while a
+ * pool decodes the ones ahead (one worker for codecs with inter-packet
+ * state); the PCM is hashed in order as jobs complete.
+ *
+ * The PCM hash covers the frames of duration(), priming trimmed, as
+ * 32 bit little endian floats interleaved in decoder output order.
+ */
+class Verifier {
+public:
+    struct Result {
+        std::vector<std::string> problems;
+        uint64_t                 data_hash;
+        uint64_t                 pcm_hash;
+        uint64_t                 data_bytes;
+        int64_t                  frames;     /* hashed */
+        bool                     has_stored_hash;
+
+        Result(): data_hash(0), pcm_hash(0), data_bytes(0), frames(0),
+                  has_stored_hash(false) {}
+        bool ok() const { return problems.empty(); }
+    };
+    /* info key holding the PCM hash, 16 hex digits */
+    static const char PCM_HASH_KEY[];
+
+    /*
+     * decoder_delay: extra frames to trim after the priming, as done by
+     * the player for codecs whose decoder adds delay
+     */
+    static void run(std::shared_ptr<CAFFile> &demuxer, unsigned nthreads,
+                    Result *result, abort_callback &abort,
+                    uint32_t decoder_delay=0);
+    static void hash_samples(XXH64 *state, const audio_sample *data,
+                             size_t count);
+    static bool stored_pcm_hash(const CAFFile::tags_t &tags,
+                                uint64_t *hash);
+    /* replaces the stored PCM hash in tags */
+    static void put_tags(const Result &result, CAFFile::tags_t *tags);
+};
+
+#endif
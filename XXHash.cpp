@@ -0,0 +1,114 @@
+#include <cstring>
+#include "XXHash.h"
+
+namespace {
+    const uint64_t P1 = 0x9E3779B185EBCA87ULL;
+    const uint64_t P2 = 0xC2B2AE3D27D4EB4FULL;
+    const uint64_t P3 = 0x165667B19E3779F9ULL;
+    const uint64_t P4 = 0x85EBCA77C2B2AE63ULL;
+    const uint64_t P5 = 0x27D4EB2F165667C5ULL;
+
+    inline uint64_t rotl(uint64_t x, unsigned n)
+    {
+        return (x << n) | (x >> (64 - n));
+    }
+    /* the format is little endian; so are all targets of this plugin */
+    inline uint64_t read64(const uint8_t *p)
+    {
+        uint64_t v;
+        std::memcpy(&v, p, 8);
+        return v;
+    }
+    inline uint32_t read32(const uint8_t *p)
+    {
+        uint32_t v;
+        std::memcpy(&v, p, 4);
+        return v;
+    }
+    inline uint64_t round(uint64_t acc, uint64_t input)
+    {
+        return rotl(acc + input * P2, 31) * P1;
+    }
+    inline uint64_t merge_round(uint64_t acc, uint64_t v)
+    {
+        return (acc ^ round(0, v)) * P1 + P4;
+    }
+    /* whole 32 byte stripes; returns the number of bytes consumed */
+    size_t consume(uint64_t *acc, const uint8_t *p, size_t size)
+    {
+        uint64_t v1 = acc[0], v2 = acc[1], v3 = acc[2], v4 = acc[3];
+        const uint8_t *q = p;
+        for (; size >= 32; size -= 32, q += 32) {
+            v1 = round(v1, read64(q));
+            v2 = round(v2, read64(q + 8));
+            v3 = round(v3, read64(q + 16));
+            v4 = round(v4, read64(q + 24));
+        }
+        acc[0] = v1; acc[1] = v2; acc[2] = v3; acc[3] = v4;
+        return q - p;
+    }
+}
+
+void XXH64::reset(uint64_t seed)
+{
+    m_acc[0]   = seed + P1 + P2;
+    m_acc[1]   = seed + P2;
+    m_acc[2]   = seed;
+    m_acc[3]   = seed - P1;
+    m_total    = 0;
+    m_seed     = seed;
+    m_buffered = 0;
+}
+
+void XXH64::update(const void *data, size_t size)
+{
+    const uint8_t *p = static_cast<const uint8_t *>(data);
+    m_total += size;
+    if (m_buffered) {
+        size_t n = 32 - m_buffered;
+        if (n > size)
+            n = size;
+        std::memcpy(m_buffer + m_buffered, p, n);
+        m_buffered += n;
+        p    += n;
+        size -= n;
+        if (m_buffered < 32)
+            return;
+        consume(m_acc, m_buffer, 32);
+        m_buffered = 0;
+    }
+    size_t n = consume(m_acc, p, size);
+    std::memcpy(m_buffer, p + n, size - n);
+    m_buffered = size - n;
+}
+
+uint64_t XXH64::digest() const
+{
+    uint64_t h;
+    if (m_total >= 32) {
+        h = rotl(m_acc[0], 1) + rotl(m_acc[1], 7)
+          + rotl(m_acc[2], 12) + rotl(m_acc[3], 18);
+        for (int i = 0; i < 4; ++i)
+            h = merge_round(h, m_acc[i]);
+    } else {
+        h = m_seed + P5;
+    }
+    h += m_total;
+
+    const uint8_t *p = m_buffer, *end = m_buffer + m_buffered;
+    for (; p + 8 <= end; p += 8)
+        h = rotl(h ^ round(0, read64(p)), 27) * P1 + P4;
+    if (p + 4 <= end) {
+        h = rotl(h ^ read32(p) * P1, 23) * P2 + P3;
+        p += 4;
+    }
+    for (; p < end; ++p)
+        h = rotl(h ^ *p * P5, 11) * P1;
+
+    h ^= h >> 33;
+    h *= P2;
+    h ^= h >> 29;
+    h *= P3;
+    h ^= h >> 32;
+    return h;
+}
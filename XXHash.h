@@ -0,0 +1,25 @@
+#ifndef XXHASH_H
+#define XXHASH_H
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * XXH64 (xxHash, 64 bit), fed incrementally. Digests equal those of the
+ * reference implementation for the same bytes and seed, however the input
+ * is split across update() calls.
+ */
+class XXH64 {
+    uint64_t m_acc[4];
+    uint64_t m_total;
+    uint64_t m_seed;
+    uint8_t  m_buffer[32];
+    unsigned m_buffered;
+public:
+    explicit XXH64(uint64_t seed=0) { reset(seed); }
+    void reset(uint64_t seed=0);
+    void update(const void *data, size_t size);
+    uint64_t digest() const;
+};
+
+#endif
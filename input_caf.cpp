@@ -1,27 +1,68 @@
 #define NOMINMAX
 #include <algorithm>
+#include <mutex>
+#include <thread>
 #include "Decoder.h"
+#include "ParallelDecoder.h"
+#include "DecodeAhead.h"
+#include "PeakScanner.h"
+#include "Verifier.h"
+#include "Config.h"
+#include "Trace.h"
 #include "../helpers/helpers.h"
 
 class input_caf : public input_stubs {
-    service_ptr_t<file>       m_pfile;
-    std::shared_ptr<CAFFile>  m_demuxer;
-    std::shared_ptr<IDecoder> m_decoder;
-    int64_t                   m_current_packet;
-    uint32_t                  m_start_skip;
-    uint32_t                  m_packets_per_chunk;
-    std::vector<uint8_t>      m_chunk_buffer;
-    dynamic_bitrate_helper    m_vbr_helper;
-    bool                      m_need_channel_remap;
+    service_ptr_t<file>              m_pfile;
+    pfc::string8                     m_path;
+    std::shared_ptr<CAFFile>         m_demuxer;
+    std::shared_ptr<IDecoder>        m_decoder;
+    /* fresh, for seeking back to the start; see seek() */
+    std::shared_ptr<IDecoder>        m_spare_decoder;
+    int64_t                          m_current_packet;
+    uint32_t                         m_start_skip;
+    /* decoded frames from the first packet to the end of the audio */
+    int64_t                          m_end_frame;
+    uint32_t                         m_packets_per_chunk;
+    std::vector<uint8_t>             m_chunk_buffer;
+    audio_chunk_impl                 m_preroll_chunk;
+    dynamic_bitrate_helper           m_vbr_helper;
+    bool                             m_need_channel_remap;
+    IDecoder::Options                m_decoder_options;
+    std::shared_ptr<ParallelDecoder> m_parallel_decoder;
+    bool                             m_verify;
+    XXH64                            m_pcm_hash;
+    /* last, so that the worker stops before anything it uses goes away */
+    std::shared_ptr<DecodeAhead>     m_decode_ahead;
 public:
+    ~input_caf()
+    {
+        /* stop the worker before reading its counters */
+        m_decode_ahead.reset();
+        if (m_demuxer && Config::perf_report())
+            FB2K_console_formatter() << "CAF Decoder performance counters:\n"
+                                     << m_demuxer->counters().report().c_str();
+        if (Trace::enabled())
+            write_trace();
+    }
     void open(service_ptr_t<file> file, const char *path,
               t_input_open_reason reason, abort_callback &abort)
     {
+        Trace::set_enabled(Config::trace_file().size() > 0);
+        TraceSpan span("input_caf::open");
         m_pfile = file;
-        input_open_file_helper(m_pfile, path, reason, abort);
+        m_path = path;
+        open_file(reason, abort);
+    }
+    void open_file(t_input_open_reason reason, abort_callback &abort)
+    {
+        input_open_file_helper(m_pfile, m_path, reason, abort);
         m_pfile->ensure_seekable();
-        m_demuxer = std::make_shared<CAFFile>(m_pfile, abort);
+        m_demuxer =
+            std::make_shared<CAFFile>(std::make_shared<FileByteSource>(m_pfile),
+                                      abort, Config::probe_size());
         m_decoder = IDecoder::create_decoder(m_demuxer, abort);
+        if (reason != input_open_decode)
+            m_demuxer->drop_head_window();
     }
     void get_info(file_info &info, abort_callback &abort)
     {
@@ -39,6 +80,18 @@ public:
         }
         m_decoder->get_info(info);
         m_demuxer->get_metadata(info);
+        if (m_demuxer->has_peaks()) {
+            /* saves ReplayGain and clipping checks a full decode */
+            replaygain_info rg = info.get_replaygain();
+            if (!rg.is_track_peak_present()) {
+                auto peaks = m_demuxer->peaks();
+                rg.m_track_peak = 0;
+                for (size_t i = 0; i < peaks.size(); ++i)
+                    rg.m_track_peak = std::max(rg.m_track_peak,
+                                               peaks[i].value);
+                info.set_replaygain(rg);
+            }
+        }
     }
     t_filestats get_file_stats(abort_callback &abort)
     {
@@ -46,69 +99,96 @@ public:
     }
     void decode_initialize(unsigned flags, abort_callback &abort)
     {
+        m_decode_ahead.reset();
         auto asbd           = m_demuxer->format().asbd;
         m_current_packet    = 0;
-        m_start_skip        = m_demuxer->start_offset() + decoder_delay();
         m_packets_per_chunk = 1;
         if (asbd.mBytesPerPacket > 0) {
             while (m_packets_per_chunk * asbd.mBytesPerPacket < 4096)
                 m_packets_per_chunk <<= 1;
         }
         m_vbr_helper.reset();
-    }
-    bool decode_run(audio_chunk &chunk, abort_callback &abort)
-    {
-        if (m_current_packet >= m_demuxer->num_packets() + 1)
-            return false;
-        int64_t pull_packet = m_current_packet;
-        if (m_current_packet == m_demuxer->num_packets()) {
+        /*
+         * Integrity check: the packet table must fit the data, and the
+         * output, as stored and untransformed, is hashed for comparison
+         * with a hash stored by retag().
+         */
+        m_verify = (flags & input_flag_testing_decode) != 0;
+        if (m_verify) {
+            std::vector<std::string> problems;
+            m_demuxer->check_structure(&problems);
+            if (problems.size())
+                throw std::runtime_error(problems[0]);
+            m_pcm_hash.reset();
+            /* the demuxer's format can't go back from the core */
+            bool core_only = m_decoder_options.aac_core_only;
+            m_decoder_options = IDecoder::Options();
+            m_decoder_options.aac_core_only = core_only;
+        } else {
+            m_decoder_options.stereo_downmix = Config::stereo_downmix();
+            m_decoder_options.channels       = Config::extract_channels();
+            if (Config::aac_core_only() && is_he_aac()) {
+                /* moves the demuxer's timeline to the core rate */
+                m_decoder_options.aac_core_only = true;
+                m_decoder = IDecoder::create_decoder(m_demuxer, abort,
+                                                     m_decoder_options);
+            }
+        }
+        m_start_skip = m_demuxer->start_offset() + decoder_delay();
+        m_end_frame  = m_demuxer->duration() + m_start_skip;
+        m_decoder->set_options(m_decoder_options);
+        /* sized up front, so that decoding and seeking don't allocate */
+        m_chunk_buffer.reserve(chunk_bytes());
+        m_decoder->reserve(chunk_bytes());
+        m_spare_decoder.reset();
+        if (m_decoder->get_max_frame_dependency())
+            m_spare_decoder = fresh_decoder(abort);
+        m_parallel_decoder.reset();
+        unsigned nthreads = std::thread::hardware_concurrency();
+        if ((flags & (input_flag_simpledecode | input_flag_testing_decode))
+         && nthreads > 1 && is_intra_only()) {
             /*
-             * If the end padding is shorter than the decoder delay,
-             * we already have fed all packets to the decoder but still
-             * we have to feed extra packet to pull the final delayed result.
-             * Due to overlap+add, samples might not be fully reconstructed
-             * anyway...
+             * Bulk decoding (conversion, scanning, verification): decode
+             * packet ranges on all cores, while the caller consumes (or
+             * hashes) the results. Make jobs large enough to be worth a
+             * handoff.
              */
-            if (decoder_delay() <= m_demuxer->end_padding())
-                return false;
-            else
-                pull_packet = m_current_packet - 1;
-        }
-        auto asbd = m_demuxer->format().asbd;
-        uint32_t fpp  = asbd.mFramesPerPacket;
-        uint32_t npackets = m_demuxer->read_packets(pull_packet,
-                                                    m_packets_per_chunk,
-                                                    &m_chunk_buffer, abort);
-        if (npackets == 0)
-            return false;
-        m_current_packet += npackets;
-        int64_t trim = std::max(m_current_packet * fpp - m_demuxer->duration()
-                                - m_demuxer->start_offset() - decoder_delay(),
-                                static_cast<int64_t>(0));
-        if (trim >= fpp * npackets)
-            return false;
-        m_decoder->decode(m_chunk_buffer.data(), m_chunk_buffer.size(),
-                          chunk, abort);
-        t_size nframes = chunk.get_sample_count();
-        unsigned nchannels = chunk.get_channels();
-        if (trim > 0) {
-            nframes = fpp * npackets - trim;
-            chunk.set_sample_count(nframes);
-        }
-        if (m_start_skip) {
-            if (m_start_skip >= nframes) {
-                m_start_skip -= nframes;
-                return decode_run(chunk, abort);
+            uint32_t packets_per_job = m_packets_per_chunk;
+            if (asbd.mBytesPerPacket > 0) {
+                while (packets_per_job * asbd.mBytesPerPacket < 65536)
+                    packets_per_job <<= 1;
             }
-            uint32_t rest = nframes - m_start_skip;
-            uint32_t bpf  = nchannels * sizeof(audio_sample);
-            audio_sample *bp = chunk.get_data();
-            std::memmove(bp, bp + m_start_skip * nchannels, rest * bpf);
-            chunk.set_sample_count(rest);
-            m_start_skip = 0;
+            m_parallel_decoder =
+                std::make_shared<ParallelDecoder>(m_demuxer, packets_per_job,
+                                                  nthreads, abort,
+                                                  m_decoder_options);
+        }
+        if ((flags & input_flag_playback) && Config::decode_ahead()) {
+            auto producer = [this](DecodeAhead::Slot *slot,
+                                   abort_callback &abort) -> bool {
+                return decode_chunk(slot->chunk, &slot->pre_packet,
+                                    &slot->cur_packet, abort);
+            };
+            m_decode_ahead =
+                std::make_shared<DecodeAhead>(producer,
+                                              Config::decode_ahead_depth());
+            m_decode_ahead->start();
         }
-        update_dynamic_vbr_info(m_current_packet - npackets, m_current_packet);
-        return true;
+    }
+    bool decode_run(audio_chunk &chunk, abort_callback &abort)
+    {
+        TraceSpan span("decode_run");
+        int64_t pre_packet, cur_packet;
+        bool more;
+        if (m_decode_ahead)
+            more = m_decode_ahead->pop(chunk, &pre_packet, &cur_packet, abort);
+        else
+            more = decode_chunk(chunk, &pre_packet, &cur_packet, abort);
+        if (more)
+            update_dynamic_vbr_info(pre_packet, cur_packet);
+        if (m_verify)
+            verify_chunk(chunk, more);
+        return more;
     }
     bool decode_run_raw(audio_chunk &chunk, mem_block_container &raw,
                         abort_callback &abort)
@@ -117,31 +197,14 @@ public:
     }
     void decode_seek(double seconds, abort_callback &abort)
     {
-        auto asbd = m_demuxer->format().asbd;
-        int64_t position = seconds * asbd.mSampleRate + .5;
-        m_decoder->reset_after_seek();
-        m_vbr_helper.reset();
-
-        if (position >= m_demuxer->duration()) {
-            /* let next decode_run() finish */
-            m_current_packet = m_demuxer->num_packets() + 1;
-            return;
-        }
-        uint32_t fpp       = asbd.mFramesPerPacket;
-        uint32_t start_off = m_demuxer->start_offset();
-        int64_t  ipacket   = (position + start_off) / fpp;
-        uint32_t preroll   = m_decoder->get_max_frame_dependency();
-        int64_t  ppacket   = std::max(0LL, ipacket - preroll);
-        m_start_skip = position + start_off + decoder_delay() - ipacket * fpp;
-        audio_chunk_impl tmp_chunk;
-        if (!ipacket && m_decoder->get_max_frame_dependency())
-            m_decoder = IDecoder::create_decoder(m_demuxer, abort);
-        while (ppacket < ipacket) {
-            m_demuxer->read_packets(ppacket++, 1, &m_chunk_buffer, abort);
-            m_decoder->decode(m_chunk_buffer.data(), m_chunk_buffer.size(),
-                              tmp_chunk, abort);
-        }
-        m_current_packet = ipacket;
+        TraceSpan span("decode_seek");
+        /* the hash only means something over the whole stream */
+        m_verify = false;
+        if (m_decode_ahead)
+            m_decode_ahead->stop();
+        seek(seconds, abort);
+        if (m_decode_ahead)
+            m_decode_ahead->start();
     }
     bool decode_can_seek()
     {
@@ -159,11 +222,35 @@ public:
     }
     void decode_on_idle(abort_callback &abort)
     {
+        /* the decode-ahead worker may be using the file right now */
+        if (m_decode_ahead)
+            return;
         m_pfile->on_idle(abort);
+        if (!m_spare_decoder && m_decoder->get_max_frame_dependency())
+            m_spare_decoder = fresh_decoder(abort);
     }
     void retag(const file_info &info, abort_callback &abort)
     {
-        m_demuxer->set_metadata(info, abort);
+        CAFFile::tags_t tags;
+        Metadata::put_entries(&tags, info);
+        if (Config::store_pcm_hash() && !tags.find(Verifier::PCM_HASH_KEY)) {
+            /* never vouch for audio that does not verify */
+            Verifier::Result result;
+            Verifier::run(m_demuxer, std::thread::hardware_concurrency(),
+                          &result, abort, decoder_delay());
+            if (result.ok())
+                Verifier::put_tags(result, &tags);
+        }
+        if (Config::relocate_tags() &&
+            !m_demuxer->tags_fit_before_data(tags, abort))
+            relocate(tags, abort);
+        else
+            m_demuxer->set_tags(tags, abort);
+        if (Config::store_peaks() && !m_demuxer->has_peaks()) {
+            std::vector<CAFFile::Peak> peaks;
+            PeakScanner::scan(m_demuxer, &peaks, abort);
+            m_demuxer->set_peaks(peaks, abort);
+        }
     }
     void remove_tags(abort_callback &abort)
     {
@@ -184,6 +271,246 @@ public:
         return guid;
     }
 private:
+    /* bytes of packets read per decode() call, at most */
+    size_t chunk_bytes() const
+    {
+        return static_cast<size_t>(m_demuxer->max_packet_size())
+             * m_packets_per_chunk;
+    }
+    std::shared_ptr<IDecoder> fresh_decoder(abort_callback &abort)
+    {
+        auto decoder = IDecoder::create_decoder(m_demuxer, abort,
+                                                m_decoder_options);
+        decoder->reserve(chunk_bytes());
+        return decoder;
+    }
+    /*
+     * Decodes the next chunk, returning the packet range it came from
+     * for the VBR display. Runs on the decode-ahead worker when enabled.
+     */
+    bool decode_chunk(audio_chunk &chunk, int64_t *pre_packet,
+                      int64_t *cur_packet, abort_callback &abort)
+    {
+        TraceSpan span("decode_chunk");
+        int64_t  num_packets = m_demuxer->num_packets();
+        uint32_t fpp         = m_demuxer->format().asbd.mFramesPerPacket;
+        PerfCounters &counters = m_demuxer->counters();
+        /* chunks entirely within the start skip are passed over */
+        for (;;) {
+            if (m_current_packet >= num_packets + 1)
+                return false;
+            skip_whole_packets();
+            int64_t  pull_packet = m_current_packet;
+            uint32_t want        = m_packets_per_chunk;
+            if (m_current_packet == num_packets) {
+                /*
+                 * If the end padding is shorter than the decoder delay,
+                 * we already have fed all packets to the decoder but still
+                 * we have to feed extra packet to pull the final delayed
+                 * result. Due to overlap+add, samples might not be fully
+                 * reconstructed anyway...
+                 */
+                if (decoder_delay() <= m_demuxer->end_padding())
+                    return false;
+                else
+                    pull_packet = m_current_packet - 1;
+            } else if (fpp) {
+                /* no packets that are all end padding */
+                int64_t last = (m_end_frame + fpp - 1) / fpp;
+                want = std::max<int64_t>(std::min<int64_t>(
+                                            want, last - m_current_packet), 1);
+            }
+            uint32_t npackets;
+            if (m_parallel_decoder)
+                npackets = m_parallel_decoder->decode(chunk, abort);
+            else
+                npackets = m_demuxer->read_packets(pull_packet, want,
+                                                   &m_chunk_buffer, abort);
+            if (npackets == 0)
+                return false;
+            m_current_packet += npackets;
+            counters.add(PerfCounters::PACKETS_DECODED, npackets);
+            int64_t trim = std::max<int64_t>(m_current_packet * fpp
+                                             - m_end_frame, 0);
+            int64_t covered = static_cast<int64_t>(fpp) * npackets - trim;
+            if (covered <= 0)
+                return false;
+            /* a skip ending in this chunk is dropped while decoding */
+            size_t skip = m_start_skip < covered ? m_start_skip : 0;
+            if (!m_parallel_decoder) {
+                PerfTimer timer(&counters, PerfCounters::DECODE_NS);
+                m_decoder->decode_skipping(m_chunk_buffer.data(),
+                                           m_chunk_buffer.size(), skip,
+                                           chunk, abort);
+            } else if (skip) {
+                PerfTimer timer(&counters, PerfCounters::TRIM_NS);
+                IDecoder::drop_frames(chunk, skip);
+            }
+            m_start_skip -= skip;
+            counters.peak(PerfCounters::PEAK_CHUNK_SAMPLES,
+                          chunk.get_sample_count() * chunk.get_channels());
+            if (trim > 0)
+                chunk.set_sample_count(covered - skip);
+            if (m_start_skip) {
+                m_start_skip -= std::min<int64_t>(m_start_skip,
+                                                  chunk.get_sample_count());
+                continue;
+            }
+            if (!chunk.get_sample_count())
+                continue;
+            *pre_packet = m_current_packet - npackets;
+            *cur_packet = m_current_packet;
+            return true;
+        }
+    }
+    /*
+     * Packets wholly within the start skip are not even read, when they
+     * can be decoded independently of the ones before.
+     */
+    void skip_whole_packets()
+    {
+        uint32_t fpp = m_demuxer->format().asbd.mFramesPerPacket;
+        if (!fpp || m_start_skip < fpp || !is_intra_only())
+            return;
+        int64_t n = std::min<int64_t>(m_start_skip / fpp,
+                                      m_demuxer->num_packets()
+                                      - m_current_packet);
+        m_current_packet += n;
+        m_start_skip     -= n * fpp;
+        if (m_parallel_decoder)
+            m_parallel_decoder->reset(m_current_packet);
+    }
+    /* testing decode: hashes the output, and checks it at the end */
+    void verify_chunk(const audio_chunk &chunk, bool more)
+    {
+        if (more) {
+            Verifier::hash_samples(&m_pcm_hash, chunk.get_data(),
+                                   chunk.get_sample_count()
+                                   * chunk.get_channels());
+            return;
+        }
+        m_verify = false;
+        uint64_t stored;
+        /* the stored hash is of the full HE-AAC output */
+        if (m_decoder_options.aac_core_only)
+            return;
+        if (Verifier::stored_pcm_hash(m_demuxer->tags(), &stored)
+         && stored != m_pcm_hash.digest())
+            throw std::runtime_error("decoded audio does not match "
+                                     "the stored hash");
+    }
+    void seek(double seconds, abort_callback &abort)
+    {
+        auto asbd = m_demuxer->format().asbd;
+        int64_t position = seconds * asbd.mSampleRate + .5;
+        m_decoder->reset_after_seek();
+        m_vbr_helper.reset();
+
+        if (position >= m_demuxer->duration()) {
+            /* let next decode_run() finish */
+            m_current_packet = m_demuxer->num_packets() + 1;
+            return;
+        }
+        uint32_t fpp       = asbd.mFramesPerPacket;
+        uint32_t start_off = m_demuxer->start_offset();
+        int64_t  ipacket   = (position + start_off) / fpp;
+        uint32_t preroll   = m_decoder->get_max_frame_dependency();
+        int64_t  ppacket   = std::max(0LL, ipacket - preroll);
+        m_start_skip = position + start_off + decoder_delay() - ipacket * fpp;
+        if (!ipacket && preroll) {
+            /*
+             * Nothing to preroll from, so start over with a fresh decoder:
+             * the spare one, which decode_on_idle() replaces (unless the
+             * decode-ahead worker is on, in which case the next seek to
+             * the start creates one here).
+             */
+            if (!m_spare_decoder)
+                m_spare_decoder = fresh_decoder(abort);
+            m_decoder.swap(m_spare_decoder);
+            m_spare_decoder.reset();
+        }
+        PerfCounters &counters = m_demuxer->counters();
+        TraceSpan span("seek preroll");
+        while (ppacket < ipacket) {
+            m_demuxer->read_packets(ppacket++, 1, &m_chunk_buffer, abort);
+            PerfTimer timer(&counters, PerfCounters::DECODE_NS);
+            m_decoder->decode(m_chunk_buffer.data(), m_chunk_buffer.size(),
+                              m_preroll_chunk, abort);
+            counters.add(PerfCounters::PREROLL_PACKETS, 1);
+        }
+        m_current_packet = ipacket;
+        if (m_parallel_decoder)
+            m_parallel_decoder->reset(ipacket);
+    }
+    /*
+     * Rewrites the file with all metadata ahead of the audio data.
+     * The new image is completed in a temporary file next to the original
+     * and then renamed over it, so that the original stays intact until
+     * the new one is complete. Our handle is closed for the rename and
+     * reopened afterwards; when the file is still held open elsewhere
+     * the rename, and so the retag, fails.
+     */
+    void relocate(const CAFFile::tags_t &tags, abort_callback &abort)
+    {
+        TraceSpan span("input_caf::relocate");
+        abort_callback_dummy noabort;
+        pfc::string8 tmp_path = m_path;
+        tmp_path += ".retag.tmp";
+        try {
+            service_ptr_t<file> tmp;
+            filesystem::g_open_write_new(tmp, tmp_path, abort);
+            FileByteSource dst(tmp);
+            m_demuxer->rewrite(&dst, tags, abort);
+        } catch (...) {
+            try { filesystem::g_remove(tmp_path, noabort); } catch (...) {}
+            throw;
+        }
+        m_spare_decoder.reset();
+        m_decoder.reset();
+        m_demuxer.reset();
+        m_pfile.release();
+        try {
+            filesystem::g_move(tmp_path, m_path, abort);
+        } catch (...) {
+            try { filesystem::g_remove(tmp_path, noabort); } catch (...) {}
+            open_file(input_open_info_write, abort);
+            throw;
+        }
+        open_file(input_open_info_write, abort);
+    }
+    /*
+     * Appends the events recorded since the previous dump. The file is
+     * started over once per session, and written in the JSON array
+     * format, whose closing bracket may be left out.
+     */
+    void write_trace()
+    {
+        static std::mutex mutex;
+        static bool started = false;
+        try {
+            std::lock_guard<std::mutex> lock(mutex);
+            std::string events = Trace::take_events();
+            if (events.empty())
+                return;
+            abort_callback_dummy noabort;
+            service_ptr_t<file> out;
+            std::string path = Config::trace_file();
+            if (!started) {
+                filesystem::g_open_write_new(out, path.c_str(), noabort);
+                events[0] = '[';
+            } else {
+                filesystem::g_open(out, path.c_str(),
+                                   filesystem::open_mode_write_existing,
+                                   noabort);
+                out->seek(out->get_size(noabort), noabort);
+            }
+            out->write(events.data(), events.size(), noabort);
+            started = true;
+        } catch (std::exception &e) {
+            FB2K_console_formatter() << "CAF Decoder: cannot write trace: "
+                                     << e.what();
+        }
+    }
     uint32_t decoder_delay()
     {
         switch (m_demuxer->format().asbd.mFormatID) {
@@ -195,6 +522,23 @@ private:
         }
         return 0;
     }
+    /* formats Options::aac_core_only applies to (as analyzed on open) */
+    bool is_he_aac()
+    {
+        uint32_t id = m_demuxer->format().asbd.mFormatID;
+        return id == FOURCC('a','a','c','h') || id == FOURCC('a','a','c','p');
+    }
+    /*
+     * Packets can be decoded independently of each other,
+     * and in any order.
+     */
+    bool is_intra_only()
+    {
+        return IDecoder::is_intra_only_format(
+                    m_demuxer->format().asbd.mFormatID)
+            && m_decoder->get_max_frame_dependency() == 0
+            && decoder_delay() == 0;
+    }
     void update_dynamic_vbr_info(uint64_t pre_packet, uint64_t cur_packet)
     {
         if (m_demuxer->is_cbr() || cur_packet >= m_demuxer->num_packets())
@@ -0,0 +1,599 @@
+/*
+ * Reference ALAC files for caf-verify --self-test: a sine with a little
+ * noise, silence, then loud noise, so that the Rice codes, zero runs and
+ * escapes are all decoded. Made with FFmpeg 7.0:
+ *
+ *   ffmpeg -f lavfi -i "aevalsrc='E|0.8*sin(2*PI*660*t)':s=44100:d=0.034"
+ *          -c:a alac -sample_fmt s16p -frame_size 256 alac16.caf
+ *   ffmpeg -f lavfi -i "aevalsrc='E':s=48000:d=0.034"
+ *          -c:a alac -sample_fmt s32p -frame_size 256 alac24.caf
+ *
+ * where E is
+ *
+ *   if(lt(t,0.02),0.5*sin(2*PI*440*t)+0.01*(random(0)-0.5),
+ *      if(lt(t,0.03),0,0.95*(random(1)-0.5)*2))
+ *
+ * The hashes are XXH64 of FFmpeg's decode of the files, taken the way
+ * Verifier hashes PCM (samples / 2^(bits - 1) as 32 bit floats).
+ */
+#ifndef ALAC_REFERENCE_H
+#define ALAC_REFERENCE_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace AlacReference {
+    const uint8_t alac16[] = {
+        0x63, 0x61, 0x66, 0x66, 0x00, 0x01, 0x00, 0x00, 0x64, 0x65, 0x73, 0x63,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0x40, 0xe5, 0x88, 0x80,
+        0x00, 0x00, 0x00, 0x00, 0x61, 0x6c, 0x61, 0x63, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x02,
+        0x00, 0x00, 0x00, 0x00, 0x63, 0x68, 0x61, 0x6e, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x0c, 0x00, 0x65, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x6b, 0x75, 0x6b, 0x69, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x30, 0x00, 0x00, 0x00, 0x0c, 0x66, 0x72, 0x6d, 0x61,
+        0x61, 0x6c, 0x61, 0x63, 0x00, 0x00, 0x00, 0x24, 0x61, 0x6c, 0x61, 0x63,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x10, 0x28, 0x0a,
+        0x0e, 0x02, 0x00, 0x00, 0x00, 0x00, 0x40, 0x04, 0x00, 0x15, 0x88, 0x80,
+        0x00, 0x00, 0xac, 0x44, 0x69, 0x6e, 0x66, 0x6f, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x19, 0x00, 0x00, 0x00, 0x01, 0x65, 0x6e, 0x63, 0x6f,
+        0x64, 0x65, 0x72, 0x00, 0x4c, 0x61, 0x76, 0x66, 0x36, 0x31, 0x2e, 0x31,
+        0x2e, 0x31, 0x30, 0x30, 0x00, 0x64, 0x61, 0x74, 0x61, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x0b, 0x3a, 0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0x10,
+        0x00, 0x00, 0x0b, 0xb6, 0x00, 0x00, 0x11, 0x0c, 0x01, 0xe0, 0x00, 0x8d,
+        0xff, 0xf0, 0x00, 0x1b, 0xff, 0xdb, 0xff, 0xa8, 0x11, 0x0c, 0x01, 0x42,
+        0x00, 0xe6, 0x00, 0x84, 0x00, 0x23, 0xff, 0xc1, 0xff, 0x5d, 0xff, 0x00,
+        0x58, 0xff, 0xc1, 0x3c, 0x9f, 0xf0, 0x2d, 0xb7, 0xf7, 0x27, 0xf8, 0x67,
+        0xc3, 0x3f, 0x3c, 0xd7, 0x36, 0xb4, 0xa2, 0x4b, 0xdb, 0x82, 0x5c, 0x32,
+        0x05, 0x10, 0x39, 0x6b, 0x33, 0x05, 0xb0, 0xc3, 0x86, 0x8b, 0x72, 0x1c,
+        0xee, 0x9b, 0x5c, 0xa5, 0x1f, 0xea, 0xea, 0x84, 0x4b, 0xbf, 0x30, 0x76,
+        0xca, 0xdf, 0x1e, 0x7a, 0x8f, 0x33, 0x34, 0x27, 0xe2, 0xf3, 0xbb, 0x3b,
+        0x32, 0x00, 0xd1, 0x66, 0x92, 0xcb, 0xe9, 0xe5, 0x79, 0x1d, 0x6a, 0x53,
+        0x95, 0x74, 0x68, 0xb8, 0xda, 0x64, 0x39, 0x56, 0x4d, 0xb8, 0x4c, 0xe7,
+        0x77, 0x3a, 0x56, 0x16, 0x89, 0xcf, 0x24, 0x8e, 0x40, 0x6e, 0x5c, 0x19,
+        0x53, 0x5f, 0xd2, 0x5d, 0xed, 0x4f, 0x44, 0xd5, 0x21, 0x12, 0x44, 0xe9,
+        0x8e, 0x34, 0xa9, 0x33, 0x1e, 0xb1, 0x96, 0xb0, 0xba, 0xae, 0x08, 0xb1,
+        0x2f, 0x24, 0x6b, 0x13, 0x1f, 0x0c, 0x2e, 0x99, 0x92, 0x7b, 0x1d, 0x8e,
+        0x4d, 0xd6, 0x38, 0x51, 0x05, 0x77, 0x2d, 0xa4, 0xba, 0x4d, 0xb6, 0x08,
+        0x96, 0xd3, 0x6b, 0x93, 0xc6, 0xc0, 0x4b, 0xf8, 0x48, 0xda, 0x5e, 0xa2,
+        0x4e, 0xf8, 0xfa, 0x55, 0x83, 0xcc, 0x8b, 0xdc, 0x54, 0x0e, 0x5e, 0x6a,
+        0x4f, 0x10, 0x50, 0xed, 0xec, 0x45, 0xb7, 0xb8, 0xbe, 0x53, 0x5a, 0x71,
+        0xfb, 0x60, 0x44, 0x61, 0x9d, 0x63, 0xc7, 0xcc, 0xea, 0x74, 0x1b, 0xc4,
+        0x55, 0x54, 0x7e, 0xde, 0x81, 0x32, 0x49, 0xf9, 0x13, 0x05, 0x62, 0xa0,
+        0xa9, 0x5b, 0x43, 0x95, 0x67, 0xaa, 0x1c, 0xa9, 0x26, 0x04, 0x68, 0x49,
+        0xd4, 0xd2, 0x49, 0xc3, 0x72, 0xe1, 0x05, 0x3c, 0xf9, 0x73, 0x66, 0x14,
+        0x1f, 0x45, 0x48, 0x17, 0x96, 0x0b, 0xe5, 0x6c, 0x93, 0x4e, 0x61, 0xf5,
+        0x9f, 0x89, 0x5f, 0xa0, 0xc5, 0xbc, 0x16, 0x85, 0x87, 0x00, 0x86, 0x95,
+        0x91, 0xd0, 0xfc, 0xae, 0x2a, 0x70, 0xd7, 0x6e, 0x0e, 0x93, 0xa5, 0x21,
+        0x06, 0xa8, 0x50, 0xb1, 0xb0, 0x40, 0x66, 0x66, 0x45, 0x18, 0x20, 0x0c,
+        0x41, 0xe9, 0x86, 0x99, 0x69, 0xe2, 0xde, 0x64, 0x7a, 0x4b, 0x5c, 0x24,
+        0x71, 0x67, 0xeb, 0xd2, 0x9e, 0xb2, 0xaf, 0xc2, 0xd9, 0x0b, 0x2a, 0x62,
+        0xe7, 0x11, 0xd8, 0x85, 0x87, 0x2d, 0x03, 0xee, 0x8a, 0xd2, 0xb0, 0x56,
+        0x66, 0x87, 0x16, 0xa2, 0x68, 0xa1, 0x12, 0xbe, 0xaf, 0x96, 0x54, 0x7d,
+        0x6d, 0x35, 0xb7, 0xc0, 0x8a, 0x71, 0x66, 0xb5, 0x61, 0x30, 0x69, 0x83,
+        0xb1, 0xf0, 0xae, 0x0f, 0x0f, 0xfb, 0x23, 0x79, 0x67, 0x7f, 0x45, 0xc8,
+        0x1a, 0xb2, 0x84, 0xcc, 0x72, 0xb1, 0x33, 0x23, 0xfb, 0x05, 0xd7, 0xeb,
+        0xd3, 0x4e, 0xa5, 0xf0, 0xfd, 0x90, 0x5e, 0xbe, 0x85, 0xb2, 0x72, 0x86,
+        0x2c, 0xcd, 0x0b, 0x51, 0x91, 0x22, 0x37, 0x46, 0xca, 0x65, 0x02, 0xe6,
+        0x23, 0x7a, 0x4d, 0x64, 0x0c, 0x3b, 0x86, 0x90, 0x01, 0xf4, 0x4c, 0x61,
+        0x3e, 0xd5, 0xa0, 0x91, 0x1c, 0x6a, 0x3c, 0xa7, 0x4b, 0x6f, 0x79, 0xa7,
+        0x3d, 0x18, 0x0c, 0xe7, 0x9c, 0x4d, 0x9b, 0xd1, 0xb6, 0xd3, 0xb3, 0xa8,
+        0xf5, 0x41, 0x49, 0x39, 0x52, 0xd0, 0x54, 0x0c, 0x5e, 0x92, 0x35, 0x25,
+        0x99, 0x7d, 0x74, 0x73, 0x5f, 0x34, 0xc4, 0xe8, 0x8c, 0xd2, 0x09, 0x34,
+        0xdc, 0x48, 0x88, 0x2e, 0xf2, 0xa1, 0x52, 0x6e, 0x52, 0xce, 0x7d, 0xbc,
+        0x51, 0x9a, 0x0d, 0xac, 0x9d, 0x89, 0x8d, 0x0d, 0xf4, 0x18, 0x0f, 0x1f,
+        0xb5, 0x70, 0x19, 0x36, 0x2a, 0x4b, 0xef, 0x94, 0xba, 0xb7, 0x7e, 0xf7,
+        0xa6, 0x3d, 0x02, 0xf0, 0xc3, 0xe5, 0xed, 0xc8, 0x82, 0x46, 0xdc, 0x64,
+        0xe7, 0x97, 0xf2, 0xdb, 0xa3, 0x59, 0x40, 0x63, 0x16, 0x9b, 0x24, 0x36,
+        0x0a, 0xe6, 0xf0, 0x74, 0x16, 0xd5, 0x98, 0xcc, 0x55, 0x14, 0x4f, 0x63,
+        0xe5, 0xbd, 0xc5, 0x1b, 0x3d, 0x92, 0x02, 0x2b, 0x7e, 0x8e, 0x6b, 0x64,
+        0xab, 0x7a, 0xff, 0x86, 0x46, 0x72, 0xce, 0x50, 0x58, 0xd2, 0x78, 0x93,
+        0xaf, 0x58, 0xd7, 0x0d, 0xd2, 0x67, 0x8b, 0xf5, 0xf4, 0x0f, 0x78, 0x38,
+        0xa4, 0xa1, 0x4f, 0x20, 0xd1, 0x02, 0xb5, 0xf6, 0x81, 0x86, 0xe0, 0x9d,
+        0x7b, 0x61, 0xcc, 0x41, 0xd2, 0x4b, 0x76, 0x3e, 0x54, 0x90, 0x2e, 0x16,
+        0x66, 0x3f, 0x61, 0xc0, 0xb9, 0xfd, 0xdd, 0x16, 0xd7, 0x9a, 0x9e, 0x09,
+        0x63, 0xc7, 0x83, 0xe5, 0x8e, 0xdf, 0x9e, 0x6a, 0xaa, 0xa1, 0xb3, 0x6f,
+        0x63, 0xf0, 0x5f, 0x51, 0x1b, 0xfb, 0x09, 0x6a, 0x8d, 0x38, 0x93, 0x60,
+        0x5a, 0x62, 0x07, 0x60, 0xb8, 0x6b, 0xfd, 0x3c, 0xb3, 0x99, 0xed, 0xea,
+        0xdd, 0x9d, 0x09, 0x42, 0x38, 0x28, 0x0e, 0x6a, 0x57, 0x6d, 0x93, 0x05,
+        0xfb, 0x13, 0xab, 0x69, 0xe9, 0x06, 0xfe, 0xe3, 0x93, 0x61, 0x25, 0x87,
+        0x8b, 0x82, 0xd4, 0x6d, 0x4a, 0x7c, 0x27, 0xcc, 0x25, 0xa8, 0xfe, 0x4d,
+        0x58, 0x32, 0x3c, 0x95, 0x5c, 0x9c, 0xa3, 0xd6, 0xf6, 0x78, 0xa2, 0x4e,
+        0xd1, 0x56, 0xe3, 0xa3, 0x4d, 0x10, 0x93, 0xf6, 0xc7, 0xc5, 0xf3, 0x8e,
+        0x51, 0x8c, 0x0e, 0xd3, 0xac, 0x78, 0x84, 0xb2, 0x2a, 0x08, 0xbe, 0x5a,
+        0xc6, 0x53, 0x93, 0x3e, 0x54, 0xa0, 0x41, 0xe8, 0x2d, 0x57, 0x2b, 0x86,
+        0xe1, 0x4b, 0xa1, 0xf2, 0x5e, 0x55, 0x12, 0xe3, 0x68, 0x6e, 0x3c, 0x86,
+        0xb2, 0x9f, 0x15, 0x47, 0x83, 0x4a, 0x2b, 0x33, 0xf9, 0xe6, 0xf6, 0x6c,
+        0x52, 0xcf, 0xba, 0x1b, 0x9e, 0x20, 0x99, 0x0e, 0xa6, 0x3e, 0xbe, 0xa2,
+        0xf9, 0x30, 0x9f, 0x5e, 0xc6, 0x97, 0x68, 0x58, 0xee, 0x3d, 0x93, 0x64,
+        0xb8, 0xa7, 0x05, 0xb9, 0x28, 0xaa, 0xa6, 0x65, 0x52, 0x92, 0x24, 0x68,
+        0x9c, 0xa1, 0xc4, 0x63, 0x77, 0xad, 0x3e, 0x2a, 0x90, 0x34, 0x14, 0xca,
+        0x21, 0x8b, 0xeb, 0x9c, 0x14, 0xbb, 0xcc, 0x14, 0xff, 0x16, 0x99, 0xb8,
+        0x5c, 0x46, 0x13, 0x0b, 0xe8, 0xab, 0xdd, 0x31, 0x53, 0x3c, 0x0e, 0x53,
+        0x32, 0x3c, 0x60, 0x2c, 0x86, 0x07, 0xf1, 0x8d, 0xf0, 0xf3, 0x1f, 0xf8,
+        0x61, 0x4a, 0xaf, 0x29, 0xe3, 0x15, 0x75, 0xdd, 0x07, 0x4e, 0x78, 0x82,
+        0x4c, 0x2d, 0xa5, 0xb5, 0x08, 0xce, 0x9d, 0xaa, 0x10, 0xcf, 0x99, 0x03,
+        0x53, 0xca, 0x6a, 0x7b, 0xa0, 0x3f, 0x91, 0x72, 0x6c, 0x14, 0x35, 0xc1,
+        0x72, 0x71, 0x7a, 0xa4, 0x96, 0x85, 0x14, 0x0c, 0xdb, 0x9e, 0xcb, 0xec,
+        0x49, 0x94, 0xf7, 0x06, 0xe3, 0x7d, 0x1c, 0x45, 0x44, 0x8e, 0x9f, 0xc8,
+        0xcc, 0x95, 0x80, 0x2b, 0xef, 0x9b, 0xe2, 0x77, 0x85, 0xf0, 0x6e, 0x46,
+        0x3d, 0x4a, 0xd3, 0xf9, 0x3c, 0xda, 0x96, 0x2c, 0x50, 0xa9, 0xba, 0x25,
+        0x98, 0x8d, 0x4e, 0x40, 0x62, 0x2f, 0xc3, 0xad, 0xb7, 0xb4, 0x23, 0x36,
+        0xc6, 0x60, 0xd4, 0x32, 0xa1, 0x85, 0xea, 0x0d, 0x89, 0xf3, 0xc1, 0xe5,
+        0xa8, 0x5b, 0x04, 0x4e, 0xca, 0x6e, 0x62, 0x31, 0xc3, 0xe6, 0x57, 0x24,
+        0x21, 0x1c, 0x50, 0x06, 0x00, 0x18, 0x34, 0xfe, 0x49, 0x99, 0xf4, 0x59,
+        0x17, 0x66, 0x29, 0x76, 0x9a, 0x32, 0x35, 0x30, 0xda, 0x82, 0x0d, 0x3e,
+        0x87, 0x9f, 0x45, 0xf3, 0x45, 0x1d, 0x3e, 0x29, 0xa6, 0x01, 0x4e, 0x69,
+        0xdb, 0xfa, 0xdd, 0x3e, 0xc3, 0xc1, 0x80, 0xba, 0x08, 0xee, 0xc7, 0x14,
+        0xf3, 0x1b, 0x3a, 0x1a, 0xa8, 0xea, 0x8c, 0x91, 0x49, 0xa1, 0x74, 0x12,
+        0x5a, 0x36, 0xad, 0x34, 0x90, 0x7a, 0x13, 0x82, 0x82, 0x59, 0x78, 0x5c,
+        0xdd, 0xa9, 0x65, 0x83, 0xe3, 0x31, 0x9e, 0x0d, 0x36, 0x65, 0x8a, 0x0c,
+        0x9a, 0x1d, 0x6a, 0xb7, 0x91, 0x74, 0x1f, 0xb9, 0x8f, 0x50, 0xfb, 0x78,
+        0x07, 0xe3, 0x2e, 0x3f, 0x89, 0x4d, 0x80, 0xd6, 0x87, 0x03, 0xcd, 0xf4,
+        0x9e, 0x9f, 0x16, 0x2a, 0xf2, 0x82, 0x0f, 0x30, 0xcb, 0x8a, 0x02, 0xf6,
+        0x2a, 0x40, 0x6e, 0xf5, 0x2d, 0x59, 0x82, 0x54, 0x90, 0x6b, 0xaa, 0x47,
+        0xf0, 0x6b, 0xb4, 0x33, 0x47, 0x35, 0x08, 0x15, 0xd1, 0xa5, 0x1d, 0x3d,
+        0x0a, 0x44, 0x29, 0x60, 0x93, 0x4f, 0xf4, 0x42, 0x59, 0x6f, 0xfe, 0x7a,
+        0xc8, 0x70, 0xef, 0x76, 0x4f, 0x09, 0x0e, 0x81, 0x70, 0xf8, 0xfe, 0x5a,
+        0xc0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07, 0xfc, 0x04, 0xe3,
+        0xfe, 0x83, 0x74, 0xff, 0xd9, 0xef, 0xbf, 0xf9, 0x38, 0xbf, 0xf9, 0x24,
+        0xff, 0xfe, 0x6e, 0x04, 0xff, 0x9e, 0x0e, 0x3f, 0xf2, 0xef, 0xaf, 0xf8,
+        0x8b, 0xa7, 0xfe, 0x8c, 0x3f, 0xff, 0xb7, 0xd7, 0x7f, 0xea, 0x35, 0x4f,
+        0xf0, 0x33, 0x3f, 0xe8, 0x5b, 0x2f, 0xf9, 0x64, 0x6e, 0xcb, 0x8f, 0xf7,
+        0xee, 0xff, 0xec, 0xa8, 0xdf, 0xfe, 0x01, 0x0f, 0xfc, 0xf8, 0x4d, 0xff,
+        0x9e, 0x29, 0xff, 0xe4, 0x6e, 0x5f, 0xf0, 0xe8, 0xcf, 0xfc, 0x48, 0x49,
+        0xff, 0x3c, 0xe0, 0x7f, 0xcf, 0xaa, 0xbf, 0xf6, 0x2a, 0x3f, 0xf8, 0x72,
+        0x3f, 0xf2, 0x43, 0x1f, 0xfd, 0xa1, 0xdf, 0xe1, 0x39, 0xff, 0xd5, 0x17,
+        0x3f, 0xe9, 0x67, 0x1f, 0xf9, 0xdd, 0x93, 0xe1, 0xf9, 0xfe, 0x6f, 0x9f,
+        0xf1, 0x8a, 0x3f, 0xeb, 0x95, 0xcf, 0xf9, 0xb2, 0x67, 0xff, 0xfc, 0x64,
+        0xff, 0xb1, 0xab, 0x7f, 0xe9, 0x40, 0x2f, 0xfc, 0xb4, 0xd7, 0xfe, 0x2e,
+        0xfd, 0xff, 0xa8, 0x51, 0xbf, 0xed, 0x20, 0xcf, 0xff, 0x9d, 0x5b, 0xff,
+        0xb9, 0x54, 0xff, 0xb2, 0x51, 0xfe, 0x26, 0xc8, 0xbd, 0xa5, 0x28, 0xf5,
+        0x8f, 0x7f, 0xd2, 0x0c, 0xff, 0xeb, 0x39, 0xff, 0xc4, 0xc8, 0xbf, 0xf0,
+        0xf0, 0xdf, 0xfc, 0xc3, 0x53, 0xff, 0x64, 0xf2, 0xff, 0x4f, 0xe7, 0xf5,
+        0x62, 0xbf, 0xc7, 0x8e, 0xff, 0x89, 0x89, 0xff, 0xee, 0x1a, 0x4f, 0xfa,
+        0x9b, 0xa0, 0xc6, 0xef, 0xfe, 0x10, 0x37, 0xfe, 0x6d, 0x03, 0xff, 0xe1,
+        0x2f, 0x3f, 0xe7, 0x27, 0x0e, 0x17, 0xb9, 0x5e, 0xff, 0xfe, 0x07, 0x5f,
+        0xf7, 0xc7, 0x97, 0xfe, 0xab, 0x59, 0xff, 0xbf, 0xe9, 0xff, 0xd5, 0xed,
+        0xdf, 0xf3, 0x27, 0x27, 0x5b, 0x5f, 0xf4, 0x29, 0x7f, 0xea, 0x78, 0xbf,
+        0xf5, 0x1e, 0x2f, 0xfe, 0x89, 0xfd, 0xff, 0x61, 0x67, 0x7f, 0xd0, 0x3d,
+        0xb4, 0xdd, 0xb5, 0x83, 0xfe, 0x90, 0xc3, 0xdf, 0xaf, 0xf9, 0xae, 0x3b,
+        0x30, 0x5f, 0x80, 0x9b, 0xff, 0xa2, 0x37, 0x7f, 0xcd, 0x59, 0x52, 0xd5,
+        0xff, 0xda, 0xe0, 0xff, 0xe3, 0x3e, 0x2f, 0xfb, 0xe4, 0xcf, 0xff, 0x44,
+        0xc2, 0xff, 0xae, 0x8a, 0x7f, 0xd4, 0xb7, 0xcc, 0xcb, 0xf2, 0x22, 0x7f,
+        0xe0, 0x70, 0xbf, 0xf2, 0x3c, 0x67, 0xfd, 0x09, 0x33, 0xff, 0xc4, 0x3b,
+        0x7f, 0xc2, 0x17, 0xdf, 0xf4, 0x6e, 0xbf, 0xfe, 0x5e, 0xab, 0xff, 0x40,
+        0xe8, 0x7c, 0xc7, 0xbf, 0xe7, 0xd0, 0x5f, 0xdc, 0x73, 0xff, 0x55, 0x78,
+        0x32, 0x8f, 0xae, 0x25, 0xd1, 0x6a, 0xff, 0xe6, 0x84, 0x7f, 0xe3, 0xf9,
+        0x4f, 0xfd, 0x75, 0x2b, 0xfe, 0x80, 0xa7, 0xff, 0xb1, 0x0a, 0xbf, 0xee,
+        0xfe, 0xff, 0x84, 0x1f, 0x5c, 0x8f, 0x4e, 0xa7, 0xfd, 0x31, 0xbf, 0xfa,
+        0x7a, 0xc7, 0xfe, 0xc4, 0xc2, 0xff, 0x44, 0x1f, 0xd7, 0x4b, 0xff, 0xe2,
+        0xa1, 0xff, 0xe9, 0x1c, 0x6f, 0xfb, 0x8a, 0x93, 0xf8, 0x66, 0xb1, 0xcb,
+        0xbf, 0x6b, 0xaa, 0xca, 0x27, 0xf2, 0x8b, 0x3c, 0xb0, 0x17, 0xa3, 0xff,
+        0xc2, 0x85, 0x1f, 0xf3, 0xa5, 0xf7, 0xfc, 0xea, 0x83, 0xff, 0x5f, 0x10,
+        0x60, 0x8a, 0xfc, 0x54, 0x1c, 0x81, 0x8b, 0x9a, 0xe8, 0xf4, 0xff, 0xe9,
+        0x90, 0x9f, 0xf4, 0xf1, 0x1f, 0xfe, 0x53, 0x9b, 0xff, 0x03, 0xce, 0xff,
+        0xe7, 0x52, 0x9f, 0xf0, 0x83, 0xaf, 0xfc, 0xb0, 0xbd, 0xff, 0x2d, 0x47,
+        0x7f, 0xee, 0xd7, 0xbf, 0xf0, 0x40, 0xe7, 0xfc, 0x9b, 0xc7, 0xff, 0x7d,
+        0xae, 0x53, 0xf9, 0xff, 0x87, 0x81, 0x7f, 0xea, 0xa5, 0xbf, 0xf4, 0x2c,
+        0xbf, 0xfc, 0xb0, 0x15, 0xc9, 0xa1, 0xff, 0x63, 0x68, 0x7f, 0x47, 0xdf,
+        0xc0, 0xb8, 0xc7, 0xf6, 0xff, 0xca, 0x3c, 0xbf, 0xe9, 0xfe, 0xaf, 0x1a,
+        0x3f, 0xfb, 0xcb, 0x24, 0x1f, 0xf0, 0x99, 0xcf, 0xfc, 0x26, 0x21, 0xff,
+        0x09, 0x5c, 0x7a, 0x3d, 0xf3, 0x27, 0xe3, 0x05, 0x3f, 0x88, 0x51, 0x90,
+        0x4e, 0x0b, 0x71, 0xb0, 0x40, 0x88, 0xc1, 0x3f, 0x2c, 0x06, 0x7c, 0xfe,
+        0x23, 0xce, 0x8a, 0x6e, 0x77, 0x25, 0xda, 0x98, 0xdd, 0x87, 0x0c, 0xbc,
+        0x59, 0xf1, 0x47, 0xc1, 0xae, 0xdb, 0x34, 0xa1, 0x0e, 0x77, 0x3c, 0x55,
+        0x66, 0x84, 0x5d, 0x80, 0x58, 0xc7, 0x23, 0xe4, 0xa4, 0x97, 0x93, 0x52,
+        0x7e, 0x54, 0xcb, 0x8b, 0x32, 0xea, 0xbc, 0x30, 0x52, 0x34, 0x4b, 0xaa,
+        0x91, 0x82, 0xfa, 0x43, 0xc6, 0xee, 0xfa, 0x65, 0xc7, 0x55, 0xbb, 0x8d,
+        0xe0, 0x2b, 0x82, 0x4d, 0xef, 0xed, 0x07, 0x49, 0xf9, 0x0f, 0xb8, 0x89,
+        0xc4, 0x79, 0x66, 0xb4, 0x1f, 0x8b, 0xa2, 0x0c, 0x54, 0x0a, 0x31, 0x3e,
+        0x26, 0xc4, 0xd8, 0x9f, 0x2a, 0x8b, 0xd3, 0x64, 0xfe, 0x42, 0xb8, 0xfb,
+        0x35, 0xeb, 0x6e, 0x22, 0x6a, 0xd7, 0x2b, 0xfc, 0x1e, 0xf5, 0xa3, 0x4b,
+        0x1a, 0xea, 0xd8, 0xe6, 0xbc, 0x34, 0xd9, 0x99, 0x4c, 0x36, 0x57, 0xfc,
+        0xa8, 0xb7, 0x23, 0xa4, 0x1e, 0x05, 0x38, 0xe9, 0x24, 0x64, 0x34, 0x79,
+        0x92, 0x74, 0x4d, 0x0b, 0x43, 0x51, 0xd4, 0xfd, 0x75, 0x6f, 0xdf, 0x38,
+        0xa5, 0x2f, 0x2b, 0x36, 0x28, 0xeb, 0xdf, 0x34, 0x3c, 0x09, 0xf3, 0xdf,
+        0x30, 0xb9, 0xbb, 0xcc, 0x9e, 0x45, 0xf0, 0x8b, 0x64, 0x93, 0x81, 0x03,
+        0x89, 0x14, 0x58, 0x85, 0xa1, 0x94, 0x3f, 0x09, 0x42, 0x00, 0x90, 0x1e,
+        0xc8, 0xd1, 0xf0, 0x92, 0x23, 0x08, 0xd2, 0x64, 0xaf, 0x34, 0x4e, 0xb4,
+        0x35, 0x94, 0xb5, 0x67, 0x13, 0xb6, 0x13, 0x98, 0x7d, 0xc7, 0xf1, 0xeb,
+        0xcc, 0xcc, 0x63, 0x61, 0x9a, 0xed, 0xea, 0xe6, 0x5c, 0xdf, 0x62, 0x32,
+        0x16, 0x81, 0x0c, 0x50, 0x98, 0x66, 0xe9, 0xe2, 0x80, 0xa1, 0xe6, 0xa9,
+        0xca, 0x7e, 0x9b, 0x28, 0x09, 0xf6, 0x83, 0xa5, 0xab, 0x6d, 0x45, 0x80,
+        0xf4, 0x0f, 0x21, 0x62, 0x1e, 0xb6, 0xf1, 0xeb, 0xa7, 0x9d, 0xa6, 0xed,
+        0xc7, 0x5c, 0xab, 0x6a, 0x7d, 0xa3, 0x21, 0xae, 0x9b, 0xb1, 0x4a, 0x1e,
+        0x11, 0x44, 0xd1, 0x40, 0x51, 0x14, 0x44, 0xf1, 0x34, 0x4b, 0x13, 0x45,
+        0x12, 0xc1, 0x98, 0xf2, 0x79, 0x41, 0xb2, 0x1c, 0xe3, 0x67, 0xe5, 0x4e,
+        0x1d, 0xf1, 0x47, 0xc6, 0xbc, 0x07, 0xe4, 0x3f, 0x2d, 0x79, 0x13, 0xc0,
+        0xbd, 0x42, 0xc3, 0x09, 0xbe, 0xdb, 0x17, 0x40, 0x88, 0x92, 0x3f, 0x8e,
+        0xe3, 0x48, 0xaa, 0x3c, 0x8c, 0x24, 0xf3, 0xa9, 0xa4, 0xc6, 0x67, 0x3b,
+        0xa5, 0xd8, 0x2d, 0x38, 0x12, 0x36, 0xa6, 0x31, 0x2e, 0xf7, 0xef, 0x0f,
+        0x65, 0xfc, 0xb9, 0xb2, 0x7a, 0xf7, 0xa1, 0xf8, 0xb7, 0x57, 0xa0, 0xf2,
+        0x12, 0x0f, 0x8d, 0x83, 0x30, 0xa8, 0x38, 0x13, 0x0c, 0x07, 0x22, 0x41,
+        0x58, 0xd4, 0x44, 0x2f, 0x12, 0x0d, 0x06, 0x63, 0xa4, 0x3e, 0x7f, 0x5b,
+        0xc6, 0xb6, 0xae, 0xe3, 0xa9, 0xb9, 0x27, 0xab, 0xfb, 0x0f, 0xa2, 0x78,
+        0x17, 0x18, 0x4c, 0xa7, 0x21, 0x49, 0x44, 0x7a, 0x53, 0x16, 0x8c, 0xc6,
+        0xe3, 0x71, 0x89, 0x69, 0x49, 0x29, 0x29, 0x19, 0x49, 0x99, 0xfa, 0xba,
+        0x7a, 0xbb, 0x9c, 0x82, 0x99, 0x8c, 0xf1, 0x6f, 0x2b, 0xf8, 0x97, 0xcb,
+        0xb3, 0xcd, 0xf5, 0x1a, 0x1d, 0xc0, 0x43, 0x42, 0x32, 0x72, 0x72, 0x41,
+        0xe1, 0x60, 0xc0, 0x10, 0xa1, 0x00, 0x40, 0xc0, 0x22, 0xc2, 0x10, 0x1a,
+        0x3c, 0xa9, 0xe4, 0x2c, 0xde, 0x1b, 0x7d, 0xe8, 0x3e, 0xaf, 0xef, 0x73,
+        0xcb, 0x4b, 0x10, 0x91, 0xb8, 0xa8, 0x78, 0x06, 0xc0, 0x32, 0x30, 0xd8,
+        0xa4, 0x22, 0x8f, 0x8a, 0x7c, 0x68, 0x82, 0x9e, 0xc9, 0x6d, 0xbf, 0x2a,
+        0x96, 0x6f, 0x73, 0xec, 0x7e, 0x4e, 0x2d, 0xc8, 0x53, 0x85, 0x06, 0x18,
+        0x40, 0x14, 0x20, 0xe9, 0x10, 0x2a, 0xce, 0xc7, 0x2e, 0x04, 0x3c, 0xef,
+        0x52, 0x10, 0xc4, 0x43, 0x17, 0x3f, 0x9b, 0x54, 0x63, 0x29, 0x40, 0x64,
+        0x68, 0x15, 0x8b, 0x36, 0x62, 0xdf, 0xe2, 0xab, 0xec, 0x8c, 0x4f, 0x28,
+        0x9a, 0xc7, 0x85, 0xad, 0xd2, 0xc1, 0x90, 0xe1, 0x15, 0x96, 0x16, 0xeb,
+        0x73, 0xc8, 0xf2, 0x5d, 0x0b, 0x5f, 0x4b, 0x15, 0x01, 0x2a, 0x1b, 0x14,
+        0x33, 0xc5, 0x32, 0xc6, 0x9d, 0x34, 0xed, 0xc7, 0xac, 0xf9, 0x67, 0xcb,
+        0x3e, 0xb9, 0xf3, 0xc6, 0x03, 0x70, 0x15, 0x03, 0x32, 0x85, 0x72, 0x30,
+        0x01, 0xcc, 0xe6, 0x79, 0x1d, 0xd7, 0x23, 0xc8, 0xee, 0xb9, 0x1d, 0xce,
+        0x67, 0x50, 0xa8, 0x0c, 0x80, 0x2d, 0xfe, 0xa8, 0x54, 0x2c, 0x16, 0x65,
+        0x9a, 0x60, 0xb3, 0x2c, 0x25, 0x81, 0x58, 0xa8, 0x8e, 0x08, 0xc0, 0x03,
+        0xe0, 0x3e, 0xdf, 0xc1, 0xfa, 0x7e, 0x8f, 0xe1, 0xe4, 0x73, 0x07, 0x53,
+        0x63, 0x80, 0xc1, 0xac, 0x00, 0x9e, 0x2f, 0x62, 0xfa, 0x9f, 0x85, 0x9a,
+        0x66, 0x99, 0x82, 0xa1, 0x39, 0xb1, 0x1a, 0x4f, 0xd0, 0x3d, 0x3e, 0xeb,
+        0xd1, 0xfc, 0x3c, 0x97, 0x43, 0xd1, 0x6e, 0x79, 0x1d, 0x4e, 0x67, 0x06,
+        0x84, 0xa6, 0xc1, 0xca, 0xbd, 0xcd, 0xaf, 0x0b, 0xda, 0x60, 0xb3, 0x2d,
+        0x41, 0x66, 0x59, 0xf5, 0xc6, 0xd6, 0xbc, 0x98, 0xd6, 0x68, 0x14, 0xd1,
+        0xca, 0x85, 0x80, 0x79, 0x1d, 0xcf, 0x25, 0xbc, 0xa7, 0x28, 0x76, 0xa2,
+        0x52, 0xb2, 0x27, 0x92, 0xb5, 0x2b, 0x4d, 0xa8, 0x75, 0x05, 0x9a, 0x66,
+        0x9a, 0x96, 0x6d, 0x84, 0xa2, 0x51, 0xa4, 0x8a, 0x80, 0xd1, 0x26, 0xd2,
+        0x82, 0x72, 0xc7, 0x7c, 0x00, 0xb9, 0x1e, 0x8b, 0x93, 0xe4, 0xf5, 0x7a,
+        0xbc, 0x49, 0x95, 0x14, 0xd4, 0x95, 0x0c, 0x13, 0xa9, 0xe2, 0x61, 0x33,
+        0x2d, 0x53, 0x34, 0xcc, 0xb3, 0x00, 0x15, 0x0a, 0x95, 0x72, 0x53, 0x40,
+        0xd7, 0x5f, 0xca, 0x00, 0x17, 0xe2, 0xe4, 0x0f, 0x27, 0xc8, 0xf2, 0x5a,
+        0xac, 0xd6, 0x15, 0x0c, 0x00, 0xef, 0x3b, 0xa6, 0xd4, 0x2c, 0x7a, 0x67,
+        0xf3, 0xc1, 0x66, 0x59, 0xa6, 0x69, 0x82, 0xc1, 0x51, 0x24, 0x8a, 0x46,
+        0x46, 0x81, 0x66, 0xe7, 0x00, 0xf8, 0x1f, 0xc3, 0xba, 0xe8, 0x0e, 0xeb,
+        0x75, 0xb9, 0xd4, 0xe6, 0x6c, 0x68, 0x00, 0xec, 0x17, 0x4b, 0xa7, 0xf7,
+        0xe7, 0xb7, 0xbe, 0xc5, 0x9a, 0x6a, 0x59, 0xa5, 0x93, 0x00, 0xa4, 0x4a,
+        0x08, 0x1d, 0xea, 0x68, 0xe0, 0xac, 0x77, 0x00, 0x57, 0xc3, 0xc9, 0x72,
+        0x7b, 0xac, 0xde, 0x6f, 0x35, 0x06, 0xc1, 0x58, 0x23, 0x09, 0xd4, 0xe9,
+        0x7b, 0x2f, 0xa2, 0xc2, 0x66, 0x5a, 0xa6, 0x60, 0xb0, 0x0a, 0x80, 0xa4,
+        0xc7, 0x72, 0x33, 0x4d, 0x97, 0x49, 0x60, 0x7f, 0x0f, 0x23, 0xd1, 0x6a,
+        0xf5, 0x5a, 0xbb, 0x49, 0xa4, 0x8e, 0x60, 0xdd, 0x9d, 0x89, 0x4b, 0x73,
+        0xa4, 0xb1, 0x61, 0xb0, 0x13, 0x34, 0xcd, 0x33, 0x4c, 0x15, 0x92, 0x99,
+        0x49, 0x80, 0x54, 0x25, 0x63, 0x85, 0x9b, 0xd4, 0xee, 0xb7, 0x5c, 0x97,
+        0x23, 0xc9, 0x6a, 0x0e, 0xa7, 0x30, 0x52, 0x80, 0x4c, 0xb5, 0x50, 0x5b,
+        0x0b, 0xc5, 0xe1, 0x7d, 0x16, 0x69, 0x84, 0xc2, 0x66, 0x52, 0x2b, 0x14,
+        0x91, 0x4c, 0x84, 0xe8, 0x3b, 0x7c, 0xaf, 0x4b, 0x73, 0xba, 0xe8, 0x79,
+        0x3d, 0xd7, 0x25, 0xb9, 0xd4, 0xe1, 0x60, 0x1a, 0x00, 0x1c, 0x59, 0x3a,
+        0x5e, 0xd3, 0xc2, 0xcd, 0x33, 0x6c, 0xc2, 0x66, 0x96, 0x2b, 0x25, 0x89,
+        0xc9, 0x40, 0x0a, 0xb9, 0x83, 0xe3, 0xe3, 0xf8, 0x77, 0x7c, 0x97, 0x23,
+        0xba, 0xe4, 0xb5, 0x39, 0x9d, 0x42, 0xa0, 0x32, 0x02, 0xa7, 0xc1, 0x74,
+        0xbc, 0x9f, 0x45, 0x9a, 0x60, 0xb3, 0x2c, 0x25, 0x81, 0x59, 0x24, 0x8e,
+        0x08, 0xc0, 0x07, 0xc7, 0xdb, 0xe5, 0x7a, 0x15, 0xe9, 0x6e, 0x79, 0x2e,
+        0x4b, 0x33, 0xa8, 0x56, 0x38, 0x30, 0x06, 0xb0, 0x02, 0x75, 0x3d, 0xaf,
+        0xa5, 0xec, 0xb3, 0x2c, 0x25, 0x81, 0x59, 0x24, 0x94, 0xaa, 0x90, 0x23,
+        0xec, 0x0f, 0x55, 0xdd, 0x7a, 0x3c, 0x8f, 0x27, 0xc9, 0x72, 0x5a, 0xae,
+        0x47, 0x55, 0x99, 0xc1, 0xa1, 0x28, 0x54, 0x0b, 0x73, 0xa5, 0xd1, 0x7b,
+        0x2c, 0x26, 0x0b, 0x34, 0xcc, 0xac, 0x56, 0x2b, 0x14, 0x89, 0xc9, 0x48,
+        0xf4, 0x40, 0xa7, 0x31, 0x74, 0x5e, 0xc3, 0xf8, 0x77, 0x5c, 0x96, 0xf2,
+        0x9c, 0xa1, 0xda, 0x85, 0x4a, 0xc8, 0x9e, 0x4a, 0xd4, 0xac, 0xb8, 0x70,
+        0x61, 0x6b, 0x74, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1a, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x96,
+        0x36,
+    };
+    const uint8_t alac24[] = {
+        0x63, 0x61, 0x66, 0x66, 0x00, 0x01, 0x00, 0x00, 0x64, 0x65, 0x73, 0x63,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0x40, 0xe7, 0x70, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x61, 0x6c, 0x61, 0x63, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x01,
+        0x00, 0x00, 0x00, 0x00, 0x63, 0x68, 0x61, 0x6e, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x0c, 0x00, 0x64, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x6b, 0x75, 0x6b, 0x69, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x30, 0x00, 0x00, 0x00, 0x0c, 0x66, 0x72, 0x6d, 0x61,
+        0x61, 0x6c, 0x61, 0x63, 0x00, 0x00, 0x00, 0x24, 0x61, 0x6c, 0x61, 0x63,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x18, 0x28, 0x0a,
+        0x0e, 0x01, 0x00, 0x00, 0x00, 0x00, 0x30, 0x04, 0x00, 0x11, 0x94, 0x00,
+        0x00, 0x00, 0xbb, 0x80, 0x69, 0x6e, 0x66, 0x6f, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x19, 0x00, 0x00, 0x00, 0x01, 0x65, 0x6e, 0x63, 0x6f,
+        0x64, 0x65, 0x72, 0x00, 0x4c, 0x61, 0x76, 0x66, 0x36, 0x31, 0x2e, 0x31,
+        0x2e, 0x31, 0x30, 0x30, 0x00, 0x64, 0x61, 0x74, 0x61, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x0d, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x14,
+        0x00, 0x00, 0x0c, 0xc0, 0x00, 0x00, 0x11, 0x0c, 0x01, 0xe4, 0x00, 0x93,
+        0xff, 0xda, 0x00, 0x23, 0xff, 0xe3, 0xff, 0xa6, 0xe1, 0x99, 0x8d, 0x52,
+        0xd2, 0xfc, 0x2b, 0x08, 0x03, 0x05, 0xd5, 0x77, 0xe5, 0x13, 0x97, 0x62,
+        0x75, 0xd0, 0x54, 0xe3, 0x1e, 0x50, 0x06, 0x4b, 0xe2, 0x35, 0x79, 0xe2,
+        0xf1, 0xef, 0xaa, 0xae, 0x54, 0x49, 0x15, 0x4b, 0x31, 0x15, 0x86, 0x81,
+        0xbe, 0x25, 0xc1, 0x76, 0x6d, 0xe0, 0xfe, 0x04, 0x10, 0x2b, 0x4b, 0xdf,
+        0x4e, 0xc2, 0x84, 0xde, 0x96, 0x2b, 0x67, 0x9a, 0x3c, 0x73, 0xa5, 0x2f,
+        0x11, 0x74, 0x4a, 0x85, 0xe3, 0xd3, 0xb3, 0x51, 0xba, 0x2b, 0x4f, 0xe3,
+        0x71, 0x9e, 0x79, 0x81, 0x79, 0xd0, 0x40, 0xc0, 0x8d, 0x47, 0xc2, 0x31,
+        0xe0, 0x05, 0xe6, 0x7b, 0x3d, 0xd1, 0xc6, 0xaa, 0x12, 0x7a, 0x4a, 0x42,
+        0xff, 0x30, 0x7c, 0x5b, 0x49, 0xdf, 0xd7, 0x27, 0x52, 0x0b, 0xc0, 0xb9,
+        0xf7, 0xaf, 0xc4, 0x7c, 0x9f, 0xe5, 0x31, 0xc6, 0x1f, 0x8d, 0x0f, 0xef,
+        0xec, 0xc8, 0xa4, 0x3c, 0x10, 0x44, 0x20, 0x52, 0xc2, 0x3d, 0xe9, 0x6a,
+        0xa0, 0x5d, 0x81, 0x82, 0x98, 0x3e, 0x43, 0x39, 0x17, 0xe2, 0x15, 0xa9,
+        0x5d, 0x7f, 0x90, 0x55, 0xdc, 0x6f, 0x22, 0xd0, 0xe3, 0x58, 0x6c, 0xdb,
+        0xe8, 0xcf, 0x0f, 0xa1, 0x02, 0xef, 0x06, 0xa9, 0x0e, 0x1a, 0x85, 0x96,
+        0x9e, 0x06, 0x5d, 0xae, 0x34, 0xa4, 0x39, 0x23, 0x02, 0xbf, 0xff, 0xa6,
+        0x95, 0x1f, 0xb8, 0xa3, 0x80, 0xa7, 0x46, 0x77, 0x90, 0x55, 0x6b, 0x8a,
+        0x85, 0xe9, 0x7b, 0x85, 0x70, 0x41, 0xbc, 0x59, 0x3f, 0xb6, 0x2c, 0xc4,
+        0x05, 0xb0, 0x7a, 0x47, 0x92, 0x93, 0xda, 0xa2, 0x15, 0x30, 0x95, 0x28,
+        0xd2, 0xf8, 0xbe, 0x25, 0x99, 0x53, 0xe3, 0x65, 0xef, 0x89, 0x98, 0x15,
+        0x5c, 0x49, 0xc0, 0xf5, 0x17, 0xb8, 0xcb, 0x05, 0xec, 0x69, 0xe4, 0x09,
+        0xe9, 0x4e, 0x10, 0x7b, 0x26, 0x3f, 0x1c, 0x2f, 0x17, 0x5e, 0xf4, 0x09,
+        0x0d, 0xbb, 0x6a, 0xc5, 0x69, 0x6d, 0x91, 0x9e, 0xa2, 0x7f, 0x1d, 0xbc,
+        0xe5, 0x3e, 0x8e, 0x68, 0x26, 0x45, 0xd9, 0x74, 0x0e, 0x7a, 0xeb, 0x28,
+        0x55, 0x7b, 0x3a, 0xb6, 0x3c, 0x85, 0x20, 0x2c, 0x13, 0xb3, 0x9f, 0x48,
+        0xb7, 0x18, 0x5d, 0x8c, 0x8c, 0x1c, 0xee, 0x08, 0xde, 0x6b, 0xb0, 0x98,
+        0x93, 0x56, 0x74, 0x57, 0x49, 0x8a, 0xcf, 0x5c, 0xc6, 0x46, 0x3b, 0x46,
+        0xf9, 0xb5, 0xe1, 0x4a, 0x5b, 0xa4, 0xf7, 0x3c, 0xbb, 0xc9, 0xcd, 0xbe,
+        0x88, 0xa0, 0xc1, 0x24, 0xde, 0x08, 0x45, 0x24, 0x78, 0x7a, 0xff, 0x48,
+        0xaa, 0x23, 0x90, 0x0b, 0xdd, 0x31, 0x56, 0x20, 0xf9, 0x5d, 0xa0, 0xc0,
+        0xcc, 0xbc, 0x79, 0x93, 0x16, 0xf1, 0x07, 0x04, 0x0d, 0x5a, 0x54, 0x17,
+        0xb5, 0xec, 0x62, 0x0d, 0x8e, 0xb5, 0x46, 0x14, 0x74, 0xc5, 0x6a, 0x68,
+        0x13, 0x15, 0x68, 0x9e, 0xe2, 0xd1, 0x11, 0xc7, 0x4b, 0xe2, 0x49, 0x42,
+        0x9f, 0x11, 0x0e, 0x26, 0x82, 0x1a, 0xe9, 0x42, 0x94, 0xdc, 0x62, 0x65,
+        0xfe, 0x87, 0xa1, 0xc6, 0x47, 0xb2, 0x50, 0xbc, 0xcb, 0x63, 0x7a, 0x99,
+        0xce, 0x9d, 0x60, 0x13, 0x2b, 0x00, 0x5a, 0x16, 0xfa, 0x4c, 0xdd, 0x76,
+        0x95, 0xbb, 0xbc, 0x82, 0xa5, 0x0d, 0x96, 0xee, 0x99, 0xb3, 0x69, 0xc7,
+        0xef, 0xff, 0xe6, 0x9b, 0xb3, 0xec, 0x4d, 0xb6, 0x01, 0x5d, 0x32, 0x08,
+        0x33, 0x8c, 0xe6, 0x58, 0x17, 0x3a, 0xd9, 0x75, 0x7d, 0x9e, 0x4c, 0xb8,
+        0xf0, 0x6c, 0x17, 0x92, 0xed, 0x8b, 0x9e, 0x42, 0x8c, 0x7a, 0x62, 0x52,
+        0xe5, 0x95, 0xe4, 0x34, 0xb3, 0xa4, 0xaf, 0xb4, 0x62, 0x6e, 0xfc, 0xf2,
+        0xb7, 0x9e, 0x55, 0xd7, 0x8c, 0x12, 0xf3, 0x50, 0x68, 0xa4, 0xba, 0x2f,
+        0x61, 0xc6, 0xe8, 0xac, 0x75, 0x56, 0x79, 0x1e, 0xe9, 0xb9, 0x65, 0x45,
+        0x57, 0x46, 0x4d, 0x75, 0x26, 0x22, 0xdc, 0xc3, 0x55, 0xd4, 0x2c, 0xf7,
+        0x99, 0x15, 0x81, 0x96, 0xd6, 0x78, 0x90, 0x31, 0x3d, 0x1d, 0x49, 0x3a,
+        0x68, 0xb2, 0xc3, 0x94, 0x6e, 0xa4, 0x5c, 0xa4, 0xa4, 0x58, 0x30, 0xe3,
+        0xd3, 0xf0, 0xa5, 0xd5, 0xa7, 0x34, 0x72, 0xd4, 0x3c, 0x27, 0xac, 0xc8,
+        0x32, 0x99, 0x93, 0x71, 0x71, 0x57, 0x2d, 0xb8, 0x30, 0xd2, 0xf3, 0x4e,
+        0xa2, 0x4d, 0xdc, 0x65, 0x2b, 0x78, 0x6e, 0x2a, 0x1e, 0x7f, 0xce, 0x83,
+        0x2a, 0x1d, 0xaa, 0xc1, 0xf4, 0x90, 0x2d, 0x97, 0x66, 0x15, 0x8f, 0x33,
+        0xf3, 0xb2, 0xd5, 0xe9, 0xe0, 0xe5, 0xcc, 0x2f, 0x33, 0xd5, 0xc1, 0x94,
+        0x97, 0xf4, 0x9e, 0x98, 0x2d, 0xe6, 0x24, 0xb5, 0x09, 0xe9, 0x9c, 0x41,
+        0x01, 0xe7, 0x6c, 0xcc, 0x10, 0x5f, 0xc8, 0x8e, 0x3e, 0xb4, 0x73, 0xb8,
+        0x5c, 0x83, 0x8a, 0x8e, 0xeb, 0xf4, 0x4e, 0x5d, 0x61, 0x51, 0xee, 0xb8,
+        0xcb, 0x0c, 0xe3, 0x19, 0xb6, 0x8f, 0x8f, 0x60, 0x92, 0x2a, 0xc9, 0xaa,
+        0x5d, 0xd9, 0x03, 0x7e, 0x1e, 0xab, 0x4b, 0xdb, 0x24, 0xc1, 0x3d, 0xd7,
+        0xd1, 0xf0, 0x38, 0x87, 0x27, 0x03, 0xfb, 0xb5, 0x36, 0x27, 0x17, 0x66,
+        0x22, 0x72, 0x31, 0x4b, 0xc5, 0x6a, 0xf1, 0x40, 0xdc, 0x69, 0x07, 0x55,
+        0xb8, 0xb7, 0xe7, 0x60, 0xc3, 0x54, 0x6a, 0xf1, 0x20, 0x09, 0x79, 0x38,
+        0x24, 0x9c, 0x8b, 0x8b, 0xf9, 0xdc, 0x83, 0x89, 0x21, 0x70, 0xc1, 0xd6,
+        0x62, 0x0e, 0x16, 0x7e, 0x53, 0x70, 0x0e, 0x8f, 0xb1, 0x2b, 0xf0, 0x34,
+        0xd6, 0xd7, 0x22, 0x88, 0x44, 0x68, 0xd0, 0x4a, 0x39, 0xf3, 0xb3, 0xcc,
+        0x66, 0x0b, 0x40, 0xce, 0x45, 0xf6, 0x3c, 0x35, 0x0c, 0xb9, 0xa0, 0x0b,
+        0x8f, 0x58, 0xa4, 0xa4, 0x6b, 0x2f, 0x21, 0xc5, 0x2f, 0x6a, 0x97, 0xf7,
+        0x21, 0xa5, 0x6d, 0x11, 0x30, 0x29, 0xdd, 0x3e, 0x27, 0x5a, 0xac, 0x99,
+        0xcb, 0xc0, 0x7e, 0xc2, 0x2f, 0x9a, 0x8a, 0x49, 0x88, 0x00, 0x87, 0xb1,
+        0xa1, 0x67, 0x6a, 0x1e, 0x0b, 0x3a, 0xe0, 0xae, 0x6c, 0x10, 0x0d, 0x15,
+        0x30, 0x55, 0xdc, 0x08, 0x4a, 0x53, 0xaa, 0x72, 0x13, 0xf1, 0x36, 0xd7,
+        0xf3, 0x73, 0x88, 0x12, 0xf1, 0x11, 0x09, 0x63, 0x73, 0x0f, 0x11, 0xa2,
+        0x1d, 0xcc, 0x9a, 0x95, 0xa5, 0x38, 0xbe, 0xb5, 0x1b, 0xf4, 0xe9, 0x30,
+        0x6f, 0x6b, 0xd4, 0x6e, 0x80, 0xe0, 0xed, 0x8b, 0xe0, 0x58, 0xc4, 0xea,
+        0x8a, 0xb5, 0x0c, 0x09, 0x30, 0x8a, 0xb0, 0xca, 0xbb, 0xee, 0x9e, 0x56,
+        0x8b, 0xfe, 0x0b, 0x69, 0x86, 0xf9, 0xfe, 0x34, 0xa3, 0x2d, 0x47, 0x5a,
+        0x3c, 0x83, 0x2c, 0xed, 0x88, 0x67, 0x58, 0xb0, 0x18, 0x78, 0x46, 0xd5,
+        0xed, 0x8a, 0x6b, 0xf3, 0x89, 0x2c, 0x85, 0x65, 0x29, 0xde, 0xed, 0x16,
+        0x7c, 0x5b, 0xa7, 0xbd, 0x90, 0x82, 0xc2, 0xa0, 0xa2, 0xf0, 0xde, 0x71,
+        0x5e, 0xde, 0x92, 0x82, 0xe5, 0x63, 0x1a, 0xe3, 0xe0, 0x27, 0xcd, 0x33,
+        0x90, 0x1e, 0x62, 0x30, 0xb1, 0xf8, 0x86, 0x5a, 0xd0, 0xcc, 0x9d, 0x8f,
+        0x3e, 0xd3, 0x69, 0x11, 0x32, 0x36, 0x78, 0xe0, 0x74, 0xe7, 0x12, 0x82,
+        0x94, 0xde, 0xfe, 0x93, 0x8a, 0x98, 0x36, 0x28, 0xa0, 0x6b, 0xbe, 0x3e,
+        0xa8, 0xe6, 0x93, 0xd9, 0x85, 0x09, 0x1e, 0x34, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7d, 0x35, 0xd6, 0x50,
+        0x0c, 0x99, 0x28, 0xe3, 0x49, 0x9b, 0xac, 0xf5, 0x32, 0x92, 0xad, 0x13,
+        0x92, 0xf3, 0xa1, 0x45, 0x76, 0xda, 0xf6, 0xba, 0x34, 0x7c, 0x13, 0x2e,
+        0x9e, 0x8e, 0x60, 0xa3, 0x9c, 0x1c, 0xe9, 0x37, 0x69, 0xd7, 0x58, 0x52,
+        0x3c, 0xd0, 0x90, 0xeb, 0x86, 0x47, 0xde, 0xa7, 0x36, 0x6f, 0x1d, 0xa9,
+        0x37, 0x44, 0x3b, 0x75, 0x8b, 0x60, 0xe6, 0x20, 0x46, 0x18, 0xa0, 0xea,
+        0xd1, 0x3b, 0xa7, 0xd0, 0xaf, 0x29, 0xb6, 0x99, 0x23, 0x5f, 0x81, 0xfd,
+        0xd2, 0x09, 0x2c, 0x39, 0xe9, 0xbe, 0x32, 0x64, 0xbf, 0x21, 0x95, 0xd7,
+        0x3b, 0x72, 0x55, 0x13, 0xc6, 0x54, 0x6d, 0x53, 0x6b, 0x69, 0x5b, 0x97,
+        0xfa, 0x6d, 0xcb, 0x65, 0xab, 0x56, 0xa0, 0xde, 0xa5, 0x7d, 0x13, 0xf1,
+        0xdc, 0x8d, 0xd9, 0x82, 0x9b, 0x5e, 0xbe, 0xd3, 0x1c, 0x67, 0xf2, 0x19,
+        0x88, 0xc8, 0xd3, 0x68, 0x2e, 0xcb, 0xee, 0xfa, 0x19, 0xc2, 0x71, 0x5a,
+        0xd1, 0xb0, 0xed, 0x6f, 0x38, 0x1b, 0x31, 0xd0, 0x83, 0x69, 0x13, 0x54,
+        0xbd, 0x43, 0xc8, 0x30, 0x50, 0x43, 0xc7, 0x2e, 0x0b, 0xf5, 0x8f, 0x64,
+        0xd7, 0x2a, 0x22, 0x4f, 0xbd, 0x39, 0xb7, 0xf2, 0x31, 0x30, 0xb2, 0xd6,
+        0xc5, 0xd5, 0x7a, 0x27, 0xcc, 0x04, 0x18, 0xda, 0x99, 0x40, 0x5f, 0xc2,
+        0x22, 0x20, 0x86, 0xba, 0xdb, 0x8b, 0x95, 0x39, 0xff, 0x00, 0xb1, 0xff,
+        0x84, 0x9e, 0x7f, 0xc1, 0x44, 0xbf, 0x90, 0xbf, 0x9f, 0x3b, 0x3d, 0xe3,
+        0x3a, 0xa2, 0xd0, 0x92, 0x49, 0x7b, 0x3c, 0x53, 0x80, 0x40, 0xc4, 0x29,
+        0x3d, 0x64, 0x60, 0xad, 0xde, 0xef, 0x9a, 0xd8, 0x0c, 0x9a, 0xee, 0x8d,
+        0x0c, 0xb8, 0xb2, 0x03, 0xea, 0x08, 0xc4, 0x11, 0x7d, 0xa7, 0x89, 0x3b,
+        0x3e, 0xeb, 0xcb, 0xc6, 0x1e, 0x0d, 0x7a, 0x67, 0x2b, 0x34, 0xb4, 0x68,
+        0xd9, 0x18, 0x35, 0xa0, 0x65, 0x0f, 0xa6, 0x47, 0x73, 0xbe, 0x95, 0x0f,
+        0x13, 0x4a, 0x06, 0x0a, 0xc1, 0x9f, 0x09, 0x9c, 0x6f, 0x06, 0x2b, 0x32,
+        0xd7, 0x3f, 0xe2, 0x91, 0x30, 0x2a, 0x14, 0xc2, 0x93, 0xf5, 0x55, 0x68,
+        0xd2, 0x50, 0x60, 0xfc, 0xdf, 0x49, 0x88, 0xf0, 0xbd, 0x08, 0x18, 0x80,
+        0xa8, 0x45, 0x0d, 0xcc, 0xe7, 0xa5, 0xb7, 0x9f, 0x4a, 0x69, 0xdb, 0x58,
+        0x1b, 0x64, 0x17, 0xb4, 0x18, 0xd2, 0x32, 0x84, 0x02, 0xf4, 0x08, 0x0c,
+        0xe5, 0x62, 0x2f, 0xa5, 0x9a, 0x3d, 0xda, 0x24, 0x9d, 0x57, 0x2e, 0x14,
+        0x84, 0xf2, 0x69, 0xd0, 0x82, 0xaa, 0x42, 0x7b, 0x53, 0xe1, 0x66, 0xb1,
+        0xc8, 0x9f, 0x39, 0x58, 0x70, 0x20, 0x52, 0xe1, 0xdc, 0x03, 0xd6, 0xec,
+        0x27, 0x39, 0xd5, 0xa1, 0x40, 0xce, 0xfe, 0x8b, 0xdf, 0xcf, 0x4d, 0x80,
+        0xe2, 0x7c, 0x6e, 0xec, 0x95, 0x60, 0xa6, 0x8d, 0xb8, 0x7a, 0xcb, 0x1c,
+        0xd8, 0x8e, 0xa1, 0x4c, 0x0d, 0x8d, 0x85, 0x84, 0xed, 0x46, 0x63, 0x98,
+        0x27, 0x93, 0x04, 0x9c, 0x1a, 0xa5, 0x2a, 0x12, 0xb8, 0x7e, 0xdc, 0x65,
+        0xa1, 0x9b, 0x87, 0xde, 0x67, 0x5e, 0x20, 0xb5, 0xa9, 0x10, 0xa6, 0x55,
+        0xca, 0x44, 0x23, 0x33, 0x09, 0x2f, 0xe9, 0x26, 0x91, 0x96, 0x0a, 0x75,
+        0x9a, 0xfa, 0x9d, 0x09, 0x95, 0x6d, 0xec, 0x27, 0x81, 0x68, 0xca, 0x18,
+        0x11, 0x86, 0x5b, 0xd8, 0xf7, 0x38, 0xc0, 0x57, 0x6c, 0x64, 0x40, 0xc2,
+        0x82, 0x9a, 0x30, 0xcc, 0x78, 0x61, 0x1e, 0x00, 0xcb, 0x1c, 0x89, 0x11,
+        0xe5, 0x38, 0x40, 0x42, 0x04, 0xd0, 0xa3, 0xe4, 0x0f, 0xbd, 0x04, 0xe2,
+        0xf0, 0x6e, 0xcf, 0x93, 0x3e, 0x9b, 0xca, 0xe0, 0x89, 0x1e, 0xb1, 0xa5,
+        0x99, 0x7e, 0x8d, 0x31, 0x04, 0x39, 0xb4, 0xd4, 0xba, 0xad, 0xd2, 0xd0,
+        0xae, 0x24, 0x09, 0xde, 0xfc, 0x32, 0x16, 0xd4, 0xca, 0x68, 0x6c, 0x16,
+        0x90, 0xc8, 0x6f, 0x64, 0x0d, 0x0c, 0xba, 0x58, 0x08, 0x41, 0xb5, 0x3f,
+        0xa9, 0x44, 0x6a, 0x9b, 0xe9, 0x46, 0x4c, 0x7a, 0xa6, 0x62, 0xd8, 0xc7,
+        0xab, 0x27, 0x74, 0xbd, 0xfb, 0xaa, 0x6d, 0x58, 0x3b, 0x29, 0x88, 0x2b,
+        0x38, 0xa8, 0xfd, 0x05, 0x2b, 0xe5, 0xeb, 0x96, 0x62, 0x5e, 0xa4, 0x4d,
+        0x13, 0x60, 0x72, 0x02, 0x75, 0xf3, 0xb4, 0x2c, 0x5b, 0x90, 0x39, 0xc0,
+        0xdc, 0xd1, 0x8d, 0xa6, 0x8b, 0x61, 0xc5, 0x06, 0xa5, 0xcb, 0x31, 0x78,
+        0x1a, 0x34, 0x61, 0x43, 0xaf, 0xa8, 0x65, 0x7a, 0xbd, 0x3d, 0x25, 0x68,
+        0xb8, 0x76, 0x89, 0xa1, 0xf8, 0x72, 0xaa, 0xbe, 0x4c, 0xc4, 0x77, 0xf4,
+        0x9f, 0x16, 0xa9, 0x15, 0x10, 0x99, 0x3f, 0x6f, 0xa6, 0xa7, 0xd0, 0xea,
+        0x2a, 0x23, 0xa9, 0x1e, 0x49, 0xa8, 0x4a, 0x2b, 0xc5, 0xc6, 0x7d, 0xed,
+        0x3a, 0xbf, 0xa7, 0x36, 0x6f, 0x42, 0xe9, 0x04, 0xce, 0xd6, 0xa1, 0x4b,
+        0x13, 0x18, 0x90, 0x60, 0x3a, 0x68, 0x93, 0xf3, 0x05, 0xb8, 0x17, 0x77,
+        0x59, 0x52, 0x7b, 0x1a, 0x8e, 0xc4, 0xe3, 0x6c, 0x25, 0x84, 0x4f, 0x16,
+        0xbe, 0xf3, 0x40, 0x2f, 0xe4, 0x48, 0x22, 0x1f, 0xdc, 0xe3, 0x2b, 0xfc,
+        0x2c, 0xdf, 0x99, 0xa5, 0xa5, 0x8a, 0xa7, 0x4e, 0x32, 0xc6, 0xd3, 0xe1,
+        0x70, 0xff, 0xa1, 0xd1, 0x65, 0x6e, 0xe0, 0x67, 0x72, 0x45, 0x51, 0x56,
+        0x60, 0x50, 0x2f, 0x46, 0x40, 0x8b, 0x4e, 0xaa, 0x29, 0x31, 0xe8, 0xa1,
+        0x4c, 0x17, 0x8a, 0xc0, 0x4f, 0x6c, 0x09, 0x4a, 0x1a, 0x98, 0x15, 0xe1,
+        0x43, 0x1e, 0x16, 0x32, 0x1c, 0x3e, 0xed, 0x1b, 0x73, 0x7c, 0xd8, 0x22,
+        0x87, 0x71, 0x8d, 0x1b, 0x43, 0xe5, 0x1c, 0xd4, 0x9d, 0x46, 0x17, 0x8f,
+        0x2a, 0xd2, 0x3a, 0xfb, 0x2a, 0x55, 0x71, 0x21, 0xab, 0x07, 0x43, 0x98,
+        0x7b, 0x7a, 0x13, 0x1a, 0xbc, 0x0b, 0x40, 0x9b, 0x2c, 0x58, 0x1e, 0x92,
+        0xdc, 0xc4, 0x70, 0x6b, 0xb8, 0x7e, 0x63, 0xb0, 0xf1, 0x2c, 0xaf, 0xa2,
+        0xd8, 0x44, 0xa2, 0xe8, 0xc5, 0xd5, 0x7d, 0x29, 0xa4, 0x6a, 0x02, 0x1d,
+        0xb1, 0xee, 0xe3, 0x46, 0x9b, 0x6a, 0x05, 0x6f, 0x22, 0x44, 0xda, 0xbd,
+        0x1e, 0x97, 0x38, 0xa8, 0x83, 0x3f, 0xa1, 0x23, 0xac, 0x76, 0x70, 0xdd,
+        0x76, 0x3b, 0x9e, 0x8c, 0xc2, 0xa6, 0xaa, 0xb9, 0x0a, 0x2f, 0x95, 0x30,
+        0x7a, 0x66, 0x68, 0x49, 0x9f, 0xd7, 0xa3, 0xde, 0x75, 0x5c, 0x2e, 0xde,
+        0x4a, 0x0c, 0x91, 0x11, 0x97, 0x9b, 0x79, 0x87, 0x36, 0x47, 0xe5, 0xf0,
+        0xae, 0xb0, 0x8d, 0xb1, 0xa4, 0xbc, 0x3f, 0x98, 0xf0, 0xf2, 0x2e, 0x27,
+        0x73, 0xb8, 0xef, 0x74, 0x7e, 0xf0, 0x3b, 0x87, 0x91, 0xb8, 0x11, 0x74,
+        0xd2, 0xb9, 0xb1, 0x64, 0x2e, 0x4d, 0x7c, 0x8b, 0xa6, 0xba, 0x7e, 0x15,
+        0x3a, 0x70, 0xcc, 0x43, 0x2f, 0xa7, 0x02, 0x38, 0xcb, 0x96, 0x6d, 0x75,
+        0xa5, 0x09, 0x14, 0xf1, 0x59, 0xa9, 0x10, 0x73, 0xd8, 0xf3, 0xbc, 0x7b,
+        0x6d, 0x35, 0xd7, 0xce, 0xcc, 0x0a, 0xe1, 0x9e, 0x6b, 0xa9, 0x04, 0xd2,
+        0xa5, 0x4a, 0xb3, 0x9e, 0x88, 0x8c, 0xfa, 0x40, 0xc1, 0xeb, 0xc5, 0x24,
+        0xd4, 0x3d, 0xb1, 0x0f, 0x87, 0xfc, 0xf0, 0xc9, 0xae, 0x9c, 0x4e, 0xbc,
+        0x97, 0x15, 0x81, 0xec, 0x86, 0x69, 0x3c, 0xab, 0xd0, 0x8c, 0x99, 0x88,
+        0x11, 0xae, 0xc6, 0x1a, 0x8f, 0x56, 0xe5, 0xf3, 0x81, 0x61, 0xcb, 0x9b,
+        0xcd, 0xc4, 0x2a, 0x08, 0xee, 0xa2, 0x55, 0x2d, 0x43, 0x44, 0xfd, 0x4c,
+        0xd6, 0xa7, 0xde, 0x9c, 0x9e, 0x6c, 0x04, 0xbc, 0x22, 0xd9, 0x39, 0x7f,
+        0x75, 0xec, 0x45, 0x68, 0x4a, 0x2f, 0xc2, 0xa6, 0x0c, 0x45, 0x01, 0x48,
+        0xe2, 0x32, 0x0d, 0x05, 0xb2, 0xa2, 0x13, 0x9e, 0x08, 0x02, 0x84, 0x23,
+        0xbc, 0x30, 0x5e, 0x70, 0x65, 0xe3, 0xd0, 0x92, 0x2f, 0xca, 0x59, 0x12,
+        0xbc, 0x1e, 0x40, 0xb0, 0xec, 0x54, 0x76, 0xc8, 0x75, 0xcc, 0x39, 0x44,
+        0x19, 0xd2, 0x83, 0x6a, 0xbf, 0x1f, 0xc8, 0x93, 0x9e, 0x9b, 0x49, 0x18,
+        0x34, 0x8c, 0xfe, 0x53, 0xac, 0x1d, 0x4d, 0x77, 0x68, 0x14, 0x09, 0x12,
+        0xcb, 0xcf, 0x00, 0xa7, 0x08, 0x32, 0x87, 0x5e, 0x38, 0xe8, 0xc6, 0x0f,
+        0x52, 0x45, 0x5b, 0xdf, 0xf1, 0x5a, 0xb5, 0x32, 0x8e, 0xff, 0xef, 0x3f,
+        0xf0, 0x50, 0xa7, 0xae, 0x13, 0x34, 0x69, 0xf6, 0x3f, 0x6d, 0x4b, 0x0a,
+        0x66, 0x3b, 0x29, 0xc6, 0xdd, 0x8e, 0x94, 0xc8, 0xa0, 0xe0, 0xb4, 0xe5,
+        0x50, 0xee, 0xa3, 0xde, 0x08, 0xe4, 0xd1, 0xd0, 0x95, 0x2a, 0x98, 0x90,
+        0x95, 0x98, 0x45, 0x61, 0x94, 0x8c, 0xce, 0x53, 0x59, 0xf3, 0x04, 0x09,
+        0xe8, 0x55, 0x9c, 0x20, 0xc1, 0x98, 0xda, 0xdb, 0x52, 0x0f, 0x46, 0x9b,
+        0x01, 0x25, 0x5f, 0xbe, 0x48, 0xa9, 0xdb, 0x7d, 0xaf, 0x96, 0xaf, 0xf0,
+        0x4e, 0xc2, 0x87, 0x59, 0xb5, 0xb6, 0x64, 0x0f, 0x17, 0xa4, 0x81, 0x7e,
+        0x5a, 0x31, 0xbe, 0x69, 0x99, 0xa8, 0x34, 0x64, 0x6e, 0x90, 0xc3, 0x2d,
+        0xe1, 0x10, 0xbd, 0x37, 0x94, 0x3d, 0x57, 0x2f, 0x7c, 0x47, 0xc9, 0xf2,
+        0x7c, 0x7b, 0x80, 0x5c, 0x2b, 0x89, 0x6a, 0x98, 0xab, 0x8f, 0xb6, 0xc8,
+        0xd9, 0x3d, 0xc2, 0x08, 0x17, 0xdd, 0x16, 0xc7, 0xde, 0xb9, 0x75, 0xaa,
+        0xf3, 0x70, 0x0c, 0x78, 0x62, 0x1c, 0xc1, 0x3a, 0xac, 0xce, 0xda, 0x8a,
+        0xe7, 0x5e, 0xa4, 0x2d, 0xa0, 0x26, 0xe7, 0x12, 0xda, 0x0c, 0x02, 0xc4,
+        0x2d, 0xb3, 0xe1, 0xd2, 0x09, 0x2e, 0x1e, 0xfe, 0x6a, 0xfa, 0x60, 0x20,
+        0x95, 0x33, 0x34, 0x92, 0x0f, 0xba, 0x74, 0x53, 0x0f, 0xb0, 0x2b, 0x1d,
+        0xb2, 0x51, 0x52, 0x85, 0x0f, 0x3c, 0xe8, 0x48, 0x5b, 0xf7, 0xab, 0x1f,
+        0x62, 0x69, 0x05, 0xbc, 0x07, 0xf8, 0x78, 0x23, 0x52, 0xc3, 0xc3, 0x56,
+        0xb0, 0x8a, 0x99, 0xc9, 0xf1, 0xb9, 0xee, 0xfa, 0x3f, 0xed, 0x47, 0x0b,
+        0x55, 0x95, 0x66, 0x62, 0xe2, 0xc6, 0x8d, 0x39, 0x33, 0x86, 0x4b, 0x32,
+        0xb6, 0x51, 0xc5, 0xa6, 0x89, 0xfe, 0x79, 0x90, 0xa0, 0xaa, 0xe2, 0xb7,
+        0x93, 0x33, 0x24, 0xa9, 0x15, 0x44, 0x2a, 0xd2, 0xf3, 0x24, 0xa0, 0x03,
+        0x29, 0x75, 0xe4, 0xb9, 0xee, 0x72, 0x65, 0xee, 0xb6, 0x97, 0xfd, 0xe6,
+        0x42, 0x44, 0xbf, 0x7b, 0x1e, 0xb2, 0xba, 0x89, 0x2f, 0xdf, 0xcc, 0xd0,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1f, 0xf0, 0x16, 0x0f, 0xfc, 0x1b,
+        0xa7, 0xfe, 0x54, 0xbf, 0xf5, 0x50, 0xfc, 0x9e, 0x7e, 0x87, 0xef, 0x7a,
+        0x03, 0xf8, 0x6b, 0x3b, 0x3c, 0x5a, 0xa8, 0x9c, 0xc7, 0xbe, 0x4e, 0xdf,
+        0xa7, 0x94, 0x9a, 0xb0, 0x57, 0xd4, 0x2e, 0x0f, 0x69, 0xd3, 0xa5, 0x04,
+        0xb3, 0x4c, 0xaf, 0x04, 0xea, 0x9a, 0x39, 0xae, 0xb8, 0x0a, 0xd0, 0xbf,
+        0xda, 0x35, 0xbc, 0x9f, 0xb6, 0xf4, 0xc3, 0xaa, 0x82, 0x52, 0x85, 0xd3,
+        0xf0, 0xb7, 0x55, 0xb6, 0x97, 0xd1, 0x34, 0x46, 0xe8, 0x3f, 0x1a, 0x90,
+        0xa5, 0xe5, 0xed, 0xb0, 0xfe, 0x2c, 0xfc, 0x83, 0xf6, 0x71, 0xf1, 0x39,
+        0x4f, 0x1e, 0xf3, 0xbe, 0x0e, 0x47, 0x21, 0x8b, 0x88, 0x4f, 0x14, 0x7d,
+        0x34, 0x57, 0x9c, 0xd4, 0x70, 0xc2, 0x05, 0xe9, 0x9f, 0xb9, 0x7d, 0xae,
+        0x55, 0x0f, 0x6a, 0xb4, 0xcb, 0xc1, 0x33, 0x85, 0xbe, 0x4e, 0xda, 0xa3,
+        0x54, 0x97, 0xb9, 0x2f, 0xeb, 0xdb, 0x48, 0x52, 0x72, 0x6f, 0x7a, 0xda,
+        0xda, 0x64, 0x9a, 0xd9, 0xc6, 0x85, 0x58, 0x98, 0xa1, 0x5c, 0xf1, 0xcd,
+        0xef, 0x7a, 0x4f, 0x0b, 0xf1, 0xef, 0x5c, 0xe6, 0x9e, 0x27, 0xd7, 0x76,
+        0x17, 0x81, 0x07, 0x20, 0x9c, 0xcb, 0x2f, 0x37, 0xaf, 0x3b, 0xfb, 0xc0,
+        0x3c, 0xf0, 0x24, 0x1a, 0x88, 0x82, 0xdc, 0x4b, 0xac, 0x73, 0x74, 0xcf,
+        0x27, 0x75, 0xae, 0xcc, 0x24, 0xb9, 0x74, 0xed, 0xcf, 0x95, 0x1d, 0x83,
+        0x35, 0x0c, 0x69, 0x7a, 0x77, 0x5e, 0xc2, 0x2b, 0x9a, 0xb1, 0xe0, 0x61,
+        0xe4, 0x84, 0xaa, 0xac, 0xa3, 0x8e, 0x3b, 0xcc, 0x76, 0x72, 0x31, 0x46,
+        0x36, 0x33, 0xa2, 0x23, 0x35, 0xdb, 0x9c, 0xa9, 0x36, 0x62, 0x6e, 0x09,
+        0x9b, 0x33, 0x95, 0x84, 0xa1, 0xe5, 0xc7, 0x14, 0x9a, 0xe2, 0x7e, 0xa9,
+        0x4c, 0xac, 0x60, 0x1c, 0xce, 0xe6, 0xc0, 0x2f, 0x7f, 0x77, 0x16, 0xfd,
+        0x9e, 0xb6, 0x41, 0x81, 0x9f, 0x85, 0x48, 0x27, 0x07, 0x57, 0xaf, 0x00,
+        0xe7, 0x0b, 0x2d, 0x16, 0xb9, 0xb2, 0x16, 0xe5, 0xf8, 0x1f, 0xbe, 0x3d,
+        0x9e, 0x43, 0x72, 0xd1, 0xa7, 0x9b, 0xcd, 0xba, 0x78, 0xe8, 0x4a, 0x36,
+        0x51, 0xe2, 0xb9, 0xe4, 0x81, 0xb4, 0x41, 0xfa, 0x45, 0xed, 0xb3, 0xae,
+        0x04, 0xdf, 0x94, 0x7f, 0xbe, 0x65, 0x87, 0x2d, 0x97, 0xe4, 0xde, 0x50,
+        0x70, 0x4f, 0x7c, 0xa9, 0xc1, 0xea, 0x3c, 0x2f, 0x31, 0x52, 0x43, 0xc4,
+        0x71, 0x82, 0x97, 0x93, 0x05, 0x07, 0x23, 0xa1, 0x78, 0x40, 0x36, 0x44,
+        0xbd, 0x7d, 0x66, 0x1f, 0x6f, 0x41, 0x81, 0x6e, 0xc9, 0x08, 0x01, 0xc7,
+        0x85, 0x75, 0x2f, 0xd6, 0x70, 0xe8, 0xf2, 0x34, 0x81, 0x1a, 0xca, 0xd3,
+        0xf3, 0x1c, 0xab, 0xa2, 0x4e, 0xfd, 0xce, 0x2f, 0x35, 0xa3, 0x88, 0xd6,
+        0xc3, 0xfa, 0x61, 0x62, 0x19, 0x85, 0x54, 0x9d, 0xf0, 0x32, 0x0a, 0xb4,
+        0x2a, 0x4e, 0xdb, 0xa4, 0x72, 0x6f, 0x62, 0x56, 0x88, 0x26, 0x70, 0x93,
+        0x3c, 0x70, 0x61, 0x6b, 0x74, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x1a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x9a, 0x00,
+    };
+
+    struct File {
+        const char    *name;
+        const uint8_t *data;
+        size_t         size;
+        uint64_t       pcm_hash;
+    };
+    const File files[] = {
+        { "alac16", alac16, sizeof alac16, 0xc4b29377470d8272ULL },
+        { "alac24", alac24, sizeof alac24, 0xc46ad805eb3406c8ULL },
+    };
+}
+
+#endif
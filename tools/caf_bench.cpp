@@ -0,0 +1,641 @@
+/*
+ * caf-bench: decode CAF files to a null sink and report throughput.
+ *
+ *   caf-bench [-j threads] [-n repeat] [-v] [--trace out.json] [--downmix]
+ *             [--channels LIST] [--pull f32|s16|s24|s32 [--planar]]
+ *             file.caf...
+ *   caf-bench --pull-check file.caf...
+ *   caf-bench --check-alloc [--downmix] [--channels LIST] file.caf...
+ *   caf-bench --latency [--depth N] [--speed X] file.caf...
+ *
+ * -v dumps the demuxer's performance counters after each file,
+ * --trace writes Chrome trace events for the whole run, --downmix decodes
+ * multichannel PCM straight to stereo, --channels decodes only the listed
+ * PCM channels (e.g. 1-4,7 or FL,FR). --pull decodes through FrameReader
+ * into a caller buffer of PULL_FRAMES frames in the given sample format,
+ * interleaved or --planar.
+ *
+ * --pull-check compares FrameReader output, in every sample format and
+ * layout, read in spans of random length (and at random positions when
+ * packets are independent), with the audio_chunk output converted.
+ * Only codecs decoded natively by the core library are supported.
+ *
+ * --check-alloc counts heap allocations while decoding the way input_caf
+ * does (chunk by chunk, with seeks and preroll) and through FrameReader
+ * at random positions, after a warm-up pass of each, and fails unless
+ * there are none.
+ *
+ * --latency times every chunk handed to a consumer that plays at X times
+ * realtime (8 by default, 0 = as fast as it can), decoding on the
+ * consumer's thread as input_caf's decode_run() does by default, then
+ * through DecodeAhead N chunks ahead (8 by default), and prints the
+ * median, 99th percentile and worst case of each.
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "CAFFile.h"
+#include "DecodeAhead.h"
+#include "Decoder.h"
+#include "FrameReader.h"
+#include "ParallelDecoder.h"
+#include "Trace.h"
+
+namespace {
+    std::atomic<uint64_t> g_alloc_count(0);
+}
+
+void *operator new(size_t size)
+{
+    g_alloc_count.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace {
+    typedef std::chrono::steady_clock clock_type;
+
+    double seconds_since(clock_type::time_point start)
+    {
+        return std::chrono::duration<double>(clock_type::now() - start)
+                .count();
+    }
+
+    std::string fourcc_string(uint32_t fcc)
+    {
+        std::string s;
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            int c = (fcc >> shift) & 0xff;
+            if (c >= 0x20 && c < 0x7f)
+                s.push_back(c);
+            else {
+                char buf[8];
+                std::sprintf(buf, "\\x%02x", c);
+                s += buf;
+            }
+        }
+        return s;
+    }
+
+    struct Stats {
+        double   open_time;
+        double   read_time;
+        double   decode_time;
+        uint64_t bytes_in;
+        uint64_t frames_out;
+        double   checksum; /* keeps the sink from being optimized away */
+        Stats(): open_time(0), read_time(0), decode_time(0),
+                 bytes_in(0), frames_out(0), checksum(0) {}
+    };
+
+    void null_sink(const audio_chunk &chunk, Stats *stats,
+                   PerfCounters *counters)
+    {
+        const audio_sample *p = chunk.get_data();
+        size_t n = chunk.get_sample_count() * chunk.get_channels();
+        if (n)
+            stats->checksum += p[0] + p[n - 1];
+        stats->frames_out += chunk.get_sample_count();
+        counters->peak(PerfCounters::PEAK_CHUNK_SAMPLES, n);
+    }
+
+    const size_t PULL_FRAMES = 4096;
+
+    size_t sample_size(IDecoder::SampleFormat format)
+    {
+        return format == IDecoder::INT16 ? 2 : 4;
+    }
+
+    /* caller buffers of frames frames, interleaved or a plane a channel */
+    struct PullBuffer {
+        std::vector<uint8_t> storage;
+        std::vector<void *>  planes;
+        IDecoder::Output     out;
+
+        PullBuffer(IDecoder::SampleFormat format, bool planar,
+                   unsigned channels, size_t frames)
+            : storage(channels * frames * sample_size(format))
+        {
+            size_t plane = frames * sample_size(format);
+            for (unsigned ch = 0; ch < (planar ? channels : 1); ++ch)
+                planes.push_back(storage.data() + ch * plane);
+            out.format = format;
+            out.planar = planar;
+            out.data   = planes.data();
+        }
+    };
+
+    void bench_pull(const std::shared_ptr<CAFFile> &demuxer,
+                    IDecoder::SampleFormat format, bool planar,
+                    Stats *stats)
+    {
+        abort_callback_dummy abort;
+        FrameReader reader(demuxer, abort);
+        PullBuffer  buffer(format, planar, reader.channels(), PULL_FRAMES);
+
+        auto start = clock_type::now();
+        size_t n;
+        for (int64_t pos = 0;
+             (n = reader.read(pos, PULL_FRAMES, buffer.out, abort)) > 0;
+             pos += n) {
+            stats->frames_out += n;
+            stats->checksum   += buffer.storage[0];
+        }
+        stats->decode_time += seconds_since(start);
+        stats->bytes_in    +=
+            demuxer->counters().get(PerfCounters::BYTES_READ);
+    }
+
+    void bench_file(const char *path, unsigned nthreads,
+                    const IDecoder::Options &options, int pull_format,
+                    bool planar, Stats *stats, std::string *codec,
+                    double *duration, std::string *counters)
+    {
+        abort_callback_dummy abort;
+        audio_chunk_impl     chunk;
+        std::vector<uint8_t> buffer;
+
+        auto start = clock_type::now();
+        std::shared_ptr<IByteSource> file =
+            std::make_shared<FileByteSource>(path);
+        auto demuxer = std::make_shared<CAFFile>(file, abort);
+        auto decoder = IDecoder::create_decoder(demuxer, abort, options);
+        stats->open_time += seconds_since(start);
+
+        auto asbd = demuxer->format().asbd;
+        *codec    = fourcc_string(asbd.mFormatID);
+        *duration = demuxer->duration() / asbd.mSampleRate;
+
+        /* same chunking as input_caf */
+        uint32_t packets_per_chunk = 1;
+        if (asbd.mBytesPerPacket > 0) {
+            while (packets_per_chunk * asbd.mBytesPerPacket < 4096)
+                packets_per_chunk <<= 1;
+        }
+        int64_t num_packets = demuxer->num_packets();
+        PerfCounters *pc = &demuxer->counters();
+
+        if (pull_format >= 0) {
+            bench_pull(demuxer, IDecoder::SampleFormat(pull_format), planar,
+                       stats);
+            *counters = pc->report();
+            return;
+        }
+
+        if (nthreads > 1) {
+            uint32_t packets_per_job = packets_per_chunk;
+            if (asbd.mBytesPerPacket > 0) {
+                while (packets_per_job * asbd.mBytesPerPacket < 65536)
+                    packets_per_job <<= 1;
+            }
+            start = clock_type::now();
+            ParallelDecoder pd(demuxer, packets_per_job, nthreads, abort,
+                               options);
+            pd.reset(0);
+            uint32_t n;
+            while ((n = pd.decode(chunk, abort)) > 0) {
+                pc->add(PerfCounters::PACKETS_DECODED, n);
+                null_sink(chunk, stats, pc);
+            }
+            stats->decode_time += seconds_since(start);
+            stats->bytes_in += pc->get(PerfCounters::BYTES_READ);
+            *counters = pc->report();
+            return;
+        }
+        for (int64_t packet = 0; packet < num_packets; ) {
+            start = clock_type::now();
+            uint32_t n = demuxer->read_packets(packet, packets_per_chunk,
+                                               &buffer, abort);
+            stats->read_time += seconds_since(start);
+            if (!n)
+                break;
+            packet += n;
+            stats->bytes_in += buffer.size();
+
+            start = clock_type::now();
+            {
+                TraceSpan span("decode");
+                PerfTimer timer(pc, PerfCounters::DECODE_NS);
+                decoder->decode(buffer.data(), buffer.size(), chunk, abort);
+            }
+            stats->decode_time += seconds_since(start);
+            pc->add(PerfCounters::PACKETS_DECODED, n);
+            null_sink(chunk, stats, pc);
+        }
+        *counters = pc->report();
+    }
+
+    /*
+     * Compares FrameReader output with the decoder's chunks converted by
+     * IDecoder::store_samples(); 32 bit integer output of integer sources
+     * is exact where the chunks are not, so it may differ by the float
+     * rounding. Prints a line per file and returns whether it matched.
+     */
+    bool pull_check(const char *path)
+    {
+        abort_callback_dummy abort;
+        auto demuxer = std::make_shared<CAFFile>(
+                std::make_shared<FileByteSource>(path), abort);
+        unsigned channels = demuxer->format().asbd.mChannelsPerFrame;
+        int64_t  length   = demuxer->duration();
+        std::vector<audio_sample> decoded;
+        IDecoder::decode_all(demuxer, abort,
+                             [&decoded](const audio_chunk &c) {
+            const audio_sample *p = c.get_data();
+            decoded.insert(decoded.end(), p,
+                           p + c.get_sample_count() * c.get_channels());
+        });
+        int64_t skip = demuxer->start_offset();
+        int64_t have = decoded.size() / channels - skip;
+        /* encoders are not always exact about the last packet */
+        length = std::min(length, have);
+        bool random_access = IDecoder::is_intra_only_format(
+                                demuxer->format().asbd.mFormatID);
+
+        std::mt19937 rng(12345);
+        std::string failures;
+        for (int f = IDecoder::FLOAT32; f <= IDecoder::INT32; ++f) {
+            for (int planar = 0; planar < 2; ++planar) {
+                auto format = IDecoder::SampleFormat(f);
+                PullBuffer expected(format, planar, channels, length);
+                PullBuffer actual  (format, planar, channels, length);
+                IDecoder::store_samples(decoded.data() + skip * channels,
+                                        length, channels, expected.out);
+                FrameReader reader(demuxer, abort);
+                size_t n;
+                for (int64_t pos = 0; pos < length; pos += n) {
+                    actual.out.offset = pos;
+                    n = reader.read(pos, 1 + rng() % 5000, actual.out,
+                                    abort);
+                    if (!n)
+                        break;
+                }
+                for (int k = 0; random_access && k < 50; ++k) {
+                    int64_t pos = rng() % length;
+                    actual.out.offset = pos;
+                    reader.read(pos, std::min<int64_t>(1 + rng() % 3000,
+                                                       length - pos),
+                                actual.out, abort);
+                }
+                size_t mismatches = 0;
+                size_t size = sample_size(format);
+                for (size_t i = 0; i < expected.storage.size(); i += size) {
+                    int64_t a, b;
+                    if (size == 2) {
+                        int16_t x, y;
+                        std::memcpy(&x, &expected.storage[i], 2);
+                        std::memcpy(&y, &actual.storage[i], 2);
+                        a = x, b = y;
+                    } else {
+                        /* floats compared bit for bit */
+                        int32_t x, y;
+                        std::memcpy(&x, &expected.storage[i], 4);
+                        std::memcpy(&y, &actual.storage[i], 4);
+                        a = x, b = y;
+                    }
+                    if (format == IDecoder::INT32 && std::llabs(a - b) <= 128)
+                        b = a;
+                    mismatches += a != b;
+                }
+                if (mismatches) {
+                    static const char *names[] = { "f32", "s16", "s24",
+                                                   "s32" };
+                    char msg[64];
+                    std::snprintf(msg, sizeof msg, " %s%s:%zu", names[f],
+                                  planar ? "p" : "", mismatches);
+                    failures += msg;
+                }
+            }
+        }
+        std::printf("%-32s %s%s\n", path, failures.empty() ? "ok" : "FAIL",
+                    failures.c_str());
+        return failures.empty();
+    }
+
+    /* input_caf's decoding, minus trimming: chunks of packets, and seeks */
+    class ChunkDecoder {
+        std::shared_ptr<CAFFile>  m_demuxer;
+        std::shared_ptr<IDecoder> m_decoder;
+        uint32_t                  m_packets_per_chunk;
+        int64_t                   m_packet;
+        std::vector<uint8_t>      m_buffer;
+        audio_chunk_impl          m_chunk;
+        audio_chunk_impl          m_preroll_chunk;
+    public:
+        ChunkDecoder(std::shared_ptr<CAFFile> &demuxer,
+                     const IDecoder::Options &options, abort_callback &abort)
+            : m_demuxer(demuxer), m_packets_per_chunk(1), m_packet(0)
+        {
+            m_decoder = IDecoder::create_decoder(demuxer, abort, options);
+            auto asbd = demuxer->format().asbd;
+            if (asbd.mBytesPerPacket > 0) {
+                while (m_packets_per_chunk * asbd.mBytesPerPacket < 4096)
+                    m_packets_per_chunk <<= 1;
+            }
+            size_t bytes = static_cast<size_t>(demuxer->max_packet_size())
+                         * m_packets_per_chunk;
+            m_buffer.reserve(bytes);
+            m_decoder->reserve(bytes);
+        }
+        bool decode(abort_callback &abort)
+        {
+            return decode(m_chunk, abort);
+        }
+        bool decode(audio_chunk &chunk, abort_callback &abort)
+        {
+            uint32_t n = m_demuxer->read_packets(m_packet, m_packets_per_chunk,
+                                                 &m_buffer, abort);
+            if (!n)
+                return false;
+            m_packet += n;
+            m_decoder->decode(m_buffer.data(), m_buffer.size(), chunk,
+                              abort);
+            return true;
+        }
+        void seek(int64_t packet, abort_callback &abort)
+        {
+            uint32_t preroll = m_decoder->get_max_frame_dependency();
+            m_decoder->reset_after_seek();
+            for (int64_t p = std::max<int64_t>(packet - preroll, 0);
+                 p < packet; ++p) {
+                m_demuxer->read_packets(p, 1, &m_buffer, abort);
+                m_decoder->decode(m_buffer.data(), m_buffer.size(),
+                                  m_preroll_chunk, abort);
+            }
+            m_packet = packet;
+        }
+    };
+
+    /*
+     * Prints the allocations counted after warm-up and returns whether
+     * there were none.
+     */
+    bool check_alloc(const char *path, const IDecoder::Options &options)
+    {
+        enum { SEEKS = 200, CHUNKS_PER_SEEK = 4, READS = 200 };
+        abort_callback_dummy abort;
+        auto demuxer = std::make_shared<CAFFile>(
+                std::make_shared<FileByteSource>(path), abort);
+        ChunkDecoder decoder(demuxer, options, abort);
+        FrameReader  reader(demuxer, abort);
+        PullBuffer   buffer(IDecoder::FLOAT32, false, reader.channels(),
+                            PULL_FRAMES);
+        int64_t num_packets = demuxer->num_packets();
+        int64_t length      = reader.length();
+        std::mt19937 rng(12345);
+
+        uint64_t allocs[2];
+        for (int pass = 0; pass < 2; ++pass) {
+            uint64_t start = g_alloc_count.load();
+            decoder.seek(0, abort);
+            while (decoder.decode(abort))
+                ;
+            for (int k = 0; k < SEEKS; ++k) {
+                /* the start now and then, where preroll is special */
+                decoder.seek(k % 10 ? rng() % num_packets : 0, abort);
+                for (int c = 0; c < CHUNKS_PER_SEEK; ++c)
+                    decoder.decode(abort);
+            }
+            for (int64_t pos = 0; pos < length; pos += PULL_FRAMES)
+                if (!reader.read(pos, PULL_FRAMES, buffer.out, abort))
+                    break;
+            for (int k = 0; k < READS; ++k)
+                reader.read(rng() % length, 1 + rng() % PULL_FRAMES,
+                            buffer.out, abort);
+            allocs[pass] = g_alloc_count.load() - start;
+        }
+        std::printf("%-32s %s (%llu in warm-up, %llu after)\n", path,
+                    allocs[1] ? "FAIL" : "ok",
+                    static_cast<unsigned long long>(allocs[0]),
+                    static_cast<unsigned long long>(allocs[1]));
+        return !allocs[1];
+    }
+
+    /*
+     * Times each chunk handed to a consumer playing at speed times
+     * realtime, with the chunks decoded inline or depth chunks ahead.
+     * Returns the times in seconds, sorted.
+     */
+    std::vector<double> chunk_latencies(const char *path,
+                                        const IDecoder::Options &options,
+                                        unsigned depth, double speed)
+    {
+        abort_callback_dummy abort;
+        auto demuxer = std::make_shared<CAFFile>(
+                std::make_shared<FileByteSource>(path), abort);
+        ChunkDecoder decoder(demuxer, options, abort);
+        std::shared_ptr<DecodeAhead> ahead;
+        if (depth) {
+            auto producer = [&decoder](DecodeAhead::Slot *slot,
+                                       abort_callback &abort) -> bool {
+                return decoder.decode(slot->chunk, abort);
+            };
+            ahead = std::make_shared<DecodeAhead>(producer, depth);
+            ahead->start();
+        }
+        audio_chunk_impl    chunk;
+        std::vector<double> latencies;
+        auto deadline = clock_type::now();
+        for (;;) {
+            auto start = clock_type::now();
+            int64_t pre_packet, cur_packet;
+            bool more = ahead ? ahead->pop(chunk, &pre_packet, &cur_packet,
+                                           abort)
+                              : decoder.decode(chunk, abort);
+            latencies.push_back(seconds_since(start));
+            if (!more)
+                break;
+            if (speed > 0) {
+                /* the output device draining what it was given */
+                double seconds = chunk.get_sample_count()
+                               / (chunk.get_srate() * speed);
+                deadline += std::chrono::duration_cast<clock_type::duration>(
+                                std::chrono::duration<double>(seconds));
+                std::this_thread::sleep_until(deadline);
+            }
+        }
+        std::sort(latencies.begin(), latencies.end());
+        return latencies;
+    }
+
+    void print_latencies(const char *path, const char *mode,
+                         const std::vector<double> &v)
+    {
+        std::string name = path;
+        if (name.size() > 32)
+            name = "..." + name.substr(name.size() - 29);
+        std::printf("%-32s %-8s %9zu %9.1f %9.1f %9.1f\n", name.c_str(),
+                    mode, v.size(), v[v.size() / 2] * 1e6,
+                    v[std::min(v.size() - 1, v.size() * 99 / 100)] * 1e6,
+                    v.back() * 1e6);
+    }
+
+    bool parse_sample_format(const char *name, int *format)
+    {
+        static const char *names[] = { "f32", "s16", "s24", "s32" };
+        for (int i = 0; i < 4; ++i)
+            if (!std::strcmp(name, names[i]))
+                *format = i;
+        return *format >= 0;
+    }
+
+    void usage()
+    {
+        std::fprintf(stderr,
+                     "usage: caf-bench [-j threads] [-n repeat] [-v] "
+                     "[--trace out.json] [--downmix] [--channels LIST] "
+                     "[--pull f32|s16|s24|s32 [--planar]] FILE...\n"
+                     "       caf-bench --pull-check FILE...\n"
+                     "       caf-bench --check-alloc [--downmix] "
+                     "[--channels LIST] FILE...\n"
+                     "       caf-bench --latency [--depth N] [--speed X] "
+                     "FILE...\n");
+        std::exit(1);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    unsigned nthreads = 1, repeat = 1;
+    bool verbose = false, planar = false, check = false;
+    bool check_allocs = false, latency = false;
+    unsigned depth = 8;
+    double speed = 8;
+    int pull_format = -1;
+    const char *trace_file = 0;
+    IDecoder::Options options;
+    int i;
+    for (i = 1; i < argc && argv[i][0] == '-'; ++i) {
+        if (!std::strcmp(argv[i], "-j") && i + 1 < argc)
+            nthreads = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "-n") && i + 1 < argc)
+            repeat = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "-v"))
+            verbose = true;
+        else if (!std::strcmp(argv[i], "--trace") && i + 1 < argc)
+            trace_file = argv[++i];
+        else if (!std::strcmp(argv[i], "--downmix"))
+            options.stereo_downmix = true;
+        else if (!std::strcmp(argv[i], "--channels") && i + 1 < argc)
+            options.channels = argv[++i];
+        else if (!std::strcmp(argv[i], "--pull") && i + 1 < argc) {
+            if (!parse_sample_format(argv[++i], &pull_format))
+                usage();
+        } else if (!std::strcmp(argv[i], "--planar"))
+            planar = true;
+        else if (!std::strcmp(argv[i], "--pull-check"))
+            check = true;
+        else if (!std::strcmp(argv[i], "--check-alloc"))
+            check_allocs = true;
+        else if (!std::strcmp(argv[i], "--latency"))
+            latency = true;
+        else if (!std::strcmp(argv[i], "--depth") && i + 1 < argc)
+            depth = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--speed") && i + 1 < argc)
+            speed = std::atof(argv[++i]);
+        else
+            usage();
+    }
+    if (i == argc || nthreads < 1 || repeat < 1 || depth < 1 || speed < 0)
+        usage();
+    if (latency) {
+        std::printf("%-32s %-8s %9s %9s %9s %9s\n", "file", "mode",
+                    "chunks", "p50 us", "p99 us", "max us");
+        int status = 0;
+        for (; i < argc; ++i) {
+            try {
+                print_latencies(argv[i], "inline",
+                                chunk_latencies(argv[i], options, 0, speed));
+                print_latencies(argv[i], "ahead",
+                                chunk_latencies(argv[i], options, depth,
+                                                speed));
+            } catch (std::exception &e) {
+                std::fprintf(stderr, "%s: %s\n", argv[i], e.what());
+                status = 2;
+            }
+        }
+        return status;
+    }
+    if (check || check_allocs) {
+        int status = 0;
+        for (; i < argc; ++i) {
+            try {
+                bool ok = check ? pull_check(argv[i])
+                                : check_alloc(argv[i], options);
+                if (!ok)
+                    status = std::max(status, 1);
+            } catch (std::exception &e) {
+                std::fprintf(stderr, "%s: %s\n", argv[i], e.what());
+                status = 2;
+            }
+        }
+        return status;
+    }
+    Trace::set_enabled(trace_file != 0);
+
+    std::printf("%-32s %-8s %9s %9s %9s %9s %9s %9s\n",
+                "file", "codec", "MB/s", "x realtime",
+                "open ms", "read ms", "decode ms", "frames");
+    int status = 0;
+    for (; i < argc; ++i) {
+        try {
+            Stats stats;
+            std::string codec, counters;
+            double duration = 0;
+            for (unsigned n = 0; n < repeat; ++n)
+                bench_file(argv[i], nthreads, options, pull_format, planar,
+                           &stats, &codec, &duration, &counters);
+            double total = stats.open_time + stats.read_time
+                         + stats.decode_time;
+            std::string name = argv[i];
+            if (name.size() > 32)
+                name = "..." + name.substr(name.size() - 29);
+            std::printf("%-32s %-8s %9.1f %9.1f %9.3f %9.3f %9.3f %9llu\n",
+                        name.c_str(), codec.c_str(),
+                        stats.bytes_in / total / 1e6,
+                        duration * repeat / total,
+                        stats.open_time   * 1e3 / repeat,
+                        stats.read_time   * 1e3 / repeat,
+                        stats.decode_time * 1e3 / repeat,
+                        static_cast<unsigned long long>(stats.frames_out
+                                                        / repeat));
+            if (verbose)
+                std::printf("%s", counters.c_str());
+        } catch (std::exception &e) {
+            std::fprintf(stderr, "%s: %s\n", argv[i], e.what());
+            status = 2;
+        }
+    }
+    if (trace_file) {
+        std::string json = Trace::to_json();
+        FILE *fp = std::fopen(trace_file, "wb");
+        if (!fp || std::fwrite(json.data(), 1, json.size(), fp)
+                        != json.size()) {
+            std::fprintf(stderr, "%s: cannot write trace\n", trace_file);
+            status = 2;
+        }
+        if (fp)
+            std::fclose(fp);
+    }
+    return status;
+}
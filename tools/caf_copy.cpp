@@ -0,0 +1,185 @@
+/*
+ * caf-copy: rewrite a CAF file through CAFWriter.
+ *
+ *   caf-copy [--crash-safe] [--flush-interval BYTES] [--reserve BYTES]
+ *            [--interrupt-at BYTES] [--bench] in.caf out.caf
+ *
+ * Copies format, channel layout, magic cookie, info and packets (with
+ * the pakt header as is). --interrupt-at stops after that many bytes of
+ * data without finalizing, to see what a crash leaves behind.
+ *
+ * --bench reads the packets into memory first, then times plain 1 MiB
+ * writes of the same bytes to out against the CAFWriter copy (both
+ * synced at the end) and prints the throughput of each.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "CAFFile.h"
+#include "CAFWriter.h"
+
+namespace {
+    typedef std::chrono::steady_clock clock_type;
+
+    double seconds_since(clock_type::time_point start)
+    {
+        return std::chrono::duration<double>(clock_type::now() - start)
+                .count();
+    }
+
+    /* packets read in batches of about this many bytes */
+    const uint32_t BATCH_BYTES = 1 << 20;
+
+    struct Batch {
+        std::vector<uint8_t>  data;
+        std::vector<uint32_t> sizes;
+    };
+
+    bool read_batch(CAFFile *demuxer, int64_t *packet, Batch *batch,
+                    abort_callback &abort)
+    {
+        uint32_t bpp = demuxer->primary_format().asbd.mBytesPerPacket;
+        int64_t  num_packets = demuxer->num_packets();
+        uint32_t n = 0, bytes = 0, size;
+        batch->sizes.clear();
+        if (bpp) {
+            n = std::min<int64_t>(std::max(BATCH_BYTES / bpp, 1u),
+                                  num_packets - *packet);
+        } else {
+            for (; bytes < BATCH_BYTES && *packet + n < num_packets; ++n) {
+                demuxer->packet_info(*packet + n, &size);
+                batch->sizes.push_back(size);
+                bytes += size;
+            }
+        }
+        if (!n)
+            return false;
+        if (demuxer->read_packets(*packet, n, &batch->data, abort) != n)
+            throw std::runtime_error("unexpected end of file");
+        *packet += n;
+        return true;
+    }
+
+    /* returns false when interrupted */
+    bool copy(CAFWriter *writer, const Batch &batch, uint32_t bpp,
+              uint64_t interrupt_at, abort_callback &abort)
+    {
+        uint64_t limit = interrupt_at - writer->data_size();
+        if (bpp) {
+            uint64_t n = std::min<uint64_t>(batch.data.size() / bpp,
+                                            limit / bpp + 1);
+            writer->write(batch.data.data(), n * bpp, abort);
+        } else {
+            size_t   n     = 0;
+            uint64_t bytes = 0;
+            for (; n < batch.sizes.size() && bytes < limit; ++n)
+                bytes += batch.sizes[n];
+            writer->write_packets(batch.data.data(), batch.sizes.data(), n,
+                                  abort);
+        }
+        return writer->data_size() < interrupt_at;
+    }
+
+    void usage()
+    {
+        std::fprintf(stderr, "usage: caf-copy [--crash-safe] "
+                             "[--flush-interval BYTES] [--reserve BYTES] "
+                             "[--interrupt-at BYTES] [--bench] "
+                             "IN.caf OUT.caf\n");
+        std::exit(1);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    CAFWriter::Options options;
+    uint64_t interrupt_at = ~0ULL;
+    bool bench = false;
+    int i;
+    for (i = 1; i < argc && argv[i][0] == '-'; ++i) {
+        if (!std::strcmp(argv[i], "--crash-safe"))
+            options.crash_safe = true;
+        else if (!std::strcmp(argv[i], "--flush-interval") && i + 1 < argc)
+            options.flush_interval = std::strtoull(argv[++i], 0, 10);
+        else if (!std::strcmp(argv[i], "--reserve") && i + 1 < argc)
+            options.reserve = std::strtoul(argv[++i], 0, 10);
+        else if (!std::strcmp(argv[i], "--interrupt-at") && i + 1 < argc)
+            interrupt_at = std::strtoull(argv[++i], 0, 10);
+        else if (!std::strcmp(argv[i], "--bench"))
+            bench = true;
+        else
+            usage();
+    }
+    if (argc - i != 2)
+        usage();
+    const char *src = argv[i], *dst = argv[i + 1];
+
+    try {
+        abort_callback_dummy abort;
+        CAFFile demuxer(std::make_shared<FileByteSource>(src), abort);
+        const CAFFile::Format &format = demuxer.primary_format();
+        if (!format.asbd.mFramesPerPacket)
+            throw std::runtime_error("variable frames per packet are not "
+                                     "supported");
+        /*
+         * Without --bench, one batch at a time is kept in memory.
+         */
+        std::vector<Batch> batches(1);
+        int64_t packet = 0;
+        double  raw_time = 0;
+        if (bench) {
+            Batch b;
+            while (read_batch(&demuxer, &packet, &b, abort))
+                batches.push_back(b);
+            batches.erase(batches.begin());
+
+            std::remove(dst);
+            FileByteSource out(dst, "wb");
+            auto start = clock_type::now();
+            for (size_t k = 0; k < batches.size(); ++k)
+                out.write(batches[k].data.data(), batches[k].data.size(),
+                          abort);
+            out.sync();
+            raw_time = seconds_since(start);
+        }
+        /* a new file rather than freeing the blocks of the old one */
+        std::remove(dst);
+        auto file = std::make_shared<FileByteSource>(dst, "w+b");
+        auto start = clock_type::now();
+        CAFWriter writer(file, format, demuxer.magic_cookie(),
+                         demuxer.tags(), abort, options);
+        uint32_t bpp = format.asbd.mBytesPerPacket;
+        bool complete = true;
+        if (bench) {
+            for (size_t k = 0; complete && k < batches.size(); ++k)
+                complete = copy(&writer, batches[k], bpp, interrupt_at,
+                                abort);
+        } else {
+            while (complete
+                && read_batch(&demuxer, &packet, &batches[0], abort))
+                complete = copy(&writer, batches[0], bpp, interrupt_at,
+                                abort);
+        }
+        if (!complete)
+            return 0;
+        writer.finalize(demuxer.packet_table_info(), abort);
+        file->sync();
+        double elapsed = seconds_since(start);
+
+        if (bench) {
+            double mb = writer.data_size() / 1e6;
+            std::printf("%-10s %9.1f MB/s\n", "raw", mb / raw_time);
+            std::printf("%-10s %9.1f MB/s (%.0f%%)\n", "CAFWriter",
+                        mb / elapsed, 100 * raw_time / elapsed);
+        }
+    } catch (std::exception &e) {
+        std::fprintf(stderr, "%s: %s\n", src, e.what());
+        return 2;
+    }
+    return 0;
+}
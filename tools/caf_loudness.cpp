@@ -0,0 +1,136 @@
+/*
+ * caf-loudness: EBU R128 integrated loudness and ReplayGain of CAF files.
+ *
+ *   caf-loudness [-j threads] [--write] [--bench] file.caf...
+ *
+ * Prints integrated loudness, ReplayGain 2.0 track gain and sample peak.
+ * --write stores gain and peak in the tags (one retag per file).
+ * --bench also times the plain way of doing it, decoding the whole file
+ * first and analysing it afterwards on one thread, and reports both as
+ * hours of audio scanned per second.
+ */
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "CAFFile.h"
+#include "Loudness.h"
+#include "PeakScanner.h"
+
+namespace {
+    typedef std::chrono::steady_clock clock_type;
+
+    double seconds_since(clock_type::time_point start)
+    {
+        return std::chrono::duration<double>(clock_type::now() - start)
+                .count();
+    }
+
+    /* decode everything into memory, then measure it */
+    void scan_two_pass(std::shared_ptr<CAFFile> &demuxer,
+                       LoudnessScanner::Result *result,
+                       abort_callback &abort)
+    {
+        const CAFFile::Format &format = demuxer->format();
+        unsigned channels = format.asbd.mChannelsPerFrame;
+        std::vector<audio_sample> pcm;
+        IDecoder::decode_all(demuxer, abort, [&pcm](const audio_chunk &c) {
+            const audio_sample *p = c.get_data();
+            pcm.insert(pcm.end(), p,
+                       p + c.get_sample_count() * c.get_channels());
+        });
+        int64_t begin = demuxer->start_offset();
+        int64_t count = std::min<int64_t>(demuxer->duration(),
+                                          pcm.size() / channels - begin);
+        const audio_sample *p = pcm.data() + begin * channels;
+        LoudnessMeter meter(format.asbd.mSampleRate, channels,
+                            format.channel_mask);
+        PeakScanner peaks(format);
+        meter.add(p, count);
+        peaks.add(p, count);
+        result->loudness =
+            LoudnessMeter::integrated_loudness(meter.subblocks());
+        result->peak = 0;
+        for (size_t i = 0; i < peaks.peaks().size(); ++i)
+            result->peak = std::max(result->peak, peaks.peaks()[i].value);
+    }
+
+    void usage()
+    {
+        std::fprintf(stderr, "usage: caf-loudness [-j threads] [--write] "
+                             "[--bench] FILE...\n");
+        std::exit(1);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    unsigned nthreads = std::max(std::thread::hardware_concurrency(), 1u);
+    bool write = false, bench = false;
+    int i;
+    for (i = 1; i < argc && argv[i][0] == '-'; ++i) {
+        if (!std::strcmp(argv[i], "-j") && i + 1 < argc)
+            nthreads = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--write"))
+            write = true;
+        else if (!std::strcmp(argv[i], "--bench"))
+            bench = true;
+        else
+            usage();
+    }
+    if (i == argc || nthreads < 1)
+        usage();
+
+    std::printf("%-32s %9s %9s %9s", "file", "LUFS", "gain dB", "peak");
+    if (bench)
+        std::printf(" %9s %9s %9s", "h/s", "2pass h/s", "diff LU");
+    std::printf("\n");
+    int status = 0;
+    for (; i < argc; ++i) {
+        try {
+            abort_callback_dummy abort;
+            auto demuxer = std::make_shared<CAFFile>(
+                std::make_shared<FileByteSource>(argv[i],
+                                                 write ? "r+b" : "rb"),
+                abort);
+            double hours = demuxer->duration()
+                         / demuxer->format().asbd.mSampleRate / 3600;
+            LoudnessScanner::Result result;
+            auto start = clock_type::now();
+            LoudnessScanner::scan(demuxer, nthreads, &result, abort);
+            double elapsed = seconds_since(start);
+
+            std::string name = argv[i];
+            if (name.size() > 32)
+                name = "..." + name.substr(name.size() - 29);
+            std::printf("%-32s %9.2f %9.2f %9.6f", name.c_str(),
+                        result.loudness, result.gain(), result.peak);
+            if (bench) {
+                LoudnessScanner::Result two_pass;
+                start = clock_type::now();
+                scan_two_pass(demuxer, &two_pass, abort);
+                double elapsed2 = seconds_since(start);
+                double diff = result.loudness - two_pass.loudness;
+                if (!std::isfinite(diff))
+                    diff = 0;
+                std::printf(" %9.2f %9.2f %9.1e", hours / elapsed,
+                            hours / elapsed2, diff);
+            }
+            std::printf("\n");
+            if (write) {
+                CAFFile::tags_t tags = demuxer->tags();
+                LoudnessScanner::put_tags(result, &tags);
+                demuxer->set_tags(tags, abort);
+            }
+        } catch (std::exception &e) {
+            std::fprintf(stderr, "%s: %s\n", argv[i], e.what());
+            status = 2;
+        }
+    }
+    return status;
+}
@@ -0,0 +1,477 @@
+/*
+ * caf-microbench: open / parse latency on synthetic CAF images.
+ *
+ *   caf-microbench [-n iterations] [--full] [filter]
+ *   caf-microbench --retag-check
+ *
+ * Every case builds a CAF image in memory (the audio data itself is a
+ * hole that reads as zeros), then times opening it, the first
+ * read_packets() and a retag. For each phase the median time, the number
+ * of heap allocations and the bytes read / written through the byte
+ * source are reported. --full adds the very large cases (50M packets).
+ *
+ * --retag-check applies 100 successive, growing tag edits to one image
+ * and fails unless every edit is a single write and all but the first
+ * reuse the padded info chunk in place.
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "CAFFile.h"
+
+#if defined(__GNUC__) && !defined(__clang__)
+/* GCC takes free() in the replaced operator delete for a mismatch */
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+namespace {
+    std::atomic<uint64_t> g_alloc_count(0);
+    std::atomic<uint64_t> g_alloc_bytes(0);
+}
+
+void *operator new(size_t size)
+{
+    g_alloc_count.fetch_add(1, std::memory_order_relaxed);
+    g_alloc_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace {
+    typedef std::chrono::steady_clock clock_type;
+
+    /*
+     * Sparse in-memory file: a sorted list of byte runs, with anything in
+     * between reading as zeros. Counts the I/O that goes through it.
+     */
+    class SparseByteSource: public IByteSource {
+        struct Run {
+            t_filesize           offset;
+            std::vector<uint8_t> bytes;
+            t_filesize end() const { return offset + bytes.size(); }
+        };
+        std::vector<Run> m_runs;
+        t_filesize       m_size;
+        t_filesize       m_position;
+    public:
+        uint64_t bytes_read, read_calls, bytes_written, write_calls;
+
+        SparseByteSource(): m_size(0), m_position(0) { reset_counters(); }
+        void reset_counters()
+        {
+            bytes_read = read_calls = bytes_written = write_calls = 0;
+        }
+        void set_size(t_filesize size) { m_size = size; }
+
+        t_size read_some(void *buffer, t_size bytes, abort_callback &abort)
+        {
+            ++read_calls;
+            if (m_position >= m_size)
+                return 0;
+            t_size n = std::min<t_filesize>(bytes, m_size - m_position);
+            uint8_t *bp = static_cast<uint8_t *>(buffer);
+            std::memset(bp, 0, n);
+            t_filesize end = m_position + n;
+            for (auto it = m_runs.begin(); it != m_runs.end(); ++it) {
+                if (it->end() <= m_position || it->offset >= end)
+                    continue;
+                t_filesize lo = std::max(it->offset, m_position);
+                t_filesize hi = std::min(it->end(), end);
+                std::memcpy(bp + (lo - m_position),
+                            it->bytes.data() + (lo - it->offset), hi - lo);
+            }
+            m_position = end;
+            bytes_read += n;
+            return n;
+        }
+        void write(const void *buffer, t_size bytes, abort_callback &abort)
+        {
+            ++write_calls;
+            bytes_written += bytes;
+            auto bp = static_cast<const uint8_t *>(buffer);
+            Run *run = 0;
+            for (auto it = m_runs.begin(); it != m_runs.end(); ++it) {
+                if (it->offset <= m_position && m_position <= it->end()) {
+                    run = &*it;
+                    break;
+                }
+            }
+            if (!run) {
+                Run r;
+                r.offset = m_position;
+                auto pos = std::upper_bound(m_runs.begin(), m_runs.end(), r,
+                    [](const Run &a, const Run &b) {
+                        return a.offset < b.offset;
+                    });
+                run = &*m_runs.insert(pos, r);
+            }
+            size_t off = m_position - run->offset;
+            if (off + bytes > run->bytes.size())
+                run->bytes.resize(off + bytes);
+            std::memcpy(run->bytes.data() + off, bp, bytes);
+            m_position += bytes;
+            m_size = std::max(m_size, m_position);
+        }
+        void seek(t_filesize position, abort_callback &abort)
+        {
+            m_position = position;
+        }
+        t_filesize get_position(abort_callback &abort) { return m_position; }
+        t_filesize get_size(abort_callback &abort) { return m_size; }
+    };
+
+    /* big endian writer for the image builder */
+    struct Writer {
+        SparseByteSource    *file;
+        abort_callback_dummy abort;
+        template <typename T> void put(T value)
+        {
+            file->write_bendian_t(value, abort);
+        }
+        void put_bytes(const void *p, size_t n)
+        {
+            file->write(p, n, abort);
+        }
+        void chunk(uint32_t fcc, int64_t size)
+        {
+            put(fcc);
+            put(size);
+        }
+    };
+
+    struct Case {
+        const char *name;
+        uint32_t    npackets;
+        unsigned    ber_width;    /* 1 to 4 bytes per packet size */
+        unsigned    nfree;        /* free chunks before the data */
+        uint32_t    info_bytes;   /* approximate info chunk payload */
+        bool        pakt_after_data;
+        unsigned    junk;         /* bytes of trailing junk */
+        bool        large;
+    };
+
+    const Case cases[] = {
+        { "pakt 1k",          1000,     1, 0,     0,        false, 0, false },
+        { "pakt 100k",        100000,   1, 0,     0,        false, 0, false },
+        { "pakt 1M",          1000000,  1, 0,     0,        false, 0, false },
+        { "pakt 10M",         10000000, 1, 0,     0,        false, 0, false },
+        { "pakt 50M",         50000000, 1, 0,     0,        false, 0, true  },
+        { "ber 2 bytes",      1000000,  2, 0,     0,        false, 0, false },
+        { "ber 3 bytes",      1000000,  3, 0,     0,        false, 0, false },
+        { "ber 4 bytes",      1000000,  4, 0,     0,        false, 0, false },
+        { "free x100",        1000,     1, 100,   0,        false, 0, false },
+        { "free x10k",        1000,     1, 10000, 0,        false, 0, false },
+        { "info 64k",         1000,     1, 0,     65536,    false, 0, false },
+        { "info 16M",         1000,     1, 0,     16 << 20, false, 0, false },
+        { "pakt after data",  1000000,  1, 0,     0,        true,  0, false },
+        { "trailing junk",    1000,     1, 0,     0,        false, 7, false },
+    };
+
+    /* smallest packet size needing exactly width bytes as BER integer */
+    uint32_t packet_size_for(unsigned width)
+    {
+        return width == 1 ? 100 : 1u << (7 * (width - 1));
+    }
+
+    void put_ber(std::vector<uint8_t> *v, uint32_t n)
+    {
+        uint8_t b[5];
+        int i = 0;
+        do {
+            b[i++] = n & 0x7f;
+            n >>= 7;
+        } while (n);
+        while (i > 1)
+            v->push_back(b[--i] | 0x80);
+        v->push_back(b[0]);
+    }
+
+    std::shared_ptr<SparseByteSource> build_image(const Case &c)
+    {
+        auto file = std::make_shared<SparseByteSource>();
+        Writer w;
+        w.file = file.get();
+
+        uint32_t packet_size = packet_size_for(c.ber_width);
+        std::vector<uint8_t> pakt;
+        pakt.reserve(24 + c.npackets * c.ber_width);
+        for (unsigned i = 0; i < c.npackets; ++i)
+            put_ber(&pakt, packet_size);
+        int64_t data_size = static_cast<int64_t>(packet_size) * c.npackets;
+
+        w.put(FOURCC('c','a','f','f'));
+        w.put(static_cast<uint32_t>(0x00010000));
+        w.chunk(FOURCC('d','e','s','c'), 32);
+        w.put(44100.0);
+        w.put(FOURCC('a','a','c',' '));
+        w.put(static_cast<uint32_t>(0)); /* flags */
+        w.put(static_cast<uint32_t>(0)); /* bytes per packet */
+        w.put(static_cast<uint32_t>(1024));
+        w.put(static_cast<uint32_t>(2));
+        w.put(static_cast<uint32_t>(0));
+        w.chunk(FOURCC('c','h','a','n'), 12);
+        w.put(static_cast<uint32_t>(kAudioChannelLayoutTag_Stereo));
+        w.put(static_cast<uint32_t>(0));
+        w.put(static_cast<uint32_t>(0));
+        if (c.info_bytes) {
+            std::vector<char> info;
+            uint32_t n = 0;
+            while (info.size() < c.info_bytes) {
+                char buf[64];
+                int len = std::sprintf(buf, "key%u", n++);
+                info.insert(info.end(), buf, buf + len + 1);
+                std::string value(40, 'v');
+                info.insert(info.end(), value.begin(), value.end());
+                info.push_back(0);
+            }
+            w.chunk(FOURCC('i','n','f','o'), info.size() + 4);
+            w.put(n);
+            w.put_bytes(info.data(), info.size());
+        }
+        for (unsigned i = 0; i < c.nfree; ++i) {
+            w.chunk(FOURCC('f','r','e','e'), 16);
+            w.put_bytes("\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0", 16);
+        }
+        auto put_pakt = [&]() {
+            w.chunk(FOURCC('p','a','k','t'), 24 + pakt.size());
+            w.put(static_cast<int64_t>(c.npackets));
+            w.put(static_cast<int64_t>(c.npackets) * 1024);
+            w.put(static_cast<int32_t>(0));
+            w.put(static_cast<int32_t>(0));
+            w.put_bytes(pakt.data(), pakt.size());
+        };
+        if (!c.pakt_after_data)
+            put_pakt();
+        w.chunk(FOURCC('d','a','t','a'), data_size + 4);
+        w.put(static_cast<uint32_t>(0)); /* edit count */
+        /* the audio data is left as a hole */
+        file->set_size(file->get_size(w.abort) + data_size);
+        file->seek(file->get_size(w.abort), w.abort);
+        if (c.pakt_after_data)
+            put_pakt();
+        if (c.junk)
+            w.put_bytes("JUNKJUNKJUNK", c.junk);
+        return file;
+    }
+
+    struct Sample {
+        double   seconds;
+        uint64_t allocs;
+        uint64_t alloc_bytes;
+        uint64_t bytes_read;
+        uint64_t read_calls;
+        uint64_t bytes_written;
+        uint64_t write_calls;
+    };
+
+    class Probe {
+        SparseByteSource  *m_file;
+        clock_type::time_point m_start;
+        uint64_t           m_allocs, m_alloc_bytes;
+    public:
+        explicit Probe(SparseByteSource *file): m_file(file)
+        {
+            m_file->reset_counters();
+            m_allocs      = g_alloc_count;
+            m_alloc_bytes = g_alloc_bytes;
+            m_start       = clock_type::now();
+        }
+        Sample stop()
+        {
+            Sample s;
+            s.seconds = std::chrono::duration<double>(clock_type::now()
+                                                      - m_start).count();
+            s.allocs        = g_alloc_count - m_allocs;
+            s.alloc_bytes   = g_alloc_bytes - m_alloc_bytes;
+            s.bytes_read    = m_file->bytes_read;
+            s.read_calls    = m_file->read_calls;
+            s.bytes_written = m_file->bytes_written;
+            s.write_calls   = m_file->write_calls;
+            return s;
+        }
+    };
+
+    Sample median(std::vector<Sample> v)
+    {
+        std::sort(v.begin(), v.end(), [](const Sample &a, const Sample &b) {
+            return a.seconds < b.seconds;
+        });
+        return v[v.size() / 2];
+    }
+
+    void report(const char *name, const char *phase, const Sample &s)
+    {
+        std::printf("%-16s %-7s %12.1f %9llu %11llu %12llu %9llu %10llu %7llu\n",
+                    name, phase, s.seconds * 1e6,
+                    static_cast<unsigned long long>(s.allocs),
+                    static_cast<unsigned long long>(s.alloc_bytes),
+                    static_cast<unsigned long long>(s.bytes_read),
+                    static_cast<unsigned long long>(s.read_calls),
+                    static_cast<unsigned long long>(s.bytes_written),
+                    static_cast<unsigned long long>(s.write_calls));
+    }
+
+    void run_case(const Case &c, unsigned iterations)
+    {
+        abort_callback_dummy abort;
+        std::vector<Sample> open, first_read, retag;
+        std::vector<uint8_t> buffer;
+        CAFFile::tags_t tags;
+        tags.add("title", "microbench");
+        tags.add("artist", "synthetic");
+
+        auto image = build_image(c);
+        for (unsigned i = 0; i < iterations; ++i) {
+            /* retag modifies the image, so every iteration gets a copy */
+            auto file = std::make_shared<SparseByteSource>(*image);
+            file->seek(0, abort);
+            std::shared_ptr<CAFFile> demuxer;
+            {
+                Probe probe(file.get());
+                demuxer = std::make_shared<CAFFile>(file, abort);
+                open.push_back(probe.stop());
+            }
+            {
+                Probe probe(file.get());
+                demuxer->read_packets(0, 1, &buffer, abort);
+                first_read.push_back(probe.stop());
+            }
+            {
+                Probe probe(file.get());
+                demuxer->set_tags(tags, abort);
+                retag.push_back(probe.stop());
+            }
+        }
+        report(c.name, "open",  median(open));
+        report(c.name, "read",  median(first_read));
+        report(c.name, "retag", median(retag));
+    }
+
+    bool retag_check()
+    {
+        const unsigned EDITS = 100;
+        abort_callback_dummy abort;
+        auto file = build_image(cases[0]);
+        file->seek(0, abort);
+        CAFFile demuxer(file, abort);
+        CAFFile::tags_t tags;
+        std::string comment;
+        t_filesize size = file->get_size(abort);
+        unsigned relocations = 0, failures = 0;
+        uint64_t max_writes = 0;
+        for (unsigned i = 0; i < EDITS; ++i) {
+            comment.append(30, 'a' + i % 26);
+            tags.clear();
+            tags.add("title", "retag check");
+            tags.add("comment", comment.c_str());
+            file->reset_counters();
+            demuxer.set_tags(tags, abort);
+            max_writes = std::max(max_writes, file->write_calls);
+            if (file->write_calls != 1) {
+                std::printf("edit %u: %llu writes\n", i,
+                            static_cast<unsigned long long>(
+                                file->write_calls));
+                ++failures;
+            }
+            if (file->get_size(abort) != size) {
+                size = file->get_size(abort);
+                if (++relocations > 1) {
+                    std::printf("edit %u: info relocated\n", i);
+                    ++failures;
+                }
+            }
+            file->seek(0, abort);
+            CAFFile reread(file, abort);
+            if (reread.tags() != tags) {
+                std::printf("edit %u: tags read back differ\n", i);
+                ++failures;
+            }
+        }
+        std::printf("%u edits, max %llu write(s) per edit, "
+                    "%u relocation(s): %s\n",
+                    EDITS, static_cast<unsigned long long>(max_writes),
+                    relocations, failures ? "FAILED" : "ok");
+        return failures == 0;
+    }
+
+    void usage()
+    {
+        std::fprintf(stderr,
+                     "usage: caf-microbench [-n iterations] [--full] "
+                     "[filter]\n"
+                     "       caf-microbench --retag-check\n");
+        std::exit(1);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    unsigned iterations = 5;
+    bool full = false, retag = false;
+    const char *filter = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "-n") && i + 1 < argc)
+            iterations = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--full"))
+            full = true;
+        else if (!std::strcmp(argv[i], "--retag-check"))
+            retag = true;
+        else if (argv[i][0] != '-' && !filter)
+            filter = argv[i];
+        else
+            usage();
+    }
+    if (iterations < 1)
+        usage();
+    if (retag) {
+        try {
+            return retag_check() ? 0 : 2;
+        } catch (std::exception &e) {
+            std::printf("retag check failed: %s\n", e.what());
+            return 2;
+        }
+    }
+
+    /* the parser reports trailing junk on the console; keep it quiet */
+    std::stringstream discard;
+    std::streambuf *cerr_buf = std::cerr.rdbuf(discard.rdbuf());
+
+    std::printf("%-16s %-7s %12s %9s %11s %12s %9s %10s %7s\n",
+                "case", "phase", "usec", "allocs", "alloc bytes",
+                "bytes read", "reads", "written", "writes");
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+        const Case &c = cases[i];
+        if (c.large && !full)
+            continue;
+        if (filter && !std::strstr(c.name, filter))
+            continue;
+        try {
+            run_case(c, iterations);
+        } catch (std::exception &e) {
+            std::printf("%-16s failed: %s\n", c.name, e.what());
+        }
+        discard.str("");
+    }
+    std::cerr.rdbuf(cerr_buf);
+    return 0;
+}
@@ -0,0 +1,221 @@
+/*
+ * caf-overview: print a waveform overview of a CAF file from its ovvw
+ * chunk.
+ *
+ *   caf-overview [--generate [-f frames]] [-w width] file.caf
+ *   caf-overview --sampled [-w width] [-s samples] [-f frames]
+ *                [--budget ms] [--compare] file.caf
+ *
+ * With --generate, the file is decoded once and the overview (frames per
+ * point, 4096 by default) is stored in it first. Each output line is one
+ * of width columns, with min and max of every channel as 16 bit values.
+ *
+ * --sampled prints an approximate overview (SampledOverview) instead,
+ * width buckets with min, max and RMS of every channel, from up to
+ * samples stretches of frames frames per bucket, decoded within the time
+ * budget. --compare also decodes the whole file, and reports how long
+ * that took and how close the approximation came: the share of each
+ * bucket's true peak it found and its RMS error, both as medians.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include "CAFFile.h"
+#include "FrameReader.h"
+#include "Overview.h"
+
+namespace {
+    typedef std::chrono::steady_clock clock_type;
+
+    double seconds_since(clock_type::time_point start)
+    {
+        return std::chrono::duration<double>(clock_type::now() - start)
+                .count();
+    }
+
+    double median(std::vector<double> v)
+    {
+        if (v.empty())
+            return 0;
+        std::nth_element(v.begin(), v.begin() + v.size() / 2, v.end());
+        return v[v.size() / 2];
+    }
+
+    /* the same figures as SampledOverview, from every frame */
+    void full_scan(const std::shared_ptr<CAFFile> &demuxer, uint32_t buckets,
+                   std::vector<double> *peak, std::vector<double> *rms)
+    {
+        abort_callback_dummy abort;
+        FrameReader reader(demuxer, abort);
+        unsigned nchannels = reader.channels();
+        int64_t  length    = reader.length();
+        std::vector<audio_sample> buffer(65536 * nchannels);
+        void *planes[] = { buffer.data() };
+        IDecoder::Output out;
+        out.data = planes;
+        peak->assign(buckets * nchannels, 0);
+        rms->assign(buckets * nchannels, 0);
+        std::vector<uint64_t> frames(buckets);
+        size_t n;
+        for (int64_t pos = 0;
+             (n = reader.read(pos, 65536, out, abort)) > 0; pos += n) {
+            for (size_t i = 0; i < n; ++i) {
+                uint32_t b = (pos + i) * buckets / length;
+                const audio_sample *p = &buffer[i * nchannels];
+                for (unsigned ch = 0; ch < nchannels; ++ch) {
+                    double &pk = (*peak)[b * nchannels + ch];
+                    pk = std::max<double>(pk, std::fabs(p[ch]));
+                    (*rms)[b * nchannels + ch] += double(p[ch]) * p[ch];
+                }
+                ++frames[b];
+            }
+        }
+        for (size_t k = 0; k < rms->size(); ++k)
+            if (frames[k / nchannels])
+                (*rms)[k] = std::sqrt((*rms)[k] / frames[k / nchannels]);
+    }
+
+    int print_sampled(const char *path, unsigned width,
+                      const SampledOverview::Options &options, bool compare)
+    {
+        abort_callback_dummy abort;
+        auto demuxer = std::make_shared<CAFFile>(
+            std::make_shared<FileByteSource>(path), abort);
+        auto start = clock_type::now();
+        SampledOverview ov;
+        SampledOverview::scan(demuxer, options, &ov, abort);
+        double elapsed = seconds_since(start);
+
+        unsigned nchannels = ov.channels;
+        uint32_t sampled = 0;
+        for (unsigned col = 0; col < width; ++col) {
+            std::printf("%4u", col);
+            for (unsigned ch = 0; ch < nchannels; ++ch) {
+                size_t k = col * nchannels + ch;
+                std::printf(" %6.0f %6.0f %6.0f", ov.min[k] * 32768.0,
+                            ov.max[k] * 32768.0, ov.rms[k] * 32768.0);
+            }
+            std::printf("%s\n", ov.samples[col] ? "" : " *");
+            sampled += ov.samples[col] > 0;
+        }
+        int64_t length = demuxer->duration();
+        std::fprintf(stderr, "sampled: %.3f ms, %u of %u buckets, "
+                             "%.2f%% of frames decoded\n",
+                     elapsed * 1e3, sampled, width,
+                     100.0 * ov.frames_decoded / std::max<int64_t>(length, 1));
+        if (!compare)
+            return 0;
+
+        start = clock_type::now();
+        std::vector<double> peak, rms;
+        full_scan(demuxer, width, &peak, &rms);
+        double full = seconds_since(start);
+        std::vector<double> coverage, rms_error;
+        for (size_t k = 0; k < peak.size(); ++k) {
+            double p = std::max(std::fabs(ov.min[k]), std::fabs(ov.max[k]));
+            if (peak[k] > 0)
+                coverage.push_back(p / peak[k]);
+            if (rms[k] > 0)
+                rms_error.push_back(std::fabs(ov.rms[k] - rms[k]) / rms[k]);
+        }
+        std::fprintf(stderr, "full:    %.3f ms (%.1fx the sampled scan)\n"
+                             "peak found: %.1f%%, RMS error: %.1f%% "
+                             "(medians)\n",
+                     full * 1e3, full / elapsed,
+                     100 * median(coverage), 100 * median(rms_error));
+        return 0;
+    }
+
+    void usage()
+    {
+        std::fprintf(stderr, "usage: caf-overview [--generate [-f frames]] "
+                             "[-w width] FILE\n"
+                             "       caf-overview --sampled [-w width] "
+                             "[-s samples] [-f frames] [--budget ms] "
+                             "[--compare] FILE\n");
+        std::exit(1);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    bool generate = false, sampled = false, compare = false;
+    uint32_t frames_per_point = OverviewBuilder::DEFAULT_FRAMES_PER_POINT;
+    unsigned width = 80;
+    SampledOverview::Options options;
+    int i;
+    for (i = 1; i < argc && argv[i][0] == '-'; ++i) {
+        if (!std::strcmp(argv[i], "--generate"))
+            generate = true;
+        else if (!std::strcmp(argv[i], "--sampled"))
+            sampled = true;
+        else if (!std::strcmp(argv[i], "--compare"))
+            compare = true;
+        else if (!std::strcmp(argv[i], "-f") && i + 1 < argc)
+            frames_per_point = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "-s") && i + 1 < argc)
+            options.samples_per_bucket = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--budget") && i + 1 < argc)
+            options.time_budget = std::atof(argv[++i]) / 1e3;
+        else if (!std::strcmp(argv[i], "-w") && i + 1 < argc)
+            width = std::atoi(argv[++i]);
+        else
+            usage();
+    }
+    if (i + 1 != argc || !frames_per_point || !width
+     || !options.samples_per_bucket || (generate && sampled))
+        usage();
+    const char *path = argv[i];
+    if (sampled) {
+        options.buckets           = width;
+        options.frames_per_sample = frames_per_point;
+        try {
+            return print_sampled(path, width, options, compare);
+        } catch (std::exception &e) {
+            std::fprintf(stderr, "%s: %s\n", path, e.what());
+            return 2;
+        }
+    }
+    try {
+        abort_callback_dummy abort;
+        auto start = clock_type::now();
+        auto demuxer = std::make_shared<CAFFile>(
+            std::make_shared<FileByteSource>(path, generate ? "r+b" : "rb"),
+            abort);
+        if (generate) {
+            CAFFile::Overview overview;
+            OverviewBuilder::generate(demuxer, frames_per_point, &overview,
+                                      abort);
+            demuxer->set_overview(overview, abort);
+        } else if (!demuxer->has_overview()) {
+            std::fprintf(stderr, "%s: no overview, or out of date "
+                                 "(use --generate)\n", path);
+            return 2;
+        }
+        unsigned channels = demuxer->primary_format().asbd.mChannelsPerFrame;
+        int64_t duration = demuxer->duration();
+        for (unsigned col = 0; col < width; ++col) {
+            int64_t first = duration * col / width;
+            int64_t last  = duration * (col + 1) / width;
+            std::printf("%4u", col);
+            for (unsigned ch = 0; ch < channels; ++ch) {
+                int16_t lo, hi;
+                if (demuxer->overview_range(ch, first, last - first,
+                                            &lo, &hi))
+                    std::printf(" %6d %6d", lo, hi);
+                else
+                    std::printf(" %6s %6s", "-", "-");
+            }
+            std::printf("\n");
+        }
+        std::fprintf(stderr, "%.3f ms\n", seconds_since(start) * 1e3);
+    } catch (std::exception &e) {
+        std::fprintf(stderr, "%s: %s\n", path, e.what());
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,83 @@
+/*
+ * caf-remux: copy the packets of a CAF file into another container.
+ *
+ *   caf-remux [-f adts|flac|mp4] in.caf out
+ *
+ * AAC goes to ADTS or fragmented MP4, ALAC to fragmented MP4, FLAC to a
+ * native FLAC stream or fragmented MP4. Nothing is decoded. Without -f,
+ * the container follows the extension of out (.aac, .flac, .m4a/.mp4).
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include "CAFFile.h"
+#include "Remuxer.h"
+
+namespace {
+    bool parse_container(const std::string &name, Remuxer::Container *c)
+    {
+        if (name == "adts" || name == "aac")
+            *c = Remuxer::ADTS;
+        else if (name == "flac")
+            *c = Remuxer::FLAC;
+        else if (name == "mp4" || name == "m4a")
+            *c = Remuxer::MP4;
+        else
+            return false;
+        return true;
+    }
+
+    void usage()
+    {
+        std::fprintf(stderr,
+                     "usage: caf-remux [-f adts|flac|mp4] IN.caf OUT\n");
+        std::exit(1);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const char *format = 0;
+    int i;
+    for (i = 1; i < argc && argv[i][0] == '-'; ++i) {
+        if (!std::strcmp(argv[i], "-f") && i + 1 < argc)
+            format = argv[++i];
+        else
+            usage();
+    }
+    if (argc - i != 2)
+        usage();
+    const char *src = argv[i], *dst = argv[i + 1];
+
+    Remuxer::Container container;
+    std::string name = format ? format : "";
+    if (!format) {
+        const char *ext = std::strrchr(dst, '.');
+        name = ext ? ext + 1 : "";
+    }
+    if (!parse_container(name, &container)) {
+        std::fprintf(stderr, "%s: unknown container\n", name.c_str());
+        return 1;
+    }
+    try {
+        abort_callback_dummy abort;
+        auto demuxer = std::make_shared<CAFFile>(
+                std::make_shared<FileByteSource>(src), abort);
+        if (!Remuxer::can_remux(demuxer->format(), container))
+            throw std::runtime_error("the codec cannot be stored in "
+                                     + name);
+        try {
+            FileByteSource out(dst, "wb");
+            Remuxer::remux(demuxer, container, &out, abort);
+        } catch (...) {
+            std::remove(dst);
+            throw;
+        }
+    } catch (std::exception &e) {
+        std::fprintf(stderr, "%s: %s\n", src, e.what());
+        return 2;
+    }
+    return 0;
+}
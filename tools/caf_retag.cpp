@@ -0,0 +1,110 @@
+/*
+ * caf-retag: list or replace the tags of a CAF file.
+ *
+ *   caf-retag [--relocate] [--peak] file.caf [key=value...]
+ *
+ * Without key=value pairs the current tags are printed. Otherwise they
+ * replace all tags in the file. With --relocate, when the new tags do not
+ * fit ahead of the audio data, the file is rewritten into a temporary
+ * file next to it with all metadata first, which is then renamed into
+ * place. --relocate without tags relocates the current ones.
+ * --peak stores a peak chunk, scanning the audio unless the file already
+ * has an up to date one, and prints the peak of every channel.
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include "CAFFile.h"
+#include "PeakScanner.h"
+
+namespace {
+    void relocate(const char *path, const CAFFile::tags_t &tags,
+                  CAFFile *demuxer)
+    {
+        abort_callback_dummy abort;
+        std::string tmp = std::string(path) + ".retag.tmp";
+        try {
+            {
+                FileByteSource dst(tmp.c_str(), "wb");
+                demuxer->rewrite(&dst, tags, abort);
+                dst.sync();
+            }
+            if (std::rename(tmp.c_str(), path))
+                throw std::runtime_error("cannot rename " + tmp);
+        } catch (...) {
+            std::remove(tmp.c_str());
+            throw;
+        }
+    }
+
+    void usage()
+    {
+        std::fprintf(stderr,
+                     "usage: caf-retag [--relocate] [--peak] FILE "
+                     "[key=value...]\n");
+        std::exit(1);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    bool relocate_tags = false, store_peaks = false;
+    int i;
+    for (i = 1; i < argc && argv[i][0] == '-'; ++i) {
+        if (!std::strcmp(argv[i], "--relocate"))
+            relocate_tags = true;
+        else if (!std::strcmp(argv[i], "--peak"))
+            store_peaks = true;
+        else
+            usage();
+    }
+    if (i == argc)
+        usage();
+    const char *path = argv[i++];
+    try {
+        abort_callback_dummy abort;
+        bool write = relocate_tags || i < argc;
+        auto demuxer = std::make_shared<CAFFile>(
+            std::make_shared<FileByteSource>(path, write || store_peaks
+                                                   ? "r+b" : "rb"),
+            abort);
+        CAFFile::tags_t tags = demuxer->tags();
+        if (store_peaks) {
+            if (!demuxer->has_peaks()) {
+                std::vector<CAFFile::Peak> peaks;
+                PeakScanner::scan(demuxer, &peaks, abort);
+                demuxer->set_peaks(peaks, abort);
+            }
+            for (size_t n = 0; n < demuxer->peaks().size(); ++n)
+                std::printf("peak %u: %.6f at frame %llu\n",
+                            static_cast<unsigned>(n + 1),
+                            demuxer->peaks()[n].value,
+                            static_cast<unsigned long long>(
+                                demuxer->peaks()[n].frame));
+        }
+        if (!write) {
+            if (!store_peaks)
+                for (size_t n = 0; n < tags.size(); ++n)
+                    std::printf("%s=%s\n", tags.key(n), tags.value(n));
+            return 0;
+        }
+        if (i < argc)
+            tags.clear();
+        for (; i < argc; ++i) {
+            const char *eq = std::strchr(argv[i], '=');
+            if (!eq || eq == argv[i])
+                usage();
+            tags.add(argv[i], eq - argv[i], eq + 1, std::strlen(eq + 1));
+        }
+        if (relocate_tags && !demuxer->tags_fit_before_data(tags, abort))
+            relocate(path, tags, demuxer.get());
+        else
+            demuxer->set_tags(tags, abort);
+    } catch (std::exception &e) {
+        std::fprintf(stderr, "%s: %s\n", path, e.what());
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,207 @@
+/*
+ * caf-verify: integrity check of CAF files.
+ *
+ *   caf-verify [-j threads] [--store] file.caf...
+ *   caf-verify --self-test
+ *
+ * Checks the packet table against the data chunk, decodes everything and
+ * prints XXH64 hashes of the audio data and of the decoded PCM, with the
+ * throughput in MB of audio data per second. A PCM hash stored in the
+ * file is compared (status OK; ok when there is none to compare);
+ * --store writes it into files that verify and have none yet.
+ * Exits with 1 when any file fails.
+ *
+ * --self-test verifies the ALAC files in alac_reference.h against the
+ * PCM hashes of FFmpeg's decode of them, then decodes copies with bytes
+ * of the audio data overwritten at random, which must either decode or
+ * be rejected with an error, and a few malformed packets, which must be
+ * rejected.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include "CAFFile.h"
+#include "Decoder.h"
+#include "Verifier.h"
+#include "alac_reference.h"
+
+namespace {
+    typedef std::chrono::steady_clock clock_type;
+
+    double seconds_since(clock_type::time_point start)
+    {
+        return std::chrono::duration<double>(clock_type::now() - start)
+                .count();
+    }
+
+    void usage()
+    {
+        std::fprintf(stderr, "usage: caf-verify [-j threads] [--store] "
+                             "FILE...\n"
+                             "       caf-verify --self-test\n");
+        std::exit(1);
+    }
+
+    /* byte range of the data chunk's audio data in a CAF image */
+    void find_audio_data(const std::vector<uint8_t> &image, size_t *begin,
+                         size_t *end)
+    {
+        *begin = *end = 0;
+        for (size_t pos = 8; pos + 12 <= image.size(); ) {
+            uint64_t size = 0;
+            for (int i = 4; i < 12; ++i)
+                size = size << 8 | image[pos + i];
+            if (!std::memcmp(&image[pos], "data", 4)) {
+                *begin = pos + 12 + 4;              /* edit count */
+                *end   = std::min<uint64_t>(pos + 12 + size, image.size());
+                return;
+            }
+            pos += 12 + size;
+        }
+    }
+
+    /* ALAC packets that claim more bits than they have */
+    struct BadPacket {
+        uint8_t data[8];
+        size_t  size;
+    };
+    const BadPacket BAD_PACKETS[] = {
+        /* CPE with the escape flag: verbatim samples */
+        { { 0x20, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00 }, 8 },
+        /* CPE with 31 coefficients in the first predictor */
+        { { 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3f, 0x00 }, 8 },
+        /* CPE with the partial frame flag, cut off before the size */
+        { { 0x20, 0x00, 0x01 }, 3 },
+    };
+
+    int self_test(unsigned nthreads)
+    {
+        enum { CORRUPTIONS = 500 };
+        abort_callback_dummy abort;
+        std::mt19937 rng(12345);
+        int status = 0;
+        for (size_t k = 0; k < sizeof AlacReference::files
+                               / sizeof AlacReference::files[0]; ++k) {
+            const AlacReference::File &ref = AlacReference::files[k];
+            std::vector<uint8_t> image(ref.data, ref.data + ref.size);
+
+            auto demuxer = std::make_shared<CAFFile>(
+                std::make_shared<MemoryByteSource>(image), abort);
+            Verifier::Result result;
+            Verifier::run(demuxer, nthreads, &result, abort);
+            bool exact = result.ok() && result.pcm_hash == ref.pcm_hash;
+            std::printf("%-8s %s (%016llx, %016llx expected)\n", ref.name,
+                        exact ? "ok" : "FAIL",
+                        static_cast<unsigned long long>(result.pcm_hash),
+                        static_cast<unsigned long long>(ref.pcm_hash));
+            if (!exact)
+                status = 1;
+
+            size_t begin, end;
+            find_audio_data(image, &begin, &end);
+            unsigned rejected = 0;
+            for (int n = 0; n < CORRUPTIONS && begin < end; ++n) {
+                std::vector<uint8_t> bad = image;
+                for (int i = 1 + rng() % 8; i > 0; --i)
+                    bad[begin + rng() % (end - begin)] = rng();
+                try {
+                    auto demuxer = std::make_shared<CAFFile>(
+                        std::make_shared<MemoryByteSource>(bad), abort);
+                    IDecoder::decode_all(demuxer, abort,
+                                         [](const audio_chunk &) {});
+                } catch (std::runtime_error &) {
+                    ++rejected;
+                }
+            }
+            std::printf("%-8s %u corrupted copies, %u rejected\n", ref.name,
+                        static_cast<unsigned>(CORRUPTIONS), rejected);
+
+            auto decoder = IDecoder::create_decoder(demuxer, abort);
+            audio_chunk_impl chunk;
+            size_t npackets = sizeof BAD_PACKETS / sizeof BAD_PACKETS[0];
+            rejected = 0;
+            for (size_t n = 0; n < npackets; ++n) {
+                try {
+                    decoder->decode(BAD_PACKETS[n].data, BAD_PACKETS[n].size,
+                                    chunk, abort);
+                } catch (std::runtime_error &) {
+                    ++rejected;
+                }
+            }
+            std::printf("%-8s %u of %u malformed packets rejected\n",
+                        ref.name, rejected, static_cast<unsigned>(npackets));
+            if (rejected != npackets)
+                status = 1;
+        }
+        return status;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    unsigned nthreads = std::max(std::thread::hardware_concurrency(), 1u);
+    bool store = false, check = false;
+    int i;
+    for (i = 1; i < argc && argv[i][0] == '-'; ++i) {
+        if (!std::strcmp(argv[i], "-j") && i + 1 < argc)
+            nthreads = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--store"))
+            store = true;
+        else if (!std::strcmp(argv[i], "--self-test"))
+            check = true;
+        else
+            usage();
+    }
+    if (nthreads < 1 || (i == argc) != check)
+        usage();
+    if (check)
+        return self_test(nthreads);
+
+    std::printf("%-32s %-6s %-16s %-16s %9s\n",
+                "file", "status", "data xxh64", "pcm xxh64", "MB/s");
+    int status = 0;
+    for (; i < argc; ++i) {
+        try {
+            abort_callback_dummy abort;
+            auto demuxer = std::make_shared<CAFFile>(
+                std::make_shared<FileByteSource>(argv[i],
+                                                 store ? "r+b" : "rb"),
+                abort);
+            Verifier::Result result;
+            auto start = clock_type::now();
+            Verifier::run(demuxer, nthreads, &result, abort);
+            double elapsed = seconds_since(start);
+
+            const char *verdict = "FAIL";
+            if (result.ok())
+                verdict = result.has_stored_hash ? "OK" : "ok";
+            std::string name = argv[i];
+            if (name.size() > 32)
+                name = "..." + name.substr(name.size() - 29);
+            std::printf("%-32s %-6s %016llx %016llx %9.1f\n",
+                        name.c_str(), verdict,
+                        static_cast<unsigned long long>(result.data_hash),
+                        static_cast<unsigned long long>(result.pcm_hash),
+                        result.data_bytes / elapsed / 1e6);
+            for (size_t k = 0; k < result.problems.size(); ++k)
+                std::printf("    %s\n", result.problems[k].c_str());
+            if (!result.ok()) {
+                status = std::max(status, 1);
+            } else if (store && !result.has_stored_hash) {
+                CAFFile::tags_t tags = demuxer->tags();
+                Verifier::put_tags(result, &tags);
+                demuxer->set_tags(tags, abort);
+            }
+        } catch (std::exception &e) {
+            std::fprintf(stderr, "%s: %s\n", argv[i], e.what());
+            status = 2;
+        }
+    }
+    return status;
+}